@@ -0,0 +1,741 @@
+#ifndef _ANYTIME_SOLVER_H_
+#define _ANYTIME_SOLVER_H_
+
+#include "BoardState.h"
+#include "MoveGenerator.h"
+#include "SliderSolver.h"
+#include "Zobrist.h"
+
+#include <tsl/robin_map.h>
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <functional>
+#include <limits>
+#include <map>
+#include <queue>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace tilepuzzles {
+
+struct AnytimeProgress {
+  // since solve() started
+  double seconds = 0.;
+  size_t length = 0;
+  int round = 0;
+};
+
+using AnytimeProgressFn = std::function<void(const AnytimeProgress&)>;
+using AnytimeSolutionFn = std::function<void(const std::vector<Move>&)>;
+
+/*
+ * Anytime solver for sliders and rollers too large for optimal search.
+ *
+ * A solve is a sequence of stages, each bringing a few more tiles to a
+ * target slot while keeping the earlier ones. Sliders go row by row and
+ * then column by column over the last two rows, placing the final two tiles
+ * of a line with the usual park-and-rotate detour. Rollers go tile by tile
+ * up to a last line, rolling later lines and dropping a tile in with
+ * conjugates that restore the placed tiles, then finish the last line with
+ * its own rolls and 8 move 3-cycles found as products of two commutators of
+ * single rolls. The last line is a row unless only a column roll flips
+ * parity. A stage searches a compact state holding only the slots of its
+ * tiles (and the blank), so moves of the other tiles do not multiply the
+ * states it sees.
+ *
+ * Round 0 runs every stage as weighted A* with weight and returns the first
+ * solution. Until the deadline, later rounds alternate beam search with
+ * width beamWidth doubling each time and weighted A* with the weight halved
+ * towards 1, keeping the shortest result. A failed round, round 0 included,
+ * gives the next one a larger stage node limit. Every solution goes through
+ * shorten(), which cuts revisited positions and replaces detours with a
+ * single move wherever a move reaches a later position of the path.
+ * progress records the length after every improvement.
+ */
+struct AnytimeSolver {
+  static constexpr size_t DEFAULT_STAGE_NODES = 1 << 20;
+  // every failed round doubles the stage node limit of the next, up to this many times
+  static constexpr int MAX_RETRY_SHIFT = 2;
+  // a slider tile moves one slot per trip of the blank around it, about five slides
+  static constexpr int SLIDE_STEP_COST = 4;
+
+  AnytimeSolver(int rows, int columns, PuzzleType type) : rows(rows), columns(columns), type(type) {
+    if (type == PuzzleType::RollerPuzzle) {
+      initActions();
+    }
+    initStages();
+  }
+
+  SolveResult solve(const BoardState& start, double budgetSeconds, const std::atomic<bool>* cancel = nullptr) {
+    startTime = std::chrono::steady_clock::now();
+    deadline = startTime + std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+                               std::chrono::duration<double>(budgetSeconds));
+    stop = cancel;
+    progress.clear();
+    SolveResult best;
+    nodes = 0;
+    int failures = 0;
+    for (int round = 0; !expired(); ++round) {
+      std::vector<Move> moves;
+      Strategy strategy;
+      strategy.beam = round % 2 == 1;
+      strategy.width = beamWidth << (round / 2);
+      strategy.weight = 1. + (weight - 1.) / (1 << ((round + 1) / 2));
+      strategy.nodeLimit = stageNodeLimit << std::min(failures, MAX_RETRY_SHIFT);
+      // a stage beam narrower than the maneuver it needs fails, and a stage out of nodes; later rounds may not
+      if (!solveStages(start, strategy, moves)) {
+        ++failures;
+      } else {
+        shorten(start, moves);
+        if (!best.solved || moves.size() < best.moves.size()) {
+          best.solved = true;
+          best.moves = moves;
+          report(round, moves.size());
+          if (onSolution) {
+            onSolution(moves);
+          }
+        }
+      }
+      // the weight reached 1 and beams this wide stop paying off
+      if (strategy.width > (1 << 16)) {
+        break;
+      }
+    }
+    best.nodes = nodes;
+    best.seconds = elapsed();
+    return best;
+  }
+
+  /*
+   * Removes the moves between two visits of the same position and, where
+   * one move from a position reaches a later position of the path, the
+   * moves in between. Repeats until the path stops shrinking.
+   */
+  static void shorten(const BoardState& start, std::vector<Move>& moves) {
+    std::array<Move, 256> neighbors;
+    for (size_t before = moves.size() + 1; moves.size() < before;) {
+      before = moves.size();
+      std::unordered_map<uint64_t, size_t> last;
+      BoardState state = start;
+      last[state.hash] = 0;
+      for (size_t i = 0; i < moves.size(); ++i) {
+        MoveGenerator::apply(state, moves[i]);
+        last[state.hash] = i + 1;
+      }
+      std::vector<Move> shorter;
+      state = start;
+      for (size_t i = 0; i < moves.size();) {
+        size_t target = last[state.hash];
+        bool jump = false;
+        Move shortcut = 0;
+        const int count = MoveGenerator::generate(state, neighbors.data());
+        for (int k = 0; k < count; ++k) {
+          MoveGenerator::apply(state, neighbors[k]);
+          const auto iter = last.find(state.hash);
+          if (iter != last.end() && iter->second > std::max(target, i + 1)) {
+            target = iter->second;
+            jump = true;
+            shortcut = neighbors[k];
+          }
+          MoveGenerator::unapply(state, neighbors[k]);
+        }
+        if (target <= i) {
+          shorter.push_back(moves[i]);
+          MoveGenerator::apply(state, moves[i]);
+          ++i;
+          continue;
+        }
+        // without a shortcut the position at target is a revisit of this one
+        if (jump) {
+          shorter.push_back(shortcut);
+          MoveGenerator::apply(state, shortcut);
+        }
+        i = target;
+      }
+      if (!replaysToSolved(start, shorter)) {
+        return;
+      }
+      moves.swap(shorter);
+    }
+  }
+
+  int rows;
+  int columns;
+  PuzzleType type;
+  double weight = 5.;
+  int beamWidth = 64;
+  size_t stageNodeLimit = DEFAULT_STAGE_NODES;
+  std::vector<AnytimeProgress> progress;
+  AnytimeProgressFn onProgress;
+  // called with every improved solution, before solve() returns
+  AnytimeSolutionFn onSolution;
+
+private:
+  struct Placement {
+    uint16_t tile;
+    uint16_t slot;
+  };
+
+  /*
+   * placements are added to the kept ones for this stage only; a stage with
+   * keep set adds them to the kept placements once done. The stages before
+   * a keep stage are skipped when its placements already hold. Roller
+   * stages move tiles without disturbing the kept ones outside the last
+   * line, so they search only their own tile and the kept last line tiles:
+   * macros stages roll the last line and use its 3-cycles, insert stages use
+   * lineSteps.
+   */
+  struct Stage {
+    std::vector<Placement> placements;
+    bool keep = false;
+    bool macros = false;
+    bool insert = false;
+  };
+
+  // roller moves and macros as a word and the slot each slot's tile moves to
+  struct Action {
+    std::vector<Move> moves;
+    std::vector<uint16_t> target;
+  };
+
+  // roll of line by steps between dropping the crossing line cross by depth and lifting it back
+  struct LineStep {
+    int16_t cross;
+    int16_t depth;
+    int16_t line;
+    int16_t steps;
+  };
+
+  struct Strategy {
+    bool beam = false;
+    int width = 0;
+    double weight = 1.;
+    size_t nodeLimit = DEFAULT_STAGE_NODES;
+  };
+
+  Action makeAction(const std::vector<Move>& moves) const {
+    BoardState state(type, rows, columns);
+    for (Move move : moves) {
+      MoveGenerator::apply(state, move);
+    }
+    Action action;
+    action.moves = moves;
+    action.target.resize(rows * columns);
+    for (int s = 0; s < rows * columns; ++s) {
+      action.target[state.slots[s]] = s;
+    }
+    return action;
+  }
+
+  // last line is a row unless columns are odd and rows even, where only column rolls are odd permutations
+  bool lastLineIsColumn() const {
+    return columns % 2 == 1 && rows % 2 == 0;
+  }
+
+  bool inLastLine(int slot) const {
+    return lastLineIsColumn() ? slot % columns == columns - 1 : slot / columns == rows - 1;
+  }
+
+  void initActions() {
+    const BoardState shape(type, rows, columns);
+    std::vector<Move> moves(MoveGenerator::maxMoves(shape));
+    moves.resize(MoveGenerator::generate(shape, moves.data()));
+    for (Move move : moves) {
+      actions.push_back(makeAction({move}));
+    }
+    // rolls of the last line go last, next to the macros
+    auto leavesLastLine = [&](const Action& action) {
+      for (int s = 0; s < rows * columns; ++s) {
+        if (action.target[s] != s && !inLastLine(s)) {
+          return true;
+        }
+      }
+      return false;
+    };
+    lastLineFirst = std::stable_partition(actions.begin(), actions.end(), leavesLastLine) - actions.begin();
+
+    // commutators touching the last line, then pairs of them moving nothing else
+    std::vector<Action> commutators;
+    for (Move x : moves) {
+      for (Move y : moves) {
+        Action action =
+            makeAction({x, y, MoveGenerator::inverse(x), MoveGenerator::inverse(y)});
+        for (int s = 0; s < rows * columns; ++s) {
+          if (action.target[s] != s && inLastLine(s)) {
+            commutators.push_back(std::move(action));
+            break;
+          }
+        }
+      }
+    }
+    std::map<std::vector<uint16_t>, size_t> effects;
+    for (const Action& first : commutators) {
+      for (const Action& second : commutators) {
+        std::vector<uint16_t> target(rows * columns);
+        bool moved = false;
+        bool inside = true;
+        for (int s = 0; s < rows * columns && inside; ++s) {
+          target[s] = second.target[first.target[s]];
+          moved |= target[s] != s;
+          inside = target[s] == s || inLastLine(s);
+        }
+        if (moved && inside && effects.emplace(target, actions.size()).second) {
+          Action macro;
+          macro.moves = first.moves;
+          macro.moves.insert(macro.moves.end(), second.moves.begin(), second.moves.end());
+          macro.target = std::move(target);
+          actions.push_back(std::move(macro));
+        }
+      }
+    }
+  }
+
+  // lines in the order roller stages fill them and the slots along each
+  int lineCount() const {
+    return lastLineIsColumn() ? columns : rows;
+  }
+
+  int lineLength() const {
+    return lastLineIsColumn() ? rows : columns;
+  }
+
+  int lineOf(int slot) const {
+    return lastLineIsColumn() ? slot % columns : slot / columns;
+  }
+
+  int positionInLine(int slot) const {
+    return lastLineIsColumn() ? slot / columns : slot % columns;
+  }
+
+  int slotAt(int line, int position) const {
+    return lastLineIsColumn() ? position * columns + line : line * columns + position;
+  }
+
+  // a roll of line or, when across is set, of the crossing line at index
+  Move lineRoll(int index, int steps, bool across) const {
+    if (lastLineIsColumn() == across) {
+      return MoveGenerator::roll(index, steps > 0 ? Direction::right : Direction::left);
+    }
+    return MoveGenerator::roll(index, steps > 0 ? Direction::down : Direction::up);
+  }
+
+  /*
+   * Steps that place a tile in line without moving the lines before it or
+   * the line's first tiles: rolls of the later lines, then for every
+   * crossing line x, from the last, the conjugates that drop x by depth,
+   * roll line + depth one slot and lift x back. One brings the tile next to
+   * x in line + depth to x in line. lineEnds[x] is the number of steps that
+   * leave the slots before x alone.
+   */
+  void initLineSteps(int line) {
+    lineSteps.clear();
+    lineEnds.assign(lineLength(), 0);
+    for (int later = line + 1; later < lineCount(); ++later) {
+      lineSteps.push_back({0, 0, int16_t(later), 1});
+      if (lineLength() > 2) {
+        lineSteps.push_back({0, 0, int16_t(later), -1});
+      }
+    }
+    for (int x = lineLength() - 1; x >= 0; --x) {
+      for (int depth = 1; line + depth < lineCount(); ++depth) {
+        lineSteps.push_back({int16_t(x), int16_t(depth), int16_t(line + depth), 1});
+        if (lineLength() > 2) {
+          lineSteps.push_back({int16_t(x), int16_t(depth), int16_t(line + depth), -1});
+        }
+      }
+      lineEnds[x] = lineSteps.size();
+    }
+    stepsLine = line;
+  }
+
+  // slot the tile in slot ends up in after step
+  int conjugated(int slot, const LineStep& step) const {
+    int line = lineOf(slot);
+    int position = positionInLine(slot);
+    if (step.depth && position == step.cross) {
+      line = (line + step.depth) % lineCount();
+    }
+    if (line == step.line) {
+      position = (position + step.steps + lineLength()) % lineLength();
+    }
+    if (step.depth && position == step.cross) {
+      line = (line - step.depth + lineCount()) % lineCount();
+    }
+    return slotAt(line, position);
+  }
+
+  std::vector<Move> movesOf(const LineStep& step) const {
+    std::vector<Move> moves(step.depth, lineRoll(step.cross, 1, true));
+    moves.push_back(lineRoll(step.line, step.steps, false));
+    moves.insert(moves.end(), step.depth, lineRoll(step.cross, -1, true));
+    return moves;
+  }
+
+  void initStages() {
+    auto single = [&](int tile, bool macros) {
+      stages.push_back({{{uint16_t(tile), uint16_t(tile)}}, true, macros, type == PuzzleType::RollerPuzzle && !macros});
+    };
+    // b parks on a's slot, a goes next to it on the side away from the solved area, then both rotate home
+    auto pair = [&](int a, int b, int beside) {
+      stages.push_back({{{uint16_t(b), uint16_t(a)}}, false});
+      stages.push_back({{{uint16_t(b), uint16_t(a)}, {uint16_t(a), uint16_t(beside)}}, false});
+      stages.push_back({{{uint16_t(a), uint16_t(a)}, {uint16_t(b), uint16_t(b)}}, true});
+    };
+    if (type == PuzzleType::RollerPuzzle) {
+      for (int line = 0; line < lineCount(); ++line) {
+        for (int i = 0; i < lineLength(); ++i) {
+          single(slotAt(line, i), line == lineCount() - 1);
+        }
+      }
+      return;
+    }
+    for (int r = 0; r + 2 < rows; ++r) {
+      for (int c = 0; c + 2 < columns; ++c) {
+        single(r * columns + c, false);
+      }
+      const int a = r * columns + columns - 2;
+      pair(a, a + 1, a + columns);
+    }
+    const int top = (rows - 2) * columns;
+    for (int c = 0; c + 2 < columns; ++c) {
+      pair(top + c, top + columns + c, top + c + 1);
+    }
+    Stage last;
+    for (int tile : {top + columns - 2, top + columns - 1, top + 2 * columns - 2}) {
+      last.placements.push_back({uint16_t(tile), uint16_t(tile)});
+    }
+    last.keep = true;
+    stages.push_back(last);
+  }
+
+  bool solveStages(const BoardState& start, const Strategy& strategy, std::vector<Move>& moves) {
+    BoardState state = start;
+    std::vector<Placement> kept;
+    for (int s = 0; s < stages.size(); ++s) {
+      const Stage& stage = stages[s];
+      int final = s;
+      while (!stages[final].keep) {
+        ++final;
+      }
+      if (final != s && holds(state, stages[final].placements)) {
+        continue;
+      }
+      // most stages expand too few nodes to reach the check in searchStage
+      if (expired()) {
+        return false;
+      }
+      std::vector<Placement> goal;
+      for (const Placement& p : kept) {
+        if (type == PuzzleType::SliderPuzzle || (stage.macros && inLastLine(p.slot))) {
+          goal.push_back(p);
+        }
+      }
+      goal.insert(goal.end(), stage.placements.begin(), stage.placements.end());
+      if (!searchStage(state, goal, stage, strategy, moves)) {
+        return false;
+      }
+      if (stage.keep) {
+        kept.insert(kept.end(), stage.placements.begin(), stage.placements.end());
+      }
+    }
+    return state.isSolved();
+  }
+
+  static bool holds(const BoardState& state, const std::vector<Placement>& placements) {
+    for (const Placement& p : placements) {
+      if (state.slots[p.slot] != p.tile) {
+        return false;
+      }
+    }
+    return true;
+  }
+
+  // search state: slot of every goal tile, then the blank for sliders
+  using Compact = std::vector<uint16_t>;
+
+  int distance(int from, int to) const {
+    int dr = std::abs(from / columns - to / columns);
+    int dc = std::abs(from % columns - to % columns);
+    if (type == PuzzleType::RollerPuzzle) {
+      dr = std::min(dr, rows - dr);
+      dc = std::min(dc, columns - dc);
+    }
+    return dr + dc;
+  }
+
+  /*
+   * A slider tile only moves once the blank reaches it, and each step costs
+   * the blank a trip around it. The blank heads for the stage's own tiles
+   * first: counting kept tiles it knocked out of place would reward pushing
+   * into the solved area.
+   */
+  int heuristic(const Compact& node, const std::vector<Placement>& goal) const {
+    int h = 0;
+    int blankDistance = std::numeric_limits<int>::max();
+    int keptDistance = std::numeric_limits<int>::max();
+    for (int i = 0; i < goal.size(); ++i) {
+      const int d = distance(node[i], goal[i].slot);
+      h += type == PuzzleType::SliderPuzzle ? d * SLIDE_STEP_COST : d;
+      if (d && type == PuzzleType::SliderPuzzle) {
+        int& nearest = i < stageFirst ? keptDistance : blankDistance;
+        nearest = std::min(nearest, distance(node[goal.size()], node[i]) - 1);
+      }
+    }
+    if (blankDistance == std::numeric_limits<int>::max()) {
+      blankDistance = keptDistance;
+    }
+    return h && type == PuzzleType::SliderPuzzle ? h + blankDistance : h;
+  }
+
+  uint64_t key(const Compact& node) const {
+    uint64_t k = 0;
+    for (int i = 0; i < node.size(); ++i) {
+      k ^= Zobrist::mix(i, node[i]);
+    }
+    return k;
+  }
+
+  // slider steps are single slides of the blank's neighbors, roller steps index actions or lineSteps
+  int expand(const Compact& node, const Stage& stage, uint32_t* steps) const {
+    if (type == PuzzleType::RollerPuzzle) {
+      const int first = stage.insert ? 0 : lastLineFirst;
+      const int end = stage.insert ? lineEnds[positionInLine(stage.placements[0].slot)] : actions.size();
+      for (int i = first; i < end; ++i) {
+        steps[i - first] = i;
+      }
+      return end - first;
+    }
+    const int blank = node.back();
+    const int r = blank / columns;
+    const int c = blank % columns;
+    int count = 0;
+    for (int slot : {r > 0 ? blank - columns : -1, r < rows - 1 ? blank + columns : -1, c > 0 ? blank - 1 : -1,
+                     c < columns - 1 ? blank + 1 : -1}) {
+      if (slot >= 0) {
+        steps[count++] = MoveGenerator::slide(slot, blank);
+      }
+    }
+    return count;
+  }
+
+  int cost(const Stage& stage, uint32_t step) const {
+    if (type == PuzzleType::SliderPuzzle) {
+      return 1;
+    }
+    return stage.insert ? 2 * lineSteps[step].depth + 1 : actions[step].moves.size();
+  }
+
+  // updates the key and, for rollers, the heuristic along with the tiles that move
+  void apply(Compact& node, const Stage& stage, uint32_t step, const std::vector<Placement>& goal, uint64_t& k,
+             int& h) const {
+    if (type == PuzzleType::RollerPuzzle) {
+      for (int i = 0; i < node.size(); ++i) {
+        const int slot = stage.insert ? conjugated(node[i], lineSteps[step]) : actions[step].target[node[i]];
+        if (slot != node[i]) {
+          k ^= Zobrist::mix(i, node[i]) ^ Zobrist::mix(i, slot);
+          h += distance(slot, goal[i].slot) - distance(node[i], goal[i].slot);
+          node[i] = slot;
+        }
+      }
+      return;
+    }
+    const int slot = MoveGenerator::index(step);
+    const int blank = MoveGenerator::arg(step);
+    for (int i = 0; i + 1 < node.size(); ++i) {
+      if (node[i] == slot) {
+        k ^= Zobrist::mix(i, slot) ^ Zobrist::mix(i, blank);
+        node[i] = blank;
+      }
+    }
+    k ^= Zobrist::mix(node.size() - 1, blank) ^ Zobrist::mix(node.size() - 1, slot);
+    node.back() = slot;
+    h = heuristic(node, goal);
+  }
+
+  /*
+   * Weighted A* or beam search from state to goal over compact states.
+   * Appends the moves to moves and applies them to state.
+   */
+  bool searchStage(BoardState& state, const std::vector<Placement>& goal, const Stage& stage,
+                   const Strategy& strategy, std::vector<Move>& moves) {
+    Compact root;
+    for (const Placement& p : goal) {
+      root.push_back(state.slotOf(p.tile));
+    }
+    if (type == PuzzleType::SliderPuzzle) {
+      root.push_back(state.blank);
+    }
+    stageFirst = goal.size() - stage.placements.size();
+    if (stage.insert && lineOf(stage.placements[0].slot) != stepsLine) {
+      initLineSteps(lineOf(stage.placements[0].slot));
+    }
+    const int rootHeuristic = heuristic(root, goal);
+    if (rootHeuristic == 0) {
+      return true;
+    }
+    const int width = root.size();
+    pool.assign(root.begin(), root.end());
+    parents.assign(1, -1);
+    pathSteps.assign(1, 0);
+    costs.assign(1, 0);
+    keys.assign(1, key(root));
+    heuristics.assign(1, rootHeuristic);
+    seen.clear();
+    seen[keys[0]] = 0;
+
+    std::vector<uint32_t> children(std::max({actions.size(), lineSteps.size(), size_t(4)}));
+    Compact node(width);
+    int found = -1;
+    size_t expanded = 0;
+    auto visit = [&](int parent, uint32_t step, int& child) {
+      std::copy(pool.begin() + parent * width, pool.begin() + (parent + 1) * width, node.begin());
+      uint64_t k = keys[parent];
+      int h = heuristics[parent];
+      apply(node, stage, step, goal, k, h);
+      if (!seen.emplace(k, parents.size()).second) {
+        return -1;
+      }
+      child = parents.size();
+      pool.insert(pool.end(), node.begin(), node.end());
+      parents.push_back(parent);
+      pathSteps.push_back(step);
+      costs.push_back(costs[parent] + cost(stage, step));
+      keys.push_back(k);
+      heuristics.push_back(h);
+      return h;
+    };
+
+    if (strategy.beam) {
+      std::vector<int> layer = {0};
+      std::vector<std::pair<int, int>> next;
+      while (!layer.empty() && found < 0 && expanded < strategy.nodeLimit) {
+        next.clear();
+        for (int parent : layer) {
+          if ((++expanded & 0xf) == 0 && expired()) {
+            return false;
+          }
+          std::copy(pool.begin() + parent * width, pool.begin() + (parent + 1) * width, node.begin());
+          const int count = expand(node, stage, children.data());
+          for (int k = 0; k < count && found < 0; ++k) {
+            int child;
+            const int h = visit(parent, children[k], child);
+            if (h == 0) {
+              found = child;
+            } else if (h > 0) {
+              next.push_back({h, child});
+            }
+          }
+        }
+        if (next.size() > strategy.width) {
+          std::nth_element(next.begin(), next.begin() + strategy.width, next.end());
+          next.resize(strategy.width);
+        }
+        layer.clear();
+        for (const auto& entry : next) {
+          layer.push_back(entry.second);
+        }
+      }
+    } else {
+      using Entry = std::pair<double, int>;
+      std::priority_queue<Entry, std::vector<Entry>, std::greater<Entry>> open;
+      open.push({strategy.weight * rootHeuristic, 0});
+      while (!open.empty() && found < 0 && expanded < strategy.nodeLimit) {
+        const int parent = open.top().second;
+        open.pop();
+        if ((++expanded & 0xf) == 0 && expired()) {
+          return false;
+        }
+        std::copy(pool.begin() + parent * width, pool.begin() + (parent + 1) * width, node.begin());
+        const int count = expand(node, stage, children.data());
+        for (int k = 0; k < count && found < 0; ++k) {
+          int child;
+          const int h = visit(parent, children[k], child);
+          if (h == 0) {
+            found = child;
+          } else if (h > 0) {
+            open.push({costs[child] + strategy.weight * h, child});
+          }
+        }
+      }
+    }
+    nodes += expanded;
+    if (found < 0) {
+      return false;
+    }
+    std::vector<uint32_t> path;
+    for (int n = found; parents[n] >= 0; n = parents[n]) {
+      path.push_back(pathSteps[n]);
+    }
+    for (auto step = path.rbegin(); step != path.rend(); ++step) {
+      if (type == PuzzleType::RollerPuzzle) {
+        for (Move move : stage.insert ? movesOf(lineSteps[*step]) : actions[*step].moves) {
+          moves.push_back(move);
+          MoveGenerator::apply(state, move);
+        }
+      } else {
+        moves.push_back(*step);
+        MoveGenerator::apply(state, *step);
+      }
+    }
+    return true;
+  }
+
+  static bool replaysToSolved(BoardState state, const std::vector<Move>& moves) {
+    for (Move move : moves) {
+      MoveGenerator::apply(state, move);
+    }
+    return state.isSolved();
+  }
+
+  bool expired() const {
+    return std::chrono::steady_clock::now() >= deadline || (stop && stop->load(std::memory_order_relaxed));
+  }
+
+  double elapsed() const {
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - startTime).count();
+  }
+
+  void report(int round, size_t length) {
+    AnytimeProgress status;
+    status.seconds = elapsed();
+    status.length = length;
+    status.round = round;
+    progress.push_back(status);
+    if (onProgress) {
+      onProgress(status);
+    }
+  }
+
+  std::vector<Stage> stages;
+  // roller single moves, the last line rolls among them from lastLineFirst, then the last line macros
+  std::vector<Action> actions;
+  int lastLineFirst = 0;
+  // insert stage steps of line stepsLine, built when a stage first needs them
+  std::vector<LineStep> lineSteps;
+  std::vector<int> lineEnds;
+  int stepsLine = -1;
+  std::chrono::steady_clock::time_point startTime;
+  std::chrono::steady_clock::time_point deadline;
+  const std::atomic<bool>* stop = nullptr;
+  uint64_t nodes = 0;
+
+  // search storage reused across stages
+  std::vector<uint16_t> pool;
+  std::vector<int> parents;
+  std::vector<uint32_t> pathSteps;
+  std::vector<int> costs;
+  std::vector<uint64_t> keys;
+  std::vector<int> heuristics;
+  // goal index of the current stage's first placement, the ones before are kept
+  int stageFirst = 0;
+  tsl::robin_map<uint64_t, int> seen;
+};
+
+} // namespace tilepuzzles
+#endif
@@ -0,0 +1,315 @@
+#ifndef _BATCH_SOLVER_H_
+#define _BATCH_SOLVER_H_
+
+#include "AnytimeSolver.h"
+#include "BoardState.h"
+#include "BoardSymmetry.h"
+#include "HexSolver.h"
+#include "HierarchicalSolver.h"
+#include "PerfectTables.h"
+#include "RollerBfsSolver.h"
+#include "SliderSolver.h"
+#include "Solvability.h"
+#include "SolutionOptimizer.h"
+
+#include <nlohmann/json.hpp>
+#include <tsl/robin_map.h>
+
+#include <algorithm>
+#include <condition_variable>
+#include <deque>
+#include <istream>
+#include <mutex>
+#include <ostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+using json = nlohmann::json;
+
+namespace tilepuzzles {
+
+struct BatchOptions {
+  int threads = std::max(1u, std::thread::hardware_concurrency());
+  // lines read but not yet written; bounds memory whatever the corpus size
+  size_t window = 0;
+  // sliders of up to this many slots are solved optimally
+  int optimalSlots = 16;
+  // rollers of up to this many slots go to RollerBfsSolver, holding at most bfsStates states per worker
+  int bfsSlots = 16;
+  size_t bfsStates = 4 << 20;
+  uint64_t nodeLimit = 50000000;
+  double budgetSeconds = 5.;
+  // sliders of at least this many slots go to HierarchicalSolver, AnytimeSolver seldom finishes them
+  int hierarchicalSlots = 400;
+  bool optimize = true;
+  // longer solutions skip SolutionOptimizer, whose passes grow faster than the solution
+  size_t optimizeMoves = 1 << 17;
+  // boards PerfectTables covers follow their table, generated on first use
+  bool perfectTables = true;
+  // solutions kept for boards that repeat up to symmetry, 0 solves every board
+  size_t dedupeClasses = 1 << 16;
+  // moves kept over all those solutions; a 100x100 slider alone takes millions
+  size_t dedupeMoves = 1 << 24;
+};
+
+/*
+ * Headless batch solving of JSON lines. Each input line is a board in the
+ * schema ConfigMgr parses, with the tiles in "slots" (the solved board when
+ * absent) and an optional "id" echoed back. Each output line carries the
+ * input line number, "solved", "optimal", "length" and the packed "moves",
+ * or an "error".
+ *
+ * The calling thread reads lines and writes results; options.threads
+ * workers solve. Results are written strictly in input order, as soon as
+ * every earlier line is done. Reading stops while options.window lines are
+ * in flight, so memory stays bounded by the window, not the corpus.
+ *
+ * Boards small enough for PerfectTables follow their table. Other sliders
+ * up to optimalSlots slots and rollers up to bfsSlots slots get the
+ * optimal solvers, sliders from hierarchicalSlots slots HierarchicalSolver,
+ * other boards AnytimeSolver for budgetSeconds, hex boards HexSolver.
+ * Solutions that are not known optimal go through SolutionOptimizer when
+ * optimize is set, up to optimizeMoves moves.
+ *
+ * A board that is a BoardSymmetry image of one solved before reuses its
+ * solution, mapped, and names the first line in "duplicateOf". Solutions
+ * are kept in the frame of their class's representative, one per class, up
+ * to dedupeClasses classes and dedupeMoves moves in all.
+ */
+struct BatchSolver {
+  BatchSolver(const BatchOptions& options = BatchOptions()) : options(options) {
+    if (this->options.window == 0) {
+      this->options.window = 4 * this->options.threads;
+    }
+  }
+
+  // returns the number of lines written
+  size_t run(std::istream& in, std::ostream& out) {
+    results.assign(options.window, Result());
+    written = 0;
+    done = false;
+    std::vector<std::thread> workers;
+    for (int t = 0; t < options.threads; ++t) {
+      workers.emplace_back([this] { work(); });
+    }
+    std::string line;
+    size_t read = 0;
+    while (std::getline(in, line)) {
+      if (line.find_first_not_of(" \t\r") == std::string::npos) {
+        continue;
+      }
+      std::unique_lock<std::mutex> lock(mutex);
+      while (read - written >= options.window) {
+        if (!flush(lock, out)) {
+          resultReady.wait(lock);
+        }
+      }
+      jobs.push_back({read++, std::move(line)});
+      jobReady.notify_one();
+      flush(lock, out);
+    }
+    {
+      std::unique_lock<std::mutex> lock(mutex);
+      done = true;
+      jobReady.notify_all();
+      while (written < read) {
+        if (!flush(lock, out)) {
+          resultReady.wait(lock);
+        }
+      }
+    }
+    for (std::thread& worker : workers) {
+      worker.join();
+    }
+    return written;
+  }
+
+  // solves one input line; never throws
+  json solveLine(size_t lineNumber, const std::string& line) {
+    json result;
+    result["line"] = lineNumber;
+    try {
+      const json config = json::parse(line);
+      if (config.contains("id")) {
+        result["id"] = config["id"];
+      }
+      solveConfig(lineNumber, config, result);
+    } catch (const std::exception& e) {
+      result["error"] = e.what();
+    }
+    return result;
+  }
+
+  BatchOptions options;
+
+private:
+  struct Job {
+    size_t line;
+    std::string text;
+  };
+
+  struct Result {
+    bool ready = false;
+    std::string text;
+  };
+
+  struct Solved {
+    size_t line;
+    bool optimal;
+    // in the frame of the class representative
+    std::vector<Move> moves;
+  };
+
+  void work() {
+    while (true) {
+      Job job;
+      {
+        std::unique_lock<std::mutex> lock(mutex);
+        jobReady.wait(lock, [this] { return done || !jobs.empty(); });
+        if (jobs.empty()) {
+          return;
+        }
+        job = std::move(jobs.front());
+        jobs.pop_front();
+      }
+      std::string text = solveLine(job.line, job.text).dump();
+      {
+        std::lock_guard<std::mutex> lock(mutex);
+        Result& slot = results[job.line % options.window];
+        slot.text = std::move(text);
+        slot.ready = true;
+      }
+      resultReady.notify_all();
+    }
+  }
+
+  // writes the results that are next in line, outside the lock; false when none was ready
+  bool flush(std::unique_lock<std::mutex>& lock, std::ostream& out) {
+    std::vector<std::string> ready;
+    for (size_t line = written; results[line % options.window].ready; ++line) {
+      Result& slot = results[line % options.window];
+      ready.push_back(std::move(slot.text));
+      slot = Result();
+    }
+    if (ready.empty()) {
+      return false;
+    }
+    lock.unlock();
+    for (const std::string& text : ready) {
+      out << text << '\n';
+    }
+    out.flush();
+    lock.lock();
+    written += ready.size();
+    return true;
+  }
+
+  void solveConfig(size_t lineNumber, const json& config, json& result) {
+    const BoardState start = BoardState::fromConfig(config);
+    if (start.size() == 0 || !Solvability::isPermutation(start)) {
+      result["error"] = "slots are not a permutation of the board's tiles";
+      return;
+    }
+    if (!Solvability::isSolvable(start)) {
+      result["error"] = "unsolvable";
+      return;
+    }
+    int element = 0;
+    const uint64_t key = options.dedupeClasses ? BoardSymmetry::classKey(start, &element) : 0;
+    if (options.dedupeClasses && reuse(start, key, element, result)) {
+      return;
+    }
+    SolveResult solution;
+    bool optimal = false;
+    const int slots = start.size();
+    const DistanceTable* table = options.perfectTables ? PerfectTables::shared().find(start) : nullptr;
+    if (table) {
+      solution.solved = optimal = PerfectTables::solve(*table, start, solution.moves);
+    } else if (start.type == PuzzleType::HexSpinPuzzle) {
+      HexSolver solver(start.rows, start.columns);
+      solution = solver.solve(start);
+    } else if (start.type == PuzzleType::SliderPuzzle && slots >= options.hierarchicalSlots) {
+      HierarchicalSolver solver(start.rows, start.columns);
+      solution = solver.solve(start);
+    } else if (start.type == PuzzleType::SliderPuzzle && slots <= options.optimalSlots) {
+      SliderSolver solver(start.rows, start.columns);
+      solution = solver.solve(start, options.nodeLimit);
+      optimal = solution.solved;
+    } else if (start.type == PuzzleType::RollerPuzzle && slots <= options.bfsSlots) {
+      RollerBfsSolver solver(start.rows, start.columns, options.bfsStates);
+      solver.fallbackThreads = 1;
+      solver.fallbackNodes = options.nodeLimit;
+      solution = solver.solve(start);
+      optimal = solution.solved;
+    }
+    if (!solution.solved && start.type != PuzzleType::HexSpinPuzzle) {
+      AnytimeSolver solver(start.rows, start.columns, start.type);
+      const uint64_t nodes = solution.nodes;
+      solution = solver.solve(start, options.budgetSeconds);
+      solution.nodes += nodes;
+    }
+    if (solution.solved && !optimal && options.optimize && solution.moves.size() <= options.optimizeMoves) {
+      SolutionOptimizer optimizer(start.type, start.rows, start.columns);
+      optimizer.optimize(start, solution.moves);
+    }
+    if (solution.solved && options.dedupeClasses && solution.moves.size() <= options.dedupeMoves) {
+      const BoardSymmetry& symmetry = BoardSymmetry::get(start);
+      Solved solved = {lineNumber, optimal, {}};
+      for (Move move : solution.moves) {
+        solved.moves.push_back(symmetry.mapMove(move, element));
+      }
+      std::lock_guard<std::mutex> lock(solvedMutex);
+      if (solvedClasses.size() < options.dedupeClasses && solvedMoves + solved.moves.size() <= options.dedupeMoves &&
+          solvedClasses.count(key) == 0) {
+        solvedMoves += solved.moves.size();
+        solvedClasses.insert({key, std::move(solved)});
+      }
+    }
+    result["solved"] = solution.solved;
+    result["optimal"] = optimal;
+    result["length"] = solution.moves.size();
+    result["moves"] = solution.moves;
+    result["nodes"] = solution.nodes;
+    result["seconds"] = solution.seconds;
+  }
+
+  // fills result from the solution of an earlier board of start's class
+  bool reuse(const BoardState& start, uint64_t key, int element, json& result) {
+    std::vector<Move> moves;
+    {
+      std::lock_guard<std::mutex> lock(solvedMutex);
+      const auto iter = solvedClasses.find(key);
+      if (iter == solvedClasses.end()) {
+        return false;
+      }
+      result["duplicateOf"] = iter->second.line;
+      result["optimal"] = iter->second.optimal;
+      moves = iter->second.moves;
+    }
+    const BoardSymmetry& symmetry = BoardSymmetry::get(start);
+    for (Move& move : moves) {
+      move = symmetry.mapMove(move, symmetry.inverse(element));
+    }
+    result["solved"] = true;
+    result["length"] = moves.size();
+    result["moves"] = moves;
+    result["nodes"] = 0;
+    result["seconds"] = 0.;
+    return true;
+  }
+
+  std::mutex mutex;
+  std::condition_variable jobReady;
+  std::condition_variable resultReady;
+  std::deque<Job> jobs;
+  std::vector<Result> results;
+  size_t written = 0;
+  bool done = false;
+  std::mutex solvedMutex;
+  tsl::robin_map<uint64_t, Solved> solvedClasses;
+  size_t solvedMoves = 0;
+};
+
+} // namespace tilepuzzles
+#endif
@@ -0,0 +1,300 @@
+#ifndef _BOARD_STATE_H_
+#define _BOARD_STATE_H_
+
+#include "HexTopology.h"
+#include "Zobrist.h"
+#include "enums.h"
+
+#include <nlohmann/json.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <numeric>
+#include <string>
+#include <vector>
+
+using json = nlohmann::json;
+
+namespace tilepuzzles {
+
+/*
+ * Logical puzzle position: the tile id held by every slot. Tile ids are the
+ * indices into Mesh::tiles, slots are row-major grid positions, so a solved
+ * board holds tile i in slot i. Moves only rewrite this array; the meshes
+ * regenerate vertex data from it when a frame or a hit test needs it.
+ *
+ * hash is a Zobrist hash of the position, updated in put() so every move
+ * costs O(tiles moved). Hex tiles hash by color: boards that differ only by
+ * swapping same-colored triangles are the same puzzle position.
+ */
+struct BoardState {
+  using TileId = uint16_t;
+
+  BoardState() {
+  }
+
+  BoardState(PuzzleType type, int rows, int columns) : type(type), rows(rows), columns(columns) {
+    if (type == PuzzleType::HexSpinPuzzle) {
+      topology = &HexTopology::get(rows, columns);
+      slots.resize(topology->slotCount());
+    } else {
+      slots.resize(rows * columns);
+    }
+    std::iota(slots.begin(), slots.end(), 0);
+    if (type == PuzzleType::SliderPuzzle) {
+      blank = slots.size() - 1;
+    }
+    rehash();
+  }
+
+  static BoardState slider(int rows, int columns) {
+    return BoardState(PuzzleType::SliderPuzzle, rows, columns);
+  }
+
+  static BoardState roller(int rows, int columns) {
+    return BoardState(PuzzleType::RollerPuzzle, rows, columns);
+  }
+
+  static BoardState hexSpinner(int rows, int columns) {
+    return BoardState(PuzzleType::HexSpinPuzzle, rows, columns);
+  }
+
+  // same schema ConfigMgr parses for the meshes, plus an optional "slots" array of the tile in each slot
+  static BoardState fromConfig(const json& config) {
+    const std::string type = config.at("type").get<std::string>();
+    const auto& dimension = config.at("dimension");
+    BoardState state;
+    if (type == "slider") {
+      const int dim = std::sqrt(dimension.at("count").get<int>() + 1);
+      state = slider(dim, dim);
+    } else if (type == "roller") {
+      const int dim = std::sqrt(dimension.at("count").get<int>());
+      state = roller(dim, dim);
+    } else {
+      state = hexSpinner(dimension.at("rows").get<int>(), dimension.at("columns").get<int>());
+    }
+    if (config.contains("slots")) {
+      // a wrong tile count or a tile out of range leaves no slots at all; duplicates are left to Solvability
+      const std::vector<TileId> slots = config.at("slots").get<std::vector<TileId>>();
+      const bool valid = slots.size() == state.slots.size() &&
+                         std::all_of(slots.begin(), slots.end(), [&](TileId tile) { return tile < slots.size(); });
+      state.slots = valid ? slots : std::vector<TileId>();
+      if (valid && type == "slider") {
+        state.blank = state.slotOf(state.blankTile());
+      }
+      state.rehash();
+    }
+    return state;
+  }
+
+  int size() const {
+    return slots.size();
+  }
+
+  int rowOf(int slot) const {
+    return slot / slotColumns();
+  }
+
+  int columnOf(int slot) const {
+    return slot % slotColumns();
+  }
+
+  int slotColumns() const {
+    return topology ? topology->slotColumns : columns;
+  }
+
+  TileId blankTile() const {
+    return slots.size() - 1;
+  }
+
+  int slotOf(TileId tile) const {
+    return std::find(slots.begin(), slots.end(), tile) - slots.begin();
+  }
+
+  bool isSolved() const {
+    if (topology) {
+      for (int s = 0; s < slots.size(); ++s) {
+        if (topology->slotColor(slots[s]) != topology->slotColor(s)) {
+          return false;
+        }
+      }
+      return true;
+    }
+    for (int s = 0; s < slots.size(); ++s) {
+      if (slots[s] != s) {
+        return false;
+      }
+    }
+    return true;
+  }
+
+  bool operator==(const BoardState& other) const {
+    return hash == other.hash && type == other.type && rows == other.rows && columns == other.columns &&
+           slots == other.slots;
+  }
+
+  bool operator!=(const BoardState& other) const {
+    return !(*this == other);
+  }
+
+  int hashValue(TileId tile) const {
+    return topology ? topology->slotColor(tile) : tile;
+  }
+
+  void rehash() {
+    hash = 0;
+    for (int s = 0; s < slots.size(); ++s) {
+      hash ^= Zobrist::key(hashValue(slots[s]), s);
+    }
+  }
+
+  void put(int slot, TileId tile) {
+    hash ^= Zobrist::key(hashValue(slots[slot]), slot) ^ Zobrist::key(hashValue(tile), slot);
+    slots[slot] = tile;
+  }
+
+  void swapSlots(int slot1, int slot2) {
+    const TileId tile1 = slots[slot1];
+    put(slot1, slots[slot2]);
+    put(slot2, tile1);
+    if (blank == slot1) {
+      blank = slot2;
+    } else if (blank == slot2) {
+      blank = slot1;
+    }
+  }
+
+  // slider: moves every tile between the blank and slot one step towards the blank
+  bool slide(int slot) {
+    if (slot == blank || slot < 0 || slot >= slots.size()) {
+      return false;
+    }
+    const int row = slot / columns;
+    const int blankRow = blank / columns;
+    int step = 0;
+    if (row == blankRow) {
+      step = slot > blank ? 1 : -1;
+    } else if (slot % columns == blank % columns) {
+      step = slot > blank ? columns : -columns;
+    } else {
+      return false;
+    }
+    for (int s = blank; s != slot; s += step) {
+      put(s, slots[s + step]);
+    }
+    put(slot, blankTile());
+    blank = slot;
+    return true;
+  }
+
+  // roller: delta 1 rolls right, -1 rolls left
+  void rollRow(int row, int delta) {
+    const int first = row * columns;
+    const int last = first + columns - 1;
+    if (delta > 0) {
+      const TileId wrap = slots[last];
+      for (int s = last; s > first; --s) {
+        put(s, slots[s - 1]);
+      }
+      put(first, wrap);
+    } else {
+      const TileId wrap = slots[first];
+      for (int s = first; s < last; ++s) {
+        put(s, slots[s + 1]);
+      }
+      put(last, wrap);
+    }
+  }
+
+  // roller: delta 1 rolls down, -1 rolls up
+  void rollColumn(int column, int delta) {
+    const int first = column;
+    const int last = (rows - 1) * columns + column;
+    if (delta > 0) {
+      const TileId wrap = slots[last];
+      for (int s = last; s > first; s -= columns) {
+        put(s, slots[s - columns]);
+      }
+      put(first, wrap);
+    } else {
+      const TileId wrap = slots[first];
+      for (int s = first; s < last; s += columns) {
+        put(s, slots[s + columns]);
+      }
+      put(last, wrap);
+    }
+  }
+
+  // roller: rolls the row or column through slot, like RollerMesh::rollTiles
+  void roll(int slot, Direction dir) {
+    switch (dir) {
+      case Direction::left:
+        rollRow(slot / columns, -1);
+        break;
+      case Direction::right:
+        rollRow(slot / columns, 1);
+        break;
+      case Direction::up:
+        rollColumn(slot % columns, -1);
+        break;
+      case Direction::down:
+        rollColumn(slot % columns, 1);
+        break;
+      default:
+        break;
+    }
+  }
+
+  // hex: steps of 60 degrees around an anchor, positive as in HexSpinMesh::rotateTileGroup
+  void rotateAnchor(int anchor, int steps) {
+    steps = ((steps % 6) + 6) % 6;
+    if (steps == 0) {
+      return;
+    }
+    const std::array<int, 6>& ring = topology->anchors[anchor].ring;
+    std::array<TileId, 6> ringTiles;
+    for (int k = 0; k < 6; ++k) {
+      ringTiles[k] = slots[ring[k]];
+    }
+    for (int k = 0; k < 6; ++k) {
+      put(ring[(k + steps) % 6], ringTiles[k]);
+    }
+  }
+
+  // hex: shifts the contents of a whole row or column of tile groups, like HexSpinMesh::rollTileGroups
+  void rollGroups(int groupRow, int groupColumn, Direction dir) {
+    const bool vertical = dir == Direction::up || dir == Direction::down;
+    const bool forward = dir == Direction::down || dir == Direction::right;
+    const int count = vertical ? topology->rows : topology->columns;
+    auto groupAt = [&](int i) {
+      return vertical ? topology->groupSlots(i, groupColumn) : topology->groupSlots(groupRow, i);
+    };
+    for (int k = 0; k < 6; ++k) {
+      if (forward) {
+        const TileId wrap = slots[groupAt(count - 1)[k]];
+        for (int i = count - 1; i > 0; --i) {
+          put(groupAt(i)[k], slots[groupAt(i - 1)[k]]);
+        }
+        put(groupAt(0)[k], wrap);
+      } else {
+        const TileId wrap = slots[groupAt(0)[k]];
+        for (int i = 0; i < count - 1; ++i) {
+          put(groupAt(i)[k], slots[groupAt(i + 1)[k]]);
+        }
+        put(groupAt(count - 1)[k], wrap);
+      }
+    }
+  }
+
+  PuzzleType type = PuzzleType::SliderPuzzle;
+  int rows = 0;
+  int columns = 0;
+  int blank = -1;
+  std::vector<TileId> slots;
+  const HexTopology* topology = nullptr;
+  uint64_t hash = 0;
+};
+
+} // namespace tilepuzzles
+#endif
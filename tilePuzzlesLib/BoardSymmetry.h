@@ -0,0 +1,386 @@
+#ifndef _BOARD_SYMMETRY_H_
+#define _BOARD_SYMMETRY_H_
+
+#include "BoardState.h"
+#include "MoveGenerator.h"
+#include "PermRank.h"
+#include "Zobrist.h"
+
+#include <tsl/robin_map.h>
+#include <tsl/robin_set.h>
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <tuple>
+#include <vector>
+
+namespace tilepuzzles {
+
+/*
+ * Slot permutations g that map the solved board to itself and moves to
+ * moves. Tile ids are home slots, so a board S maps to S' with
+ * S'[g(s)] = g(S[s]), its moves to g m g^-1 and its distance is kept:
+ * every board of a symmetry class needs the same solution, mapped.
+ *
+ * Sliders keep the blank's home corner, which leaves the reflection about
+ * the main diagonal of square boards. Rollers keep all of it, every mirror
+ * and rotation of the rectangle times every cyclic shift of rows and
+ * columns. Hex boards get the mirrors and the half turn of the board
+ * outline that map anchors to anchors and color groups to color groups,
+ * found by checking the slot geometry.
+ *
+ * Element 0 is the identity. The first orderPreserving elements (the
+ * identity and the diagonal reflection) keep the order of row and column
+ * indices, so IDA* transposition keys may use them with searches that
+ * only try commuting rolls in increasing line order. Built once per board
+ * shape and shared, like HexTopology.
+ */
+struct BoardSymmetry {
+  using TileId = BoardState::TileId;
+
+  BoardSymmetry(PuzzleType type, int rows, int columns)
+      : shape(type, rows, columns), shapeKey(Zobrist::mix(int(type) << 16 | rows, columns)) {
+    slotMaps.push_back(identity());
+    if (type == PuzzleType::HexSpinPuzzle) {
+      initHex();
+    } else {
+      initGrid();
+    }
+    // initGrid() adds the diagonal reflection second on square boards only; elsewhere slotMaps[1] is a shift
+    orderPreserving = type != PuzzleType::HexSpinPuzzle && rows == columns && slotMaps.size() > 1 ? 2 : 1;
+    initInverses();
+    if (type != PuzzleType::SliderPuzzle) {
+      initMoveMaps();
+    }
+  }
+
+  static const BoardSymmetry& get(PuzzleType type, int rows, int columns) {
+    static std::mutex mutex;
+    static std::map<std::tuple<PuzzleType, int, int>, std::unique_ptr<BoardSymmetry>> cache;
+    std::lock_guard<std::mutex> lock(mutex);
+    auto& symmetry = cache[{type, rows, columns}];
+    if (!symmetry) {
+      symmetry.reset(new BoardSymmetry(type, rows, columns));
+    }
+    return *symmetry;
+  }
+
+  static const BoardSymmetry& get(const BoardState& state) {
+    return get(state.type, state.rows, state.columns);
+  }
+
+  int size() const {
+    return slotMaps.size();
+  }
+
+  int slotMap(int element, int slot) const {
+    return slotMaps[element][slot];
+  }
+
+  BoardState transform(const BoardState& state, int element) const {
+    const std::vector<uint16_t>& g = slotMaps[element];
+    BoardState image = state;
+    for (int s = 0; s < state.size(); ++s) {
+      image.slots[g[s]] = g[state.slots[s]];
+    }
+    if (state.type == PuzzleType::SliderPuzzle) {
+      image.blank = g[state.blank];
+    }
+    image.rehash();
+    return image;
+  }
+
+  // the move doing to transform(state, element) what move does to state
+  Move mapMove(Move move, int element) const {
+    if (element == 0) {
+      return move;
+    }
+    const std::vector<uint16_t>& g = slotMaps[element];
+    if (shape.type == PuzzleType::SliderPuzzle) {
+      return MoveGenerator::slide(g[MoveGenerator::index(move)], g[MoveGenerator::arg(move)]);
+    }
+    const auto iter = moveMaps[element].find(move);
+    return iter == moveMaps[element].end() ? move : iter->second;
+  }
+
+  int inverse(int element) const {
+    return inverses[element];
+  }
+
+  // Zobrist hash of transform(state, element) without building it
+  uint64_t hashOf(const BoardState& state, int element) const {
+    const std::vector<uint16_t>& g = slotMaps[element];
+    uint64_t hash = 0;
+    for (int s = 0; s < state.size(); ++s) {
+      hash ^= Zobrist::key(state.hashValue(g[state.slots[s]]), g[s]);
+    }
+    return hash;
+  }
+
+  // the same for every board of a symmetry class; element, when given, maps state to the representative
+  uint64_t canonicalHash(const BoardState& state, int* element = nullptr) const {
+    uint64_t best = state.hash;
+    int bestElement = 0;
+    for (int e = 1; e < size(); ++e) {
+      const uint64_t hash = hashOf(state, e);
+      if (hash < best) {
+        best = hash;
+        bestElement = e;
+      }
+    }
+    if (element) {
+      *element = bestElement;
+    }
+    return best;
+  }
+
+  BoardState canonical(const BoardState& state, int* element = nullptr) const {
+    int e = 0;
+    canonicalHash(state, &e);
+    if (element) {
+      *element = e;
+    }
+    return transform(state, e);
+  }
+
+  // smallest lexicographic rank in the class, the index perfect tables store it under
+  uint64_t canonicalRank(const BoardState& state) const {
+    std::array<TileId, PermRank::MAX_N> image;
+    uint64_t best = PermRank::rank(state);
+    for (int e = 1; e < size(); ++e) {
+      const std::vector<uint16_t>& g = slotMaps[e];
+      for (int s = 0; s < state.size(); ++s) {
+        image[g[s]] = g[state.slots[s]];
+      }
+      best = std::min(best, PermRank::lexRank(image.data(), state.size()));
+    }
+    return best;
+  }
+
+  /*
+   * Transposition table key of tiles reached by last, shared with its order
+   * preserving images and told apart across board shapes.
+   */
+  template <typename T>
+  uint64_t tableKey(const T* tiles, int count, Move last, Move noMove) const {
+    uint64_t best = 0;
+    for (int e = 0; e < orderPreserving; ++e) {
+      const std::vector<uint16_t>& g = slotMaps[e];
+      uint64_t key = last == noMove ? 0 : Zobrist::mix(mapMove(last, e), Zobrist::TABLE_DIM);
+      for (int s = 0; s < count; ++s) {
+        key ^= Zobrist::key(g[tiles[s]], g[s]);
+      }
+      if (e == 0 || key < best) {
+        best = key;
+      }
+    }
+    return best ^ shapeKey;
+  }
+
+  // canonicalHash, told apart across board shapes
+  static uint64_t classKey(const BoardState& board, int* element = nullptr) {
+    const BoardSymmetry& symmetry = get(board);
+    return symmetry.canonicalHash(board, element) ^ symmetry.shapeKey;
+  }
+
+  // indices of the first board of each symmetry class, in order
+  static std::vector<size_t> unique(const std::vector<BoardState>& boards) {
+    tsl::robin_set<uint64_t> seen;
+    std::vector<size_t> kept;
+    for (size_t i = 0; i < boards.size(); ++i) {
+      if (seen.insert(classKey(boards[i])).second) {
+        kept.push_back(i);
+      }
+    }
+    return kept;
+  }
+
+  BoardState shape;
+  // puzzle type and dimensions, mixed into the keys that tables share across shapes
+  uint64_t shapeKey;
+  int orderPreserving = 1;
+
+private:
+  std::vector<uint16_t> identity() const {
+    std::vector<uint16_t> g(shape.size());
+    for (int s = 0; s < g.size(); ++s) {
+      g[s] = s;
+    }
+    return g;
+  }
+
+  template <typename F>
+  void addGridMap(F map) {
+    std::vector<uint16_t> g(shape.size());
+    for (int s = 0; s < g.size(); ++s) {
+      const auto [r, c] = map(s / shape.columns, s % shape.columns);
+      g[s] = r * shape.columns + c;
+    }
+    if (std::find(slotMaps.begin(), slotMaps.end(), g) == slotMaps.end()) {
+      slotMaps.push_back(g);
+    }
+  }
+
+  void initGrid() {
+    const int rows = shape.rows;
+    const int columns = shape.columns;
+    const bool square = rows == columns;
+    if (square) {
+      addGridMap([](int r, int c) { return std::pair(c, r); });
+    }
+    if (shape.type == PuzzleType::SliderPuzzle) {
+      return;
+    }
+    std::vector<std::function<std::pair<int, int>(int, int)>> mirrors = {
+        [](int r, int c) { return std::pair(r, c); },
+        [rows](int r, int c) { return std::pair(rows - 1 - r, c); },
+        [columns](int r, int c) { return std::pair(r, columns - 1 - c); },
+        [rows, columns](int r, int c) { return std::pair(rows - 1 - r, columns - 1 - c); }};
+    if (square) {
+      mirrors.push_back([](int r, int c) { return std::pair(c, r); });
+      mirrors.push_back([rows](int r, int c) { return std::pair(rows - 1 - c, rows - 1 - r); });
+      mirrors.push_back([rows](int r, int c) { return std::pair(c, rows - 1 - r); });
+      mirrors.push_back([rows](int r, int c) { return std::pair(rows - 1 - c, r); });
+    }
+    for (const auto& mirror : mirrors) {
+      for (int dr = 0; dr < rows; ++dr) {
+        for (int dc = 0; dc < columns; ++dc) {
+          addGridMap([&](int r, int c) {
+            const auto [mr, mc] = mirror(r, c);
+            return std::pair((mr + dr) % rows, (mc + dc) % columns);
+          });
+        }
+      }
+    }
+  }
+
+  // slot centroids mirrored or turned about the board's center, kept when they map moves and colors
+  void initHex() {
+    const HexTopology& topology = *shape.topology;
+    std::vector<std::pair<double, double>> centroids;
+    double minX = 1e9, maxX = -1e9, minY = 1e9, maxY = -1e9;
+    for (const auto& v : topology.slotVertices) {
+      centroids.push_back({(v[0] + v[2] + v[4]) / 3., (v[1] + v[3] + v[5]) / 3.});
+      for (int i = 0; i < 3; ++i) {
+        minX = std::min(minX, v[i * 2]);
+        maxX = std::max(maxX, v[i * 2]);
+        minY = std::min(minY, v[i * 2 + 1]);
+        maxY = std::max(maxY, v[i * 2 + 1]);
+      }
+    }
+    const double cx = (minX + maxX) / 2.;
+    const double cy = (minY + maxY) / 2.;
+    for (const auto& [fx, fy] : {std::pair(-1., 1.), std::pair(1., -1.), std::pair(-1., -1.)}) {
+      std::vector<uint16_t> g(shape.size());
+      bool mapped = true;
+      for (int s = 0; s < shape.size() && mapped; ++s) {
+        const double x = cx + fx * (centroids[s].first - cx);
+        const double y = cy + fy * (centroids[s].second - cy);
+        const auto iter = std::find_if(centroids.begin(), centroids.end(), [x, y](const auto& p) {
+          return std::abs(p.first - x) <= HexTopology::EPS && std::abs(p.second - y) <= HexTopology::EPS;
+        });
+        mapped = iter != centroids.end();
+        g[s] = iter - centroids.begin();
+      }
+      if (mapped && keepsColors(g) && keepsMoves(g)) {
+        slotMaps.push_back(g);
+      }
+    }
+  }
+
+  // same colored slots stay same colored
+  bool keepsColors(const std::vector<uint16_t>& g) const {
+    std::map<int, int> colorMap;
+    for (int s = 0; s < g.size(); ++s) {
+      const auto [iter, added] = colorMap.insert({shape.hashValue(s), shape.hashValue(g[s])});
+      if (iter->second != shape.hashValue(g[s])) {
+        return false;
+      }
+    }
+    return true;
+  }
+
+  bool keepsMoves(const std::vector<uint16_t>& g) const {
+    std::vector<std::vector<uint16_t>> perms;
+    for (Move move : allMoves()) {
+      perms.push_back(permutation(move));
+    }
+    for (const std::vector<uint16_t>& perm : perms) {
+      if (std::find(perms.begin(), perms.end(), conjugate(perm, g)) == perms.end()) {
+        return false;
+      }
+    }
+    return true;
+  }
+
+  // generated moves plus the inverse rolls of lines of two that solvers emit
+  std::vector<Move> allMoves() const {
+    std::vector<Move> moves(MoveGenerator::maxMoves(shape));
+    moves.resize(MoveGenerator::generate(shape, moves.data()));
+    for (int i = moves.size() - 1; i >= 0; --i) {
+      if (std::find(moves.begin(), moves.end(), MoveGenerator::inverse(moves[i])) == moves.end()) {
+        moves.push_back(MoveGenerator::inverse(moves[i]));
+      }
+    }
+    return moves;
+  }
+
+  // slot each slot's content ends up in
+  std::vector<uint16_t> permutation(Move move) const {
+    BoardState state = shape;
+    MoveGenerator::apply(state, move);
+    std::vector<uint16_t> perm(state.size());
+    for (int s = 0; s < state.size(); ++s) {
+      perm[state.slots[s]] = s;
+    }
+    return perm;
+  }
+
+  // g perm g^-1
+  static std::vector<uint16_t> conjugate(const std::vector<uint16_t>& perm, const std::vector<uint16_t>& g) {
+    std::vector<uint16_t> result(perm.size());
+    for (int s = 0; s < perm.size(); ++s) {
+      result[g[s]] = g[perm[s]];
+    }
+    return result;
+  }
+
+  void initInverses() {
+    for (const std::vector<uint16_t>& g : slotMaps) {
+      std::vector<uint16_t> back(g.size());
+      for (int s = 0; s < g.size(); ++s) {
+        back[g[s]] = s;
+      }
+      inverses.push_back(std::find(slotMaps.begin(), slotMaps.end(), back) - slotMaps.begin());
+    }
+  }
+
+  void initMoveMaps() {
+    const std::vector<Move> moves = allMoves();
+    std::vector<std::vector<uint16_t>> perms;
+    for (Move move : moves) {
+      perms.push_back(permutation(move));
+    }
+    moveMaps.resize(slotMaps.size());
+    for (int e = 1; e < slotMaps.size(); ++e) {
+      for (int m = 0; m < moves.size(); ++m) {
+        const auto image = std::find(perms.begin(), perms.end(), conjugate(perms[m], slotMaps[e]));
+        moveMaps[e][moves[m]] = moves[image - perms.begin()];
+      }
+    }
+  }
+
+  std::vector<std::vector<uint16_t>> slotMaps;
+  std::vector<int> inverses;
+  // roller and hex moves per element; slides map by their slots
+  std::vector<tsl::robin_map<Move, Move>> moveMaps;
+};
+
+} // namespace tilepuzzles
+#endif
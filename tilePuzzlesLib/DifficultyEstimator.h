@@ -0,0 +1,317 @@
+#ifndef _DIFFICULTY_ESTIMATOR_H_
+#define _DIFFICULTY_ESTIMATOR_H_
+
+#include "AnytimeSolver.h"
+#include "BoardState.h"
+#include "GameUtil.h"
+#include "HexSolver.h"
+#include "MoveGenerator.h"
+#include "ParallelIda.h"
+#include "SliderSolver.h"
+#include "SolutionOptimizer.h"
+#include "Solvability.h"
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cmath>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <tuple>
+#include <vector>
+
+namespace tilepuzzles {
+
+struct Difficulty {
+  bool solved = false;
+  // the single tile solution the length comes from was proven shortest
+  bool optimal = false;
+  // moves of the solution, in the moves generate() offers
+  int length = 0;
+  // admissible heuristic of the board, in the same moves
+  int lowerBound = 0;
+  // share of the solution the lower bound does not account for, 0 to 1
+  double gap = 0.;
+  // legal moves per position along the solution, undoing the last move not counted
+  double branching = 0.;
+  // share of positions along the solution where no move brings the board closer
+  double deadEnds = 0.;
+  // choices a player weighs along the solution, in bits
+  double bits = 0.;
+  // bits relative to a fully shuffled board of the same shape, 0 solved to about 1 and above
+  double score = 0.;
+};
+
+/*
+ * Scores how hard a board is from a solution and the positions it passes.
+ *
+ * The solution is optimal where SliderSolver finishes within optimalNodes,
+ * otherwise AnytimeSolver's first solution (HexSolver's for hex boards)
+ * shortened by SolutionOptimizer. Along it every position is rated with a
+ * progress measure: Manhattan distance plus linear conflicts on sliders,
+ * summed cyclic distance on rollers, wrong colors on hex boards. A move
+ * that lowers the measure is obvious when the solution takes one of them,
+ * and the player picks among the lowering moves; any other solution move
+ * is a pick among every legal move. bits sums log2 of those picks, a
+ * position without a lowering move is a dead end.
+ *
+ * score divides bits by the median bits of CALIBRATION_BOARDS fully
+ * shuffled boards of the shape, sampled once per shape and shared, so
+ * scores compare across puzzle types and sizes where shuffle counts do not.
+ */
+struct DifficultyEstimator {
+  static constexpr int CALIBRATION_BOARDS = 32;
+  static constexpr uint64_t DEFAULT_OPTIMAL_NODES = 20000;
+  static constexpr double DEFAULT_BUDGET_SECONDS = 0.05;
+
+  DifficultyEstimator(PuzzleType type, int rows, int columns)
+      : type(type), rows(rows), columns(columns), sliderHeuristic(rows, columns),
+        optimizer(type, rows, columns) {
+    if (type == PuzzleType::HexSpinPuzzle) {
+      const BoardState shape = BoardState::hexSpinner(rows, columns);
+      std::vector<Move> moves(MoveGenerator::maxMoves(shape));
+      moves.resize(MoveGenerator::generate(shape, moves.data()));
+      for (Move move : moves) {
+        BoardState moved = shape;
+        MoveGenerator::apply(moved, move);
+        int count = 0;
+        for (int s = 0; s < moved.size(); ++s) {
+          count += moved.slots[s] != s;
+        }
+        hexMaxMoved = std::max(hexMaxMoved, count);
+      }
+    }
+  }
+
+  Difficulty estimate(const BoardState& board) {
+    Difficulty result = measure(board);
+    if (result.solved) {
+      const double typical = Calibration::get(type, rows, columns).medianBits;
+      result.score = typical > 0. ? result.bits / typical : 0.;
+    }
+    return result;
+  }
+
+  /*
+   * Random moves from state until its score reaches target or maxMoves
+   * were made, scoring every checkEvery moves. Returns the moves made.
+   */
+  int scrambleTo(BoardState& state, double target, int maxMoves, int checkEvery = 0) {
+    if (checkEvery <= 0) {
+      checkEvery = std::max(1, state.size() / 2);
+    }
+    std::vector<Move> moves(MoveGenerator::maxMoves(state));
+    int made = 0;
+    while (made < maxMoves) {
+      for (int i = 0; i < checkEvery && made < maxMoves; ++i, ++made) {
+        const int count = MoveGenerator::generate(state, moves.data());
+        MoveGenerator::apply(state, moves[GameUtil::trand(0, count)]);
+      }
+      if (estimate(state).score >= target) {
+        break;
+      }
+    }
+    return made;
+  }
+
+  // scores boards on threads workers, results in board order
+  static std::vector<Difficulty> estimateAll(const std::vector<BoardState>& boards,
+                                             int threads = std::thread::hardware_concurrency()) {
+    std::vector<Difficulty> results(boards.size());
+    std::atomic<size_t> next = 0;
+    std::vector<std::thread> workers;
+    for (int t = 0; t < std::max(1, threads); ++t) {
+      workers.emplace_back([&] {
+        std::map<std::tuple<PuzzleType, int, int>, std::unique_ptr<DifficultyEstimator>> estimators;
+        for (size_t i = next++; i < boards.size(); i = next++) {
+          const BoardState& board = boards[i];
+          auto& estimator = estimators[{board.type, board.rows, board.columns}];
+          if (!estimator) {
+            estimator.reset(new DifficultyEstimator(board.type, board.rows, board.columns));
+          }
+          results[i] = estimator->estimate(board);
+        }
+      });
+    }
+    for (std::thread& worker : workers) {
+      worker.join();
+    }
+    return results;
+  }
+
+  PuzzleType type;
+  int rows;
+  int columns;
+  uint64_t optimalNodes = DEFAULT_OPTIMAL_NODES;
+  double budgetSeconds = DEFAULT_BUDGET_SECONDS;
+
+private:
+  // median bits of fully shuffled boards, one per shape
+  struct Calibration {
+    Calibration(PuzzleType type, int rows, int columns) {
+      DifficultyEstimator estimator(type, rows, columns);
+      std::vector<double> bits;
+      for (int i = 0; i < CALIBRATION_BOARDS; ++i) {
+        BoardState board(type, rows, columns);
+        shuffle(board);
+        const Difficulty difficulty = estimator.measure(board);
+        if (difficulty.solved) {
+          bits.push_back(difficulty.bits);
+        }
+      }
+      if (!bits.empty()) {
+        std::nth_element(bits.begin(), bits.begin() + bits.size() / 2, bits.end());
+        medianBits = bits[bits.size() / 2];
+      }
+    }
+
+    static const Calibration& get(PuzzleType type, int rows, int columns) {
+      static std::mutex mutex;
+      static std::map<std::tuple<PuzzleType, int, int>, std::unique_ptr<Calibration>> cache;
+      std::lock_guard<std::mutex> lock(mutex);
+      auto& calibration = cache[{type, rows, columns}];
+      if (!calibration) {
+        calibration.reset(new Calibration(type, rows, columns));
+      }
+      return *calibration;
+    }
+
+    // hex boards have no parity to fix, so a long random walk stands in for a uniform shuffle
+    static void shuffle(BoardState& board) {
+      if (board.type != PuzzleType::HexSpinPuzzle) {
+        GameUtil::shuffleSlots(board);
+        Solvability::makeSolvable(board);
+        return;
+      }
+      std::vector<Move> moves(MoveGenerator::maxMoves(board));
+      for (int i = 0; i < 20 * board.size(); ++i) {
+        const int count = MoveGenerator::generate(board, moves.data());
+        MoveGenerator::apply(board, moves[GameUtil::trand(0, count)]);
+      }
+    }
+
+    double medianBits = 0.;
+  };
+
+  Difficulty measure(const BoardState& board) {
+    Difficulty result;
+    if (board.isSolved()) {
+      result.solved = true;
+      return result;
+    }
+    if (!Solvability::isSolvable(board)) {
+      return result;
+    }
+    SolveResult solution;
+    if (type == PuzzleType::SliderPuzzle && board.size() <= 16) {
+      SliderSolver solver(rows, columns);
+      solution = solver.solve(board, optimalNodes);
+      result.optimal = solution.solved;
+    }
+    if (!solution.solved) {
+      if (type == PuzzleType::HexSpinPuzzle) {
+        HexSolver solver(rows, columns);
+        solution = solver.solve(board);
+      } else {
+        if (!anytime) {
+          anytime.reset(new AnytimeSolver(rows, columns, type));
+          // the first solution is enough once SolutionOptimizer shortens it
+          anytime->onSolution = [this](const std::vector<Move>&) { firstSolution = true; };
+        }
+        firstSolution = false;
+        solution = anytime->solve(board, budgetSeconds, &firstSolution);
+      }
+    }
+    if (!solution.solved) {
+      return result;
+    }
+    // also merges single tile slides into the line slides a player makes
+    optimizer.optimize(board, solution.moves);
+    result.solved = true;
+    result.length = solution.moves.size();
+    result.lowerBound = lowerBound(board);
+    result.gap = result.length > 0 ? std::max(0., 1. - double(result.lowerBound) / result.length) : 0.;
+
+    std::array<Move, 256> moves;
+    BoardState state = board;
+    int choices = 0;
+    int deadEnds = 0;
+    for (int i = 0; i < result.length; ++i) {
+      const Move back = i > 0 ? MoveGenerator::inverse(solution.moves[i - 1]) : ~Move(0);
+      const int count = MoveGenerator::generate(state, moves.data());
+      const int before = progress(state);
+      int legal = 0;
+      int lowering = 0;
+      bool taken = false;
+      for (int k = 0; k < count; ++k) {
+        if (moves[k] == back) {
+          continue;
+        }
+        ++legal;
+        MoveGenerator::apply(state, moves[k]);
+        if (progress(state) < before) {
+          ++lowering;
+          taken |= moves[k] == solution.moves[i];
+        }
+        MoveGenerator::unapply(state, moves[k]);
+      }
+      choices += legal;
+      deadEnds += lowering == 0;
+      result.bits += std::log2(std::max(1, taken ? lowering : legal));
+      MoveGenerator::apply(state, solution.moves[i]);
+    }
+    if (result.length > 0) {
+      result.branching = double(choices) / result.length;
+      result.deadEnds = double(deadEnds) / result.length;
+    }
+    return result;
+  }
+
+  int lowerBound(const BoardState& state) const {
+    switch (type) {
+      case PuzzleType::SliderPuzzle: {
+        // a line slide is up to longest single tile moves
+        const int longest = std::max(rows, columns) - 1;
+        return (sliderHeuristic.evaluate(SliderNode(state)).h() + longest - 1) / longest;
+      }
+      case PuzzleType::RollerPuzzle:
+        return rollerHeuristic.evaluate(state).h();
+      default:
+        // a move fixes at most the triangles it moves
+        return (progress(state) + hexMaxMoved - 1) / hexMaxMoved;
+    }
+  }
+
+  // lower is closer to solved; finer grained than lowerBound so single moves show
+  int progress(const BoardState& state) const {
+    int measure = 0;
+    switch (type) {
+      case PuzzleType::SliderPuzzle:
+        return sliderHeuristic.evaluate(SliderNode(state)).h();
+      case PuzzleType::RollerPuzzle:
+        for (int s = 0; s < state.size(); ++s) {
+          const int tile = state.slots[s];
+          measure += RollerHeuristic::cyclic(tile % columns, s % columns, columns) +
+                     RollerHeuristic::cyclic(tile / columns, s / columns, rows);
+        }
+        return measure;
+      default:
+        for (int s = 0; s < state.size(); ++s) {
+          measure += state.topology->slotColor(state.slots[s]) != state.topology->slotColor(s);
+        }
+        return measure;
+    }
+  }
+
+  SliderHeuristic sliderHeuristic;
+  RollerHeuristic rollerHeuristic;
+  SolutionOptimizer optimizer;
+  std::unique_ptr<AnytimeSolver> anytime;
+  std::atomic<bool> firstSolution = false;
+  int hexMaxMoved = 1;
+};
+
+} // namespace tilepuzzles
+#endif
@@ -0,0 +1,725 @@
+#ifndef _EXTERNAL_BFS_H_
+#define _EXTERNAL_BFS_H_
+
+#ifdef USE_SDL
+#include "GLogger.h"
+#endif
+
+#include "BoardState.h"
+#include "BoardSymmetry.h"
+#include "MoveGenerator.h"
+#include "PermRank.h"
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <functional>
+#include <limits>
+#include <queue>
+#include <string>
+#include <vector>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace tilepuzzles {
+
+/*
+ * Sequential reader and writer of sorted uint64_t rank files, the only file
+ * format the external BFS uses besides its checkpoint and the final table.
+ */
+struct RankFileReader {
+  static constexpr size_t BUFFER = 1 << 16;
+
+  RankFileReader() {
+  }
+
+  RankFileReader(const RankFileReader&) = delete;
+  RankFileReader& operator=(const RankFileReader&) = delete;
+
+  ~RankFileReader() {
+    close();
+  }
+
+  bool open(const std::string& path) {
+    close();
+    file = std::fopen(path.c_str(), "rb");
+    buffer.resize(BUFFER);
+    return file != nullptr;
+  }
+
+  bool next(uint64_t& rank) {
+    if (position == count) {
+      count = file ? std::fread(buffer.data(), sizeof(uint64_t), BUFFER, file) : 0;
+      position = 0;
+      if (count == 0) {
+        return false;
+      }
+    }
+    rank = buffer[position++];
+    return true;
+  }
+
+  void close() {
+    if (file) {
+      std::fclose(file);
+      file = nullptr;
+    }
+    position = count = 0;
+  }
+
+private:
+  FILE* file = nullptr;
+  std::vector<uint64_t> buffer;
+  size_t position = 0;
+  size_t count = 0;
+};
+
+struct RankFileWriter {
+  static constexpr size_t BUFFER = 1 << 16;
+
+  RankFileWriter() {
+  }
+
+  RankFileWriter(const RankFileWriter&) = delete;
+  RankFileWriter& operator=(const RankFileWriter&) = delete;
+
+  ~RankFileWriter() {
+    close();
+  }
+
+  bool open(const std::string& path) {
+    close();
+    file = std::fopen(path.c_str(), "wb");
+    buffer.reserve(BUFFER);
+    written = 0;
+    ok = file != nullptr;
+    return ok;
+  }
+
+  void put(uint64_t rank) {
+    buffer.push_back(rank);
+    ++written;
+    if (buffer.size() == BUFFER) {
+      flush();
+    }
+  }
+
+  // false if any write failed
+  bool close() {
+    if (file) {
+      flush();
+      ok = std::fclose(file) == 0 && ok;
+      file = nullptr;
+    }
+    return ok;
+  }
+
+  uint64_t written = 0;
+
+private:
+  void flush() {
+    ok = ok && std::fwrite(buffer.data(), sizeof(uint64_t), buffer.size(), file) == buffer.size();
+    buffer.clear();
+  }
+
+  FILE* file = nullptr;
+  std::vector<uint64_t> buffer;
+  bool ok = false;
+};
+
+/*
+ * Distance file layout, little endian:
+ *   DistanceTableHeader
+ *   one byte per lexicographic rank, from PAGE_ALIGN on; UNREACHED for
+ *   positions the solved board cannot reach
+ *
+ * A symmetric table stores one distance per BoardSymmetry class instead,
+ * under the class's smallest rank: from PAGE_ALIGN on a bitmap with one bit
+ * per rank set for the stored ones, then for every BLOCK_BITS ranks the
+ * stored ranks before them as uint64_t, then the stored distances in rank
+ * order.
+ */
+struct DistanceTableHeader {
+  char magic[8];
+  uint32_t version;
+  uint32_t type;
+  uint32_t rows;
+  uint32_t columns;
+  uint32_t maxDistance;
+  uint32_t symmetric;
+  uint64_t states;
+  uint64_t reachable;
+  // positions at each distance
+  uint64_t counts[255];
+  // distances in the file, fewer than reachable when symmetric
+  uint64_t stored;
+};
+
+/*
+ * Exact distance in MoveGenerator moves of every position of a small board,
+ * mapped read-only from a file ExternalBfs wrote. distance() is one rank and
+ * one byte load; hint() probes the neighbors for one a move closer, so it
+ * always returns an optimal move. A symmetric table ranks every image of
+ * the position for the class's smallest rank and counts the stored ranks
+ * before it in its bitmap block.
+ */
+struct DistanceTable {
+  static constexpr char MAGIC[8] = {'T', 'P', 'D', 'I', 'S', 'T', 0, 0};
+  static constexpr uint32_t VERSION = 2;
+  static constexpr uint8_t UNREACHED = 0xff;
+  static constexpr uint64_t PAGE_ALIGN = 4096;
+  static constexpr uint64_t BLOCK_BITS = 512;
+
+  // bitmap words, block counts and distance bytes of a symmetric table
+  static uint64_t bitmapWords(uint64_t states) {
+    return (states + 63) / 64;
+  }
+
+  static uint64_t blockCount(uint64_t states) {
+    return (states + BLOCK_BITS - 1) / BLOCK_BITS;
+  }
+
+  static uint64_t tableBytes(const DistanceTableHeader& header) {
+    if (!header.symmetric) {
+      return header.states;
+    }
+    return bitmapWords(header.states) * 8 + blockCount(header.states) * 8 + header.stored;
+  }
+
+  DistanceTable() {
+  }
+
+  DistanceTable(const DistanceTable&) = delete;
+  DistanceTable& operator=(const DistanceTable&) = delete;
+
+  ~DistanceTable() {
+    close();
+  }
+
+  bool open(const std::string& path) {
+    close();
+    int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0) {
+      return fail("cannot open", path);
+    }
+    struct stat info;
+    if (fstat(fd, &info) != 0 || info.st_size < PAGE_ALIGN) {
+      ::close(fd);
+      return fail("truncated", path);
+    }
+    void* data = mmap(nullptr, info.st_size, PROT_READ, MAP_SHARED, fd, 0);
+    ::close(fd);
+    if (data == MAP_FAILED) {
+      return fail("cannot map", path);
+    }
+    mapped = static_cast<const uint8_t*>(data);
+    mappedSize = info.st_size;
+    header = reinterpret_cast<const DistanceTableHeader*>(mapped);
+    // version 1 tables are the plain layout with symmetric zero
+    if (std::memcmp(header->magic, MAGIC, sizeof(MAGIC)) != 0 || header->version < 1 || header->version > VERSION ||
+        header->type > PuzzleType::RollerPuzzle || header->rows * header->columns > 20 || header->states != PermRank::factorial(header->rows * header->columns) ||
+        PAGE_ALIGN + tableBytes(*header) > mappedSize) {
+      close();
+      return fail("unsupported format", path);
+    }
+    table = mapped + PAGE_ALIGN;
+    shape = BoardState(PuzzleType(header->type), header->rows, header->columns);
+    symmetry = nullptr;
+    if (header->symmetric) {
+      symmetry = &BoardSymmetry::get(shape);
+      bitmap = reinterpret_cast<const uint64_t*>(table);
+      blocks = bitmap + bitmapWords(header->states);
+      table = reinterpret_cast<const uint8_t*>(blocks + blockCount(header->states));
+    }
+    return true;
+  }
+
+  void close() {
+    if (mapped) {
+      munmap(const_cast<uint8_t*>(mapped), mappedSize);
+      mapped = nullptr;
+      mappedSize = 0;
+    }
+    header = nullptr;
+    table = nullptr;
+    symmetry = nullptr;
+  }
+
+  bool isOpen() const {
+    return table != nullptr;
+  }
+
+  // table built for state's type and dimensions
+  bool covers(const BoardState& state) const {
+    return table && state.type == shape.type && state.rows == shape.rows && state.columns == shape.columns;
+  }
+
+  int distance(const BoardState& state) const {
+    if (!symmetry) {
+      return table[PermRank::rank(state)];
+    }
+    const uint64_t rank = symmetry->canonicalRank(state);
+    const uint64_t word = rank / 64;
+    const uint64_t bit = uint64_t(1) << (rank % 64);
+    if (!(bitmap[word] & bit)) {
+      return UNREACHED;
+    }
+    uint64_t index = blocks[rank / BLOCK_BITS] + __builtin_popcountll(bitmap[word] & (bit - 1));
+    for (uint64_t w = rank / BLOCK_BITS * (BLOCK_BITS / 64); w < word; ++w) {
+      index += __builtin_popcountll(bitmap[w]);
+    }
+    return table[index];
+  }
+
+  bool isSymmetric() const {
+    return symmetry != nullptr;
+  }
+
+  // bytes of distances and index mapped for lookups
+  uint64_t tableBytes() const {
+    return tableBytes(*header);
+  }
+
+  int maxDistance() const {
+    return header->maxDistance;
+  }
+
+  uint64_t count(int distance) const {
+    return header->counts[distance];
+  }
+
+  // false when state is solved or unreachable
+  bool hint(const BoardState& state, Move& move) const {
+    const int d = distance(state);
+    if (d == 0 || d == UNREACHED) {
+      return false;
+    }
+    std::array<Move, 64> moves;
+    const int moveCount = MoveGenerator::generate(state, moves.data());
+    BoardState next = state;
+    for (int i = 0; i < moveCount; ++i) {
+      MoveGenerator::apply(next, moves[i]);
+      const int nextDistance = distance(next);
+      MoveGenerator::unapply(next, moves[i]);
+      if (nextDistance == d - 1) {
+        move = moves[i];
+        return true;
+      }
+    }
+    return false;
+  }
+
+private:
+  static bool fail([[maybe_unused]] const char* reason, [[maybe_unused]] const std::string& path) {
+#ifdef USE_SDL
+    constexpr static Logger L = Logger::getLogger();
+    L.error("DistanceTable", reason, path);
+#endif
+    return false;
+  }
+
+  const uint8_t* mapped = nullptr;
+  size_t mappedSize = 0;
+  const DistanceTableHeader* header = nullptr;
+  const uint8_t* table = nullptr;
+  BoardState shape;
+  // symmetric tables only
+  const BoardSymmetry* symmetry = nullptr;
+  const uint64_t* bitmap = nullptr;
+  const uint64_t* blocks = nullptr;
+};
+
+/*
+ * Disk backed breadth first search over every position of a slider or
+ * roller board of at most 12 slots (3x4), for exact distance distributions and
+ * perfect hint tables of boards whose state space does not fit a hash set.
+ *
+ * Positions are lexicographic ranks. Each layer is a sorted rank file in
+ * dir. Expanding layer d streams it, buffers the ranks of all neighbors,
+ * and spills every runStates of them as a sorted, deduplicated run file.
+ * A k-way merge of the runs then drops duplicates and anything in layers d
+ * and d - 1, the only earlier layers a neighbor can be in, and writes layer
+ * d + 1. All file access is sequential; memory is the run buffer plus one
+ * read buffer per run.
+ *
+ * checkpoint.json records the last complete layer and is replaced
+ * atomically after it, so run() resumes after an interruption by redoing at
+ * most one layer. Once the search is exhausted the layers are merged by rank
+ * into distances.bin, a DistanceTable, and removed.
+ */
+struct ExternalBfs {
+  static constexpr size_t DEFAULT_RUN_STATES = 8 << 20;
+  // distances.bin has a byte per rank, n! of them, so 4x4 boards would take 20 TB
+  static constexpr int MAX_SLOTS = 12;
+
+  ExternalBfs(const BoardState& shape, const std::string& dir, size_t runStates = DEFAULT_RUN_STATES)
+      : shape(shape), dir(dir), runStates(runStates) {
+  }
+
+  /*
+   * Expands at most maxLayers layers; false on an I/O error, an unsupported
+   * board or a checkpoint of another board. done tells whether the search
+   * finished and distances.bin is written.
+   */
+  bool run(int maxLayers = std::numeric_limits<int>::max()) {
+    if (shape.type == PuzzleType::HexSpinPuzzle || shape.size() > MAX_SLOTS) {
+      return fail("unsupported board", dir);
+    }
+    std::error_code error;
+    std::filesystem::create_directories(dir, error);
+    if (!std::filesystem::exists(checkpointPath(), error)) {
+      if (!start()) {
+        return false;
+      }
+    } else if (!loadCheckpoint()) {
+      return fail("damaged or foreign checkpoint in", dir);
+    }
+    for (int layer = 0; layer < maxLayers && !finished; ++layer) {
+      if (!expand()) {
+        return false;
+      }
+    }
+    if (finished && !done) {
+      if (!writeDistances()) {
+        return false;
+      }
+      done = true;
+      if (!saveCheckpoint()) {
+        return false;
+      }
+      for (int d = 0; d < counts.size(); ++d) {
+        std::filesystem::remove(layerPath(d), error);
+      }
+    }
+    return true;
+  }
+
+  std::string distancesPath() const {
+    return dir + "/distances.bin";
+  }
+
+  // positions per distance found so far; its size - 1 is God's number once done
+  std::vector<uint64_t> counts;
+  bool done = false;
+  // write distances.bin with one entry per BoardSymmetry class
+  bool symmetric = false;
+
+private:
+  std::string layerPath(int depth) const {
+    char name[32];
+    std::snprintf(name, sizeof(name), "/layer-%03d.bin", depth);
+    return dir + name;
+  }
+
+  std::string runPath(int run) const {
+    char name[32];
+    std::snprintf(name, sizeof(name), "/run-%05d.bin", run);
+    return dir + name;
+  }
+
+  std::string checkpointPath() const {
+    return dir + "/checkpoint.json";
+  }
+
+  static int typeCode(PuzzleType type) {
+    return int(type);
+  }
+
+  bool start() {
+    counts.clear();
+    finished = done = false;
+    RankFileWriter writer;
+    if (!writer.open(layerPath(0))) {
+      return fail("cannot write", layerPath(0));
+    }
+    writer.put(PermRank::rank(shape));
+    if (!writer.close()) {
+      return fail("cannot write", layerPath(0));
+    }
+    counts.push_back(1);
+    return saveCheckpoint();
+  }
+
+  bool loadCheckpoint() {
+    std::ifstream input(checkpointPath());
+    const json checkpoint = json::parse(input, nullptr, false);
+    // value() throws on a field of the wrong type, so check the types first
+    auto integer = [&](const char* key) {
+      return checkpoint.contains(key) && checkpoint[key].is_number_integer() ? checkpoint[key].get<int>() : -1;
+    };
+    auto flag = [&](const char* key) {
+      return checkpoint.contains(key) && checkpoint[key].is_boolean() && checkpoint[key].get<bool>();
+    };
+    if (!checkpoint.is_object() || integer("type") != typeCode(shape.type) || integer("rows") != shape.rows ||
+        integer("columns") != shape.columns || !checkpoint.contains("counts") || !checkpoint["counts"].is_array()) {
+      return false;
+    }
+    const json& stored = checkpoint["counts"];
+    if (!std::all_of(stored.begin(), stored.end(), [](const json& count) { return count.is_number_unsigned(); })) {
+      return false;
+    }
+    counts = stored.get<std::vector<uint64_t>>();
+    finished = flag("finished");
+    done = flag("done");
+    return !counts.empty();
+  }
+
+  bool saveCheckpoint() const {
+    json checkpoint;
+    checkpoint["type"] = typeCode(shape.type);
+    checkpoint["rows"] = shape.rows;
+    checkpoint["columns"] = shape.columns;
+    checkpoint["counts"] = counts;
+    checkpoint["finished"] = finished;
+    checkpoint["done"] = done;
+    const std::string temp = checkpointPath() + ".tmp";
+    {
+      std::ofstream output(temp, std::ios::trunc);
+      output << checkpoint.dump();
+      if (!output.flush()) {
+        return fail("cannot write", temp);
+      }
+    }
+    std::error_code error;
+    std::filesystem::rename(temp, checkpointPath(), error);
+    return !error || fail("cannot write", checkpointPath());
+  }
+
+  // writes layer counts.size() from the last one
+  bool expand() {
+    const int depth = counts.size() - 1;
+    int runs = 0;
+    if (!writeRuns(depth, runs)) {
+      return false;
+    }
+    const std::string temp = layerPath(depth + 1) + ".tmp";
+    RankFileWriter writer;
+    bool ok = writer.open(temp) && mergeRuns(depth, runs, writer);
+    if (!writer.close() || !ok) {
+      return fail("cannot write", temp);
+    }
+    std::error_code error;
+    for (int r = 0; r < runs; ++r) {
+      std::filesystem::remove(runPath(r), error);
+    }
+    if (writer.written == 0) {
+      std::filesystem::remove(temp, error);
+      finished = true;
+    } else {
+      std::filesystem::rename(temp, layerPath(depth + 1), error);
+      if (error) {
+        return fail("cannot write", layerPath(depth + 1));
+      }
+      counts.push_back(writer.written);
+    }
+    return saveCheckpoint();
+  }
+
+  bool writeRuns(int depth, int& runs) {
+    RankFileReader reader;
+    if (!reader.open(layerPath(depth))) {
+      return fail("cannot read", layerPath(depth));
+    }
+    std::vector<uint64_t> buffer;
+    buffer.reserve(runStates + 64);
+    BoardState state = shape;
+    std::array<Move, 64> moves;
+    uint64_t rank;
+    while (reader.next(rank)) {
+      unrank(rank, state);
+      const int moveCount = MoveGenerator::generate(state, moves.data());
+      for (int i = 0; i < moveCount; ++i) {
+        MoveGenerator::apply(state, moves[i]);
+        buffer.push_back(PermRank::rank(state));
+        MoveGenerator::unapply(state, moves[i]);
+      }
+      if (buffer.size() >= runStates && !spill(buffer, runs)) {
+        return false;
+      }
+    }
+    return buffer.empty() || spill(buffer, runs);
+  }
+
+  bool spill(std::vector<uint64_t>& buffer, int& runs) {
+    std::sort(buffer.begin(), buffer.end());
+    buffer.erase(std::unique(buffer.begin(), buffer.end()), buffer.end());
+    RankFileWriter writer;
+    const std::string path = runPath(runs++);
+    if (!writer.open(path)) {
+      return fail("cannot write", path);
+    }
+    for (uint64_t rank : buffer) {
+      writer.put(rank);
+    }
+    buffer.clear();
+    return writer.close() || fail("cannot write", path);
+  }
+
+  bool mergeRuns(int depth, int runs, RankFileWriter& writer) {
+    std::vector<RankFileReader> readers(runs);
+    using Head = std::pair<uint64_t, int>;
+    std::priority_queue<Head, std::vector<Head>, std::greater<Head>> heads;
+    for (int r = 0; r < runs; ++r) {
+      uint64_t rank;
+      if (!readers[r].open(runPath(r))) {
+        return fail("cannot read", runPath(r));
+      }
+      if (readers[r].next(rank)) {
+        heads.emplace(rank, r);
+      }
+    }
+    // neighbors of layer d are in layer d - 1, d or d + 1
+    SortedFilter current(layerPath(depth));
+    SortedFilter previous(depth > 0 ? layerPath(depth - 1) : "");
+    uint64_t last = std::numeric_limits<uint64_t>::max();
+    while (!heads.empty()) {
+      const auto [rank, r] = heads.top();
+      heads.pop();
+      uint64_t next;
+      if (readers[r].next(next)) {
+        heads.emplace(next, r);
+      }
+      if (rank == last) {
+        continue;
+      }
+      last = rank;
+      if (!current.contains(rank) && !previous.contains(rank)) {
+        writer.put(rank);
+      }
+    }
+    return true;
+  }
+
+  // membership test for ascending queries against a sorted rank file
+  struct SortedFilter {
+    SortedFilter(const std::string& path) {
+      valid = !path.empty() && reader.open(path) && reader.next(head);
+    }
+
+    bool contains(uint64_t rank) {
+      while (valid && head < rank) {
+        valid = reader.next(head);
+      }
+      return valid && head == rank;
+    }
+
+    RankFileReader reader;
+    uint64_t head = 0;
+    bool valid = false;
+  };
+
+  // k-way merge of the layers by rank into one distance byte per rank
+  bool writeDistances() {
+    const std::string temp = distancesPath() + ".tmp";
+    FILE* file = std::fopen(temp.c_str(), "wb");
+    if (!file) {
+      return fail("cannot write", temp);
+    }
+    DistanceTableHeader header = {};
+    std::memcpy(header.magic, DistanceTable::MAGIC, sizeof(DistanceTable::MAGIC));
+    header.version = DistanceTable::VERSION;
+    header.type = typeCode(shape.type);
+    header.rows = shape.rows;
+    header.columns = shape.columns;
+    header.maxDistance = counts.size() - 1;
+    header.states = PermRank::factorial(shape.size());
+    header.symmetric = symmetric;
+    for (int d = 0; d < counts.size(); ++d) {
+      header.reachable += counts[d];
+      header.counts[d] = counts[d];
+    }
+    // a symmetric table's bitmap and block counts go in front of the distances once they are known
+    std::vector<uint64_t> bitmap(symmetric ? DistanceTable::bitmapWords(header.states) : 0);
+    std::vector<uint64_t> blocks(symmetric ? DistanceTable::blockCount(header.states) : 0);
+    const BoardSymmetry& symmetry = BoardSymmetry::get(shape);
+    BoardState state = shape;
+    bool ok = std::fseek(file, DistanceTable::PAGE_ALIGN + (bitmap.size() + blocks.size()) * 8, SEEK_SET) == 0;
+
+    std::vector<RankFileReader> readers(counts.size());
+    using Head = std::pair<uint64_t, int>;
+    std::priority_queue<Head, std::vector<Head>, std::greater<Head>> heads;
+    for (int d = 0; d < counts.size(); ++d) {
+      uint64_t rank;
+      ok = ok && readers[d].open(layerPath(d));
+      if (ok && readers[d].next(rank)) {
+        heads.emplace(rank, d);
+      }
+    }
+    std::vector<uint8_t> block;
+    block.reserve(RankFileWriter::BUFFER);
+    for (uint64_t rank = 0; ok && rank < header.states; ++rank) {
+      uint8_t distance = DistanceTable::UNREACHED;
+      if (!heads.empty() && heads.top().first == rank) {
+        const int d = heads.top().second;
+        heads.pop();
+        distance = d;
+        uint64_t next;
+        if (readers[d].next(next)) {
+          heads.emplace(next, d);
+        }
+      }
+      if (symmetric) {
+        if (rank % DistanceTable::BLOCK_BITS == 0) {
+          blocks[rank / DistanceTable::BLOCK_BITS] = header.stored;
+        }
+        if (distance == DistanceTable::UNREACHED) {
+          continue;
+        }
+        unrank(rank, state);
+        if (symmetry.canonicalRank(state) != rank) {
+          continue;
+        }
+        bitmap[rank / 64] |= uint64_t(1) << (rank % 64);
+      }
+      ++header.stored;
+      block.push_back(distance);
+      if (block.size() == RankFileWriter::BUFFER) {
+        ok = std::fwrite(block.data(), 1, block.size(), file) == block.size();
+        block.clear();
+      }
+    }
+    ok = ok && std::fwrite(block.data(), 1, block.size(), file) == block.size();
+    std::vector<uint8_t> page(DistanceTable::PAGE_ALIGN, 0);
+    std::memcpy(page.data(), &header, sizeof(header));
+    ok = ok && std::fseek(file, 0, SEEK_SET) == 0 && std::fwrite(page.data(), 1, page.size(), file) == page.size();
+    ok = ok && std::fwrite(bitmap.data(), 8, bitmap.size(), file) == bitmap.size();
+    ok = ok && std::fwrite(blocks.data(), 8, blocks.size(), file) == blocks.size();
+    ok = std::fclose(file) == 0 && ok;
+    std::error_code error;
+    if (ok) {
+      std::filesystem::rename(temp, distancesPath(), error);
+    }
+    return (ok && !error) || fail("cannot write", distancesPath());
+  }
+
+  void unrank(uint64_t rank, BoardState& state) const {
+    PermRank::lexUnrank(rank, state.size(), state.slots.data());
+    if (state.type == PuzzleType::SliderPuzzle) {
+      state.blank = state.slotOf(state.blankTile());
+    }
+  }
+
+  static bool fail([[maybe_unused]] const char* reason, [[maybe_unused]] const std::string& path) {
+#ifdef USE_SDL
+    constexpr static Logger L = Logger::getLogger();
+    L.error("ExternalBfs", reason, path);
+#endif
+    return false;
+  }
+
+  BoardState shape;
+  std::string dir;
+  size_t runStates;
+  // the last layer expanded to nothing
+  bool finished = false;
+};
+
+} // namespace tilepuzzles
+#endif
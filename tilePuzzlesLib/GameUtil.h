@@ -39,6 +39,14 @@ struct GameUtil {
     }
   }
 
+  template <typename S>
+  static void shuffleSlots(S& state) {
+    int n = state.size();
+    for (int i = n - 1; i >= 1; --i) {
+      state.swapSlots(i, trand(0, i));
+    }
+  }
+
   static constexpr float LOW_X = -1.F;
   static constexpr float HIGH_X = 1.F;
   static constexpr float LOW_Y = -1.F;
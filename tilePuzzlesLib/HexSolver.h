@@ -0,0 +1,470 @@
+#ifndef _HEX_SOLVER_H_
+#define _HEX_SOLVER_H_
+
+#include "BoardState.h"
+#include "HexTopology.h"
+#include "MoveGenerator.h"
+#include "SliderSolver.h"
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <utility>
+#include <vector>
+
+namespace tilepuzzles {
+
+/*
+ * Moves and macro-operators of a hex spin board as slot permutations.
+ * Entries are the board's own moves followed by every commutator
+ * X Y X' Y' of one or two moves X and one move Y that only moves
+ * MAX_SUPPORT slots, the shortest one kept per distinct effect.
+ *
+ * The hex commutators come out as double transpositions (a b)(c d) and
+ * 5-cycles, no 3-cycles. Two double transpositions sharing (a b) and one
+ * of c, d make a 3-cycle; conjugating those by single moves, cheapest
+ * first, gives a macro for every 3-cycle of slots, kept as a parent tree
+ * over all slot triples. Built once per board size and shared, like
+ * HexTopology.
+ */
+struct HexMacroTable {
+  static constexpr int MAX_SUPPORT = 5;
+
+  struct Entry {
+    std::vector<Move> moves;
+    // content of slot from[i] moves to slot to[i]
+    std::vector<uint8_t> from;
+    std::vector<uint8_t> to;
+  };
+
+  HexMacroTable(int rows, int columns) : topology(HexTopology::get(rows, columns)) {
+    slotCount = topology.slotCount();
+    initMoves(BoardState::hexSpinner(rows, columns));
+    initCommutators();
+    initCycles();
+  }
+
+  static const HexMacroTable& get(int rows, int columns) {
+    static std::mutex mutex;
+    static std::map<std::pair<int, int>, std::unique_ptr<HexMacroTable>> cache;
+    std::lock_guard<std::mutex> lock(mutex);
+    auto& table = cache[{rows, columns}];
+    if (!table) {
+      table.reset(new HexMacroTable(rows, columns));
+    }
+    return *table;
+  }
+
+  // the same index for the three rotations of a cycle
+  int cycleIndex(int a, int b, int c) const {
+    if (b < a && b < c) {
+      return cycleIndex(b, c, a);
+    }
+    if (c < a && c < b) {
+      return cycleIndex(c, a, b);
+    }
+    return (a * slotCount + b) * slotCount + c;
+  }
+
+  // moves of the 3-cycle a -> b -> c -> a, empty if the table has none
+  std::vector<Move> cycle(int a, int b, int c) const {
+    std::vector<Move> setup;
+    int triple = cycleIndex(a, b, c);
+    if (!cycles[triple].cost) {
+      return {};
+    }
+    for (; cycles[triple].parent >= 0; triple = cycles[triple].parent) {
+      setup.push_back(entries[cycles[triple].move].moves[0]);
+    }
+    std::vector<Move> moves;
+    for (Move move : setup) {
+      moves.push_back(MoveGenerator::inverse(move));
+    }
+    for (int e : seeds[-1 - cycles[triple].parent]) {
+      moves.insert(moves.end(), entries[e].moves.begin(), entries[e].moves.end());
+    }
+    moves.insert(moves.end(), setup.rbegin(), setup.rend());
+    return moves;
+  }
+
+  int cycleLength(int a, int b, int c) const {
+    return cycles[cycleIndex(a, b, c)].cost;
+  }
+
+  const HexTopology& topology;
+  int slotCount = 0;
+  // entries[0, moveCount) are single moves
+  int moveCount = 0;
+  std::vector<Entry> entries;
+
+private:
+  using Perm = std::vector<uint8_t>;
+
+  // how to reach a 3-cycle: conjugate parent by entries[move], or seeds[-1 - parent]
+  struct CycleNode {
+    int parent = 0;
+    uint16_t move = 0;
+    // moves in the macro, 0 when the table has no such cycle
+    uint16_t cost = 0;
+  };
+
+  void initMoves(const BoardState& shape) {
+    std::array<Move, 256> moves;
+    moveCount = MoveGenerator::generate(shape, moves.data());
+    for (int m = 0; m < moveCount; ++m) {
+      BoardState state = shape;
+      MoveGenerator::apply(state, moves[m]);
+      Perm perm(slotCount);
+      for (int s = 0; s < slotCount; ++s) {
+        perm[state.slots[s]] = s;
+      }
+      std::vector<uint8_t> effect;
+      for (int s = 0; s < slotCount; ++s) {
+        if (perm[s] != s) {
+          effect.push_back(s);
+          effect.push_back(perm[s]);
+        }
+      }
+      movePerms.push_back(perm);
+      entries.push_back(entryOf({moves[m]}, effect));
+    }
+    for (int m = 0; m < moveCount; ++m) {
+      const Move back = MoveGenerator::inverse(moves[m]);
+      int inverse = m;
+      for (int i = 0; i < moveCount; ++i) {
+        if (entries[i].moves[0] == back) {
+          inverse = i;
+        }
+      }
+      inverses.push_back(inverse);
+    }
+  }
+
+  void initCommutators() {
+    std::vector<std::vector<int>> sequences;
+    for (int x = 0; x < moveCount; ++x) {
+      sequences.push_back({x});
+      for (int y = 0; y < moveCount; ++y) {
+        if (y != inverses[x]) {
+          sequences.push_back({x, y});
+        }
+      }
+    }
+    // only slots some move of the commutator touches can end up moved
+    std::map<std::vector<uint8_t>, int> byEffect;
+    std::vector<bool> inX(slotCount);
+    std::vector<uint8_t> effect;
+    for (const std::vector<int>& x : sequences) {
+      std::fill(inX.begin(), inX.end(), false);
+      for (int m : x) {
+        for (int s : entries[m].from) {
+          inX[s] = true;
+        }
+      }
+      std::vector<int> commutator = x;
+      for (int y = 0; y < moveCount; ++y) {
+        if (std::none_of(entries[y].from.begin(), entries[y].from.end(), [&inX](int s) { return inX[s]; })) {
+          continue;
+        }
+        commutator.resize(x.size());
+        commutator.push_back(y);
+        for (int i = x.size() - 1; i >= 0; --i) {
+          commutator.push_back(inverses[x[i]]);
+        }
+        commutator.push_back(inverses[y]);
+        effect.clear();
+        for (int s = 0; s < slotCount && effect.size() <= 2 * MAX_SUPPORT; ++s) {
+          if (!inX[s] && movePerms[y][s] == s) {
+            continue;
+          }
+          int slot = s;
+          for (int m : commutator) {
+            slot = movePerms[m][slot];
+          }
+          if (slot != s) {
+            effect.push_back(s);
+            effect.push_back(slot);
+          }
+        }
+        if (effect.empty() || effect.size() > 2 * MAX_SUPPORT) {
+          continue;
+        }
+        auto [iter, added] = byEffect.emplace(effect, entries.size());
+        if (added) {
+          entries.push_back(entryOf(movesOf(commutator), effect));
+        } else if (entries[iter->second].moves.size() > commutator.size()) {
+          entries[iter->second] = entryOf(movesOf(commutator), effect);
+        }
+      }
+    }
+  }
+
+  // 3-cycles (c d e) from (a b)(c d) followed by (a b)(c e), then their conjugates by single moves
+  void initCycles() {
+    std::vector<std::vector<int>> byPair(slotCount * slotCount);
+    for (int e = moveCount; e < entries.size(); ++e) {
+      const Entry& entry = entries[e];
+      if (entry.from.size() == 4 && isInvolution(entry)) {
+        for (int i = 0; i < 4; ++i) {
+          if (entry.from[i] < entry.to[i]) {
+            byPair[entry.from[i] * slotCount + entry.to[i]].push_back(e);
+          }
+        }
+      }
+    }
+    cycles.assign(slotCount * slotCount * slotCount, {});
+    std::vector<std::vector<int>> buckets(1);
+    for (const std::vector<int>& list : byPair) {
+      for (int i = 0; i < list.size(); ++i) {
+        for (int j = 0; j < list.size(); ++j) {
+          if (i == j) {
+            continue;
+          }
+          // first slot of each cycle of the product and where it goes
+          std::vector<std::pair<int, int>> moved;
+          for (int s : entries[list[i]].from) {
+            const int to = follow(entries[list[j]], follow(entries[list[i]], s));
+            if (to != s) {
+              moved.push_back({s, to});
+            }
+          }
+          for (int s : entries[list[j]].from) {
+            if (follow(entries[list[i]], s) == s && follow(entries[list[j]], s) != s) {
+              moved.push_back({s, follow(entries[list[j]], s)});
+            }
+          }
+          if (moved.size() != 3) {
+            continue;
+          }
+          const int cost = entries[list[i]].moves.size() + entries[list[j]].moves.size();
+          const int a = moved[0].first;
+          const int b = moved[0].second;
+          const int c = std::find_if(moved.begin(), moved.end(), [b](auto p) { return p.first == b; })->second;
+          const int triple = cycleIndex(a, b, c);
+          if (cycles[triple].cost && cycles[triple].cost <= cost) {
+            continue;
+          }
+          cycles[triple] = {-1 - int(seeds.size()), 0, uint16_t(cost)};
+          seeds.push_back({list[i], list[j]});
+          buckets.resize(std::max<int>(buckets.size(), cost + 1));
+          buckets[cost].push_back(triple);
+        }
+      }
+    }
+    // cheapest first; conjugating by m costs two moves
+    for (int cost = 0; cost < buckets.size(); ++cost) {
+      for (int i = 0; i < buckets[cost].size(); ++i) {
+        const int triple = buckets[cost][i];
+        if (cycles[triple].cost != cost) {
+          continue;
+        }
+        const int a = triple / (slotCount * slotCount);
+        const int b = triple / slotCount % slotCount;
+        const int c = triple % slotCount;
+        for (int m = 0; m < moveCount; ++m) {
+          const int next = cycleIndex(movePerms[m][a], movePerms[m][b], movePerms[m][c]);
+          if (!cycles[next].cost || cycles[next].cost > cost + 2) {
+            cycles[next] = {triple, uint16_t(m), uint16_t(cost + 2)};
+            buckets.resize(std::max<int>(buckets.size(), cost + 3));
+            buckets[cost + 2].push_back(next);
+          }
+        }
+      }
+      buckets[cost].clear();
+    }
+  }
+
+  static bool isInvolution(const Entry& entry) {
+    for (int i = 0; i < entry.from.size(); ++i) {
+      const int back = std::find(entry.from.begin(), entry.from.end(), entry.to[i]) - entry.from.begin();
+      if (entry.to[back] != entry.from[i]) {
+        return false;
+      }
+    }
+    return true;
+  }
+
+  // where entry moves the content of slot
+  static int follow(const Entry& entry, int slot) {
+    const auto iter = std::find(entry.from.begin(), entry.from.end(), slot);
+    return iter == entry.from.end() ? slot : entry.to[iter - entry.from.begin()];
+  }
+
+  std::vector<Move> movesOf(const std::vector<int>& sequence) const {
+    std::vector<Move> moves;
+    for (int m : sequence) {
+      moves.push_back(entries[m].moves[0]);
+    }
+    return moves;
+  }
+
+  // effect holds moved slot, destination pairs
+  static Entry entryOf(const std::vector<Move>& moves, const std::vector<uint8_t>& effect) {
+    Entry entry;
+    entry.moves = moves;
+    for (int i = 0; i < effect.size(); i += 2) {
+      entry.from.push_back(effect[i]);
+      entry.to.push_back(effect[i + 1]);
+    }
+    return entry;
+  }
+
+  std::vector<Perm> movePerms;
+  std::vector<int> inverses;
+  std::vector<CycleNode> cycles;
+  std::vector<std::array<int, 2>> seeds;
+};
+
+/*
+ * Hex spin solver on color states. Six triangles share each color, so only
+ * the color per slot matters and the search never tracks tile identity.
+ *
+ * The opening greedily applies whichever move or commutator of
+ * HexMacroTable puts the most colors in place per move. Once nothing gains,
+ * the endgame applies 3-cycle macros, each fixing at least one slot, so a
+ * solve always finishes. A 3x3 board takes about a millisecond once the
+ * table for its size is built.
+ */
+struct HexSolver {
+  HexSolver(int rows, int columns) : table(HexMacroTable::get(rows, columns)) {
+    for (int s = 0; s < table.slotCount; ++s) {
+      targets.push_back(table.topology.slotColor(s));
+    }
+  }
+
+  SolveResult solve(const BoardState& start) {
+    auto startTime = std::chrono::steady_clock::now();
+    SolveResult result;
+    colors.resize(table.slotCount);
+    for (int s = 0; s < table.slotCount; ++s) {
+      colors[s] = table.topology.slotColor(start.slots[s]);
+    }
+    int wrong = wrongCount();
+    while (wrong > 0) {
+      const int gained = greedyStep(result);
+      if (gained <= 0 && !cycleStep(result)) {
+        break;
+      }
+      wrong = wrongCount();
+    }
+    result.solved = wrong == 0;
+    result.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - startTime).count();
+    return result;
+  }
+
+  // first move of a solution; false when start is solved or no solution was found
+  bool hint(const BoardState& start, Move& move) {
+    SolveResult result = solve(start);
+    if (!result.solved || result.moves.empty()) {
+      return false;
+    }
+    move = result.moves[0];
+    return true;
+  }
+
+  const HexMacroTable& table;
+
+private:
+  int wrongCount() const {
+    int wrong = 0;
+    for (int s = 0; s < table.slotCount; ++s) {
+      wrong += colors[s] != targets[s];
+    }
+    return wrong;
+  }
+
+  int gain(const HexMacroTable::Entry& entry) const {
+    int gain = 0;
+    for (int i = 0; i < entry.from.size(); ++i) {
+      const uint8_t color = colors[entry.from[i]];
+      gain += (color == targets[entry.to[i]]) - (color == targets[entry.from[i]]);
+    }
+    return gain;
+  }
+
+  void apply(const HexMacroTable::Entry& entry, SolveResult& result) {
+    moved.resize(entry.from.size());
+    for (int i = 0; i < entry.from.size(); ++i) {
+      moved[i] = colors[entry.from[i]];
+    }
+    for (int i = 0; i < entry.to.size(); ++i) {
+      colors[entry.to[i]] = moved[i];
+    }
+    result.moves.insert(result.moves.end(), entry.moves.begin(), entry.moves.end());
+    result.nodes += entry.moves.size();
+  }
+
+  // applies the entry with the best gain per move, returns its gain
+  int greedyStep(SolveResult& result) {
+    int best = -1;
+    int bestGain = 0;
+    for (int e = 0; e < table.entries.size(); ++e) {
+      const int g = gain(table.entries[e]);
+      // g / size > bestGain / bestSize without dividing
+      if (g > 0 && (best < 0 || g * table.entries[best].moves.size() > bestGain * table.entries[e].moves.size())) {
+        best = e;
+        bestGain = g;
+      }
+    }
+    if (best >= 0) {
+      apply(table.entries[best], result);
+    }
+    return bestGain;
+  }
+
+  /*
+   * Applies the 3-cycle t -> a -> u -> t with the best gain per move where a
+   * is wrong and t holds a's color. One always gains: with only a and t
+   * wrong, u is a solved slot of t's color.
+   */
+  bool cycleStep(SolveResult& result) {
+    int bestLength = 0;
+    int bestGain = 0;
+    std::array<int, 3> best;
+    for (int a = 0; a < table.slotCount; ++a) {
+      if (colors[a] == targets[a]) {
+        continue;
+      }
+      for (int t = 0; t < table.slotCount; ++t) {
+        if (t == a || colors[t] != targets[a]) {
+          continue;
+        }
+        for (int u = 0; u < table.slotCount; ++u) {
+          const int length = u == a || u == t ? 0 : table.cycleLength(t, a, u);
+          if (length == 0) {
+            continue;
+          }
+          const int g = 1 - (colors[t] == targets[t]) + (colors[a] == targets[u]) + (colors[u] == targets[t]) -
+                        (colors[u] == targets[u]);
+          if (g > 0 && (bestLength == 0 || g * bestLength > bestGain * length)) {
+            best = {t, a, u};
+            bestLength = length;
+            bestGain = g;
+          }
+        }
+      }
+    }
+    if (bestLength == 0) {
+      return false;
+    }
+    const std::vector<Move> moves = table.cycle(best[0], best[1], best[2]);
+    const uint8_t moved = colors[best[2]];
+    colors[best[2]] = colors[best[1]];
+    colors[best[1]] = colors[best[0]];
+    colors[best[0]] = moved;
+    result.moves.insert(result.moves.end(), moves.begin(), moves.end());
+    result.nodes += moves.size();
+    return true;
+  }
+
+  std::vector<uint8_t> targets;
+  std::vector<uint8_t> colors;
+  std::vector<uint8_t> moved;
+};
+
+} // namespace tilepuzzles
+#endif
@@ -9,6 +9,7 @@
 #include "GameUtil.h"
 #include "GeoUtil.h"
 #include "HexTile.h"
+#include "HexTopology.h"
 #include "Mesh.h"
 #include "TVertexBuffer.h"
 #include "Vertex.h"
@@ -80,6 +81,7 @@ struct HexSpinMesh : Mesh<TriangleVertexBuffer, HexTile> {
   }
 
   virtual void processAnchorGroups() {
+    syncTiles();
     collectAnchors();
     orderAnchorGroups();
   }
@@ -99,6 +101,7 @@ struct HexSpinMesh : Mesh<TriangleVertexBuffer, HexTile> {
         addAnchor(point, r, c);
       }
     }
+    indexTileGroups();
   }
 
   virtual void addAnchor(const math::float2& point, int row, int col) {
@@ -134,53 +137,47 @@ struct HexSpinMesh : Mesh<TriangleVertexBuffer, HexTile> {
     int dragable = 0;
     for (auto& group : tileGroupAnchors) {
       if (group.dragable) {
-        std::vector<HexTile> tileGroup = std::vector<HexTile>();
         math::float2 pt = group.anchorPoint;
 
-        // top half
-        float yCoord = pt.y + size.y * .5;
-        math::float3 tileCenter = {pt.x - size.x * .5, yCoord, 0.};
-        HexTile* tile = hitTest(tileCenter);
-        if (tile) {
-          tileGroup.push_back(*tile);
-        }
-
-        tileCenter = {pt.x, yCoord, 0.};
-        tile = hitTest(tileCenter);
-        if (tile) {
-          tileGroup.push_back(*tile);
-        }
-
-        tileCenter = {pt.x + size.x * .5, yCoord, 0.};
-        tile = hitTest(tileCenter);
-        if (tile) {
-          tileGroup.push_back(*tile);
-        }
-
-        // bottom half
-        yCoord = pt.y - size.y * .5;
-        tileCenter = {pt.x - size.x * .5, yCoord, 0.};
-        tile = hitTest(tileCenter);
-        if (tile) {
-          tileGroup.push_back(*tile);
-        }
-
-        tileCenter = {pt.x, yCoord, 0.};
-        tile = hitTest(tileCenter);
-        if (tile) {
-          tileGroup.push_back(*tile);
-        }
-
-        tileCenter = {pt.x + size.x * .5, yCoord, 0.};
-        tile = hitTest(tileCenter);
-        if (tile) {
-          tileGroup.push_back(*tile);
+        // top half, then bottom half, left to right
+        const float top = pt.y + size.y * .5;
+        const float bottom = pt.y - size.y * .5;
+        const math::float2 tileCenters[] = {{pt.x - size.x * .5F, top},    {pt.x, top},    {pt.x + size.x * .5F, top},
+                                            {pt.x - size.x * .5F, bottom}, {pt.x, bottom}, {pt.x + size.x * .5F, bottom}};
+        HexTile* hits[6];
+        hitTestPoints(tileCenters, 6, hits);
+        std::vector<HexTile> tileGroup = std::vector<HexTile>();
+        for (HexTile* tile : hits) {
+          if (tile) {
+            tileGroup.push_back(*tile);
+          }
         }
         group.tileGroup = tileGroup;
       }
     }
   }
 
+  virtual Point slotTopLeft(const HexTile& tile, int row, int column) {
+    return {GameUtil::LOW_X + column * tile.size.x * .5F, GameUtil::HIGH_Y - row * tile.size.y};
+  }
+
+  /*
+   * Cells follow the triangle lattice: half a triangle wide and one
+   * triangle tall, with one more row and column for the shifted column
+   * groups and the last half triangle, so a cell overlaps at most four
+   * triangles of the solved layout.
+   */
+  virtual void resetTileGrid() {
+    const int rows = configMgr.config["dimension"]["rows"].get<int>();
+    const int columns = configMgr.config["dimension"]["columns"].get<int>();
+    const HexTopology& topology = HexTopology::get(rows, columns);
+    const int gridRows = topology.slotRows + 1;
+    const int gridColumns = topology.slotColumns + 1;
+    tileGrid.reset(GameUtil::LOW_X, GameUtil::HIGH_Y - gridRows * topology.triHeight,
+                   GameUtil::LOW_X + gridColumns * topology.triWidth * .5F, GameUtil::HIGH_Y, gridColumns,
+                   gridRows);
+  }
+
   void addTile(const HexTile& tile) {
     tiles.push_back(tile);
   }
@@ -239,7 +236,12 @@ struct HexSpinMesh : Mesh<TriangleVertexBuffer, HexTile> {
   virtual void rotateTileGroup(TileGroup<HexTile>& tileGroup, float angle) {
     math::float2 pt = tileGroup.anchorPoint;
     std::for_each(tileGroup.tileGroup.begin(), tileGroup.tileGroup.end(),
-                  [this, angle, &pt](HexTile& t) { t.rotateAtAnchor(pt, angle); });
+                  [this, angle, &pt](HexTile& t) {
+                    t.rotateAtAnchor(pt, angle);
+                    if (!hitGridStale) {
+                      indexTileBounds(t.tileNum - 1);
+                    }
+                  });
   }
 
   virtual void setTileGroupZCoord(TileGroup<HexTile>& tileGroup, float zCoord) {
@@ -247,15 +249,37 @@ struct HexSpinMesh : Mesh<TriangleVertexBuffer, HexTile> {
                   [zCoord](HexTile& t) { t.setVertexZCoord(zCoord); });
   }
 
+  virtual void commitRotation(const TileGroup<HexTile>& tileGroup, float angle) {
+    int anchor = state.topology->anchorAt(tileGroup.anchorPoint.x, tileGroup.anchorPoint.y);
+    if (anchor >= 0) {
+      state.rotateAnchor(anchor, std::lround(angle / GeoUtil::PI_3));
+    }
+    tilesDirty = true;
+  }
+
+  virtual void applyMove(Move move) {
+    Mesh::applyMove(move);
+    processAnchorGroups();
+  }
+
   virtual void shuffle() {
-    int anchCount = tileGroupAnchors.size();
+    int anchCount = state.topology->anchors.size();
     for (int i = 0; i < HexSpinMesh::SHUFFLE_PASSES; ++i) {
-      float angle = GameUtil::coinFlip() ? GeoUtil::PI_3 : -GeoUtil::PI_3;
+      int steps = GameUtil::coinFlip() ? 1 : -1;
       int anchIndex = GameUtil::trand(0, anchCount);
-      auto anchor = tileGroupAnchors[anchIndex];
-      rotateTileGroup(anchor, angle);
-      processAnchorGroups();
+      state.rotateAnchor(anchIndex, steps);
     }
+    tilesDirty = true;
+    processAnchorGroups();
+  }
+
+  virtual void shuffleTo(const BoardState& shuffled) {
+    Mesh::shuffleTo(shuffled);
+    processAnchorGroups();
+  }
+
+  virtual int maxShuffleMoves() const {
+    return HexSpinMesh::SHUFFLE_PASSES;
   }
 
   std::vector<TileGroup<HexTile>*> tileGroupsToRoll(const TileGroup<HexTile>& groupPick, Direction dir) {
@@ -285,22 +309,8 @@ struct HexSpinMesh : Mesh<TriangleVertexBuffer, HexTile> {
   }
 
   virtual void rollTileGroups(const TileGroup<HexTile>& tileGroup, Direction dir) {
-    std::vector<TileGroup<HexTile>*> rollerGroups = tileGroupsToRoll(tileGroup, dir);
-
-    std::vector<TileDto> grp0;
-    if (dir == Direction::down || dir == Direction::right) {
-      grp0 = cloneTileGroup(*rollerGroups[0]);
-      for (int i = 0; i < rollerGroups.size() - 1; ++i) {
-        assignTileGroup(*rollerGroups[i + 1], *rollerGroups[i]);
-      }
-      assignTileGroup(grp0, *rollerGroups[rollerGroups.size() - 1]);
-    } else {
-      grp0 = cloneTileGroup(*rollerGroups[rollerGroups.size() - 1]);
-      for (int i = rollerGroups.size() - 2; i >= 0; --i) {
-        assignTileGroup(*rollerGroups[i], *rollerGroups[i + 1]);
-      }
-      assignTileGroup(grp0, *rollerGroups[0]);
-    }
+    state.rollGroups(tileGroup.gridCoord.x, tileGroup.gridCoord.y, dir);
+    tilesDirty = true;
     processAnchorGroups();
   }
 
@@ -322,6 +332,7 @@ struct HexSpinMesh : Mesh<TriangleVertexBuffer, HexTile> {
         translateTileGroup(g->tileGroup, dir);
       }
     });
+    hitGridStale = true;
     processAnchorGroups();
   }
 
@@ -45,9 +45,7 @@ struct HexSpinRenderer : TRenderer<TriangleVertexBuffer, HexTile> {
   virtual HexTile* onRightMouseDown(const float2& viewCoord) {
     math::float3 clipCoord = normalizeViewCoord(viewCoord);
     if (!readOnly) {
-      mesh->shuffle();
-      mesh->processAnchorGroups();
-      needsDraw = true;
+      shuffle();
     }
     HexTile* tile = mesh->hitTest(clipCoord);
     return tile;
@@ -147,6 +145,10 @@ struct HexSpinRenderer : TRenderer<TriangleVertexBuffer, HexTile> {
         snapToPosition();
         needsDraw = true;
       }
+      if (dragAction == DragAction::TileDrag) {
+        mesh->commitRotation(dragAnchor, rotationAngle + angle);
+        needsDraw = true;
+      }
       rotationAngle = 0.f;
       dragTile = nullptr;
       dragAction = DragAction::noDrag;
@@ -201,31 +201,24 @@ struct HexTile : Tile {
       (*triangleVertices)[2].position.z = zCoord;
   }
 
-  /* A utility function to calculate area of triangle formed by (x1, y1),
-  (x2, y2) and (x3, y3) */
-  float area(const math::float3& v1, const math::float3& v2, const math::float3& v3) const {
-    return abs((v1[0] * (v2[1] - v3[1]) + v2[0] * (v3[1] - v1[1]) + v3[0] * (v1[1] - v2[1])) / 2.0);
-  }
-
   /* A function to check whether point P(x, y) lies inside the triangle formed
-  by A(x1, y1), B(x2, y2) and C(x3, y3) */
+  by A(x1, y1), B(x2, y2) and C(x3, y3), allowing the areas of PBC, PAC and
+  PAB to add up to EPS more than ABC's; see TriangleEdges */
   bool isInside(const math::float3& v1, const math::float3& v2, const math::float3& v3,
                 const math::float3& p) const {
-    /* Calculate area of triangle ABC */
-    float A = area(v1, v2, v3);
-
-    /* Calculate area of triangle PBC */
-    float A1 = area(p, v2, v3);
+    return TriangleEdges::of(v1, v2, v3).contains(p[0], p[1], EPS);
+  }
 
-    /* Calculate area of triangle PAC */
-    float A2 = area(v1, p, v3);
+  using HitBatch = TriangleBatch;
 
-    /* Calculate area of triangle PAB */
-    float A3 = area(v1, v2, p);
+  // stores the shape onClick tests as entry i of a batch; test it with firstHit(x, y, EPS)
+  void storeHitShape(HitBatch& batch, int i) const {
+    batch.set(i, TriangleEdges::of((*triangleVertices)[0].position, (*triangleVertices)[1].position,
+                                   (*triangleVertices)[2].position));
+  }
 
-    /* Check if sum of A1, A2 and A3 is same as A */
-    // return (A == A1 + A2 + A3);
-    return abs(A - (A1 + A2 + A3)) <= EPS;
+  static int firstHit(const HitBatch& batch, const math::float2& point) {
+    return batch.firstHit(point.x, point.y, EPS);
   }
 
   virtual bool onClick(const math::float2& coord) const {
@@ -234,6 +227,19 @@ struct HexTile : Tile {
                     (*triangleVertices)[2].position, p3);
   }
 
+  /*
+   * isInside lets the areas miss by EPS, which accepts points up to about
+   * EPS / size.x outside each edge, so the box is padded by twice that.
+   */
+  virtual math::float4 bounds() const {
+    const math::float3& v0 = (*triangleVertices)[0].position;
+    const math::float3& v1 = (*triangleVertices)[1].position;
+    const math::float3& v2 = (*triangleVertices)[2].position;
+    const float pad = 2.F * EPS / size.x;
+    return {std::min({v0.x, v1.x, v2.x}) - pad, std::min({v0.y, v1.y, v2.y}) - pad,
+            std::max({v0.x, v1.x, v2.x}) + pad, std::max({v0.y, v1.y, v2.y}) + pad};
+  }
+
   virtual void logVertices() const {
 #ifdef USE_SDL
     L.info("TileId groupKey", tileId.c_str(), groupKey.c_str());
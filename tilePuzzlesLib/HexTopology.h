@@ -0,0 +1,185 @@
+#ifndef _HEX_TOPOLOGY_H_
+#define _HEX_TOPOLOGY_H_
+
+#include "GameUtil.h"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <utility>
+#include <vector>
+
+namespace tilepuzzles {
+
+/*
+ * Slot layout of a HexSpinMesh board without any vertex data. Slot s is the
+ * triangle at grid (s / slotColumns, s % slotColumns), in the same order as
+ * HexSpinMesh::initTiles creates its tiles.
+ */
+struct HexAnchor {
+  float x = 0.F;
+  float y = 0.F;
+  // the six slots around the anchor, clockwise; a +60 degree rotation
+  // (HexSpinMesh::rotateTileGroup sign convention) moves ring[k] to ring[k + 1]
+  std::array<int, 6> ring;
+  int groupRow = -1;
+  int groupColumn = -1;
+
+  bool dragable() const {
+    return groupRow >= 0;
+  }
+};
+
+struct HexTopology {
+  HexTopology(int rows, int columns)
+    : rows(rows), columns(columns), slotRows(rows * 2), slotColumns(columns * 3) {
+    initSlots();
+    initAnchors();
+  }
+
+  static const HexTopology& get(int rows, int columns) {
+    static std::mutex mutex;
+    static std::map<std::pair<int, int>, std::unique_ptr<HexTopology>> cache;
+    std::lock_guard<std::mutex> lock(mutex);
+    auto& topology = cache[{rows, columns}];
+    if (!topology) {
+      topology.reset(new HexTopology(rows, columns));
+    }
+    return *topology;
+  }
+
+  int slotCount() const {
+    return slotRows * slotColumns;
+  }
+
+  // tile group (texture index) of a slot in the solved layout
+  int slotColor(int slot) const {
+    return slotColors[slot];
+  }
+
+  // slots of the tile group at (groupRow, groupColumn): top three then bottom three, left to right,
+  // matching HexSpinMesh::orderAnchorGroups
+  std::array<int, 6> groupSlots(int groupRow, int groupColumn) const {
+    const int r = groupRow * 2;
+    const int c = groupColumn * 3;
+    return {r * slotColumns + c,       r * slotColumns + c + 1,       r * slotColumns + c + 2,
+            (r + 1) * slotColumns + c, (r + 1) * slotColumns + c + 1, (r + 1) * slotColumns + c + 2};
+  }
+
+  int anchorAt(float x, float y) const {
+    for (int i = 0; i < anchors.size(); ++i) {
+      if (std::abs(anchors[i].x - x) <= EPS && std::abs(anchors[i].y - y) <= EPS) {
+        return i;
+      }
+    }
+    return -1;
+  }
+
+  int groupAnchor(int groupRow, int groupColumn) const {
+    if (groupRow < 0 || groupRow >= rows || groupColumn < 0 || groupColumn >= columns) {
+      return -1;
+    }
+    return groupAnchors[groupRow * columns + groupColumn];
+  }
+
+  const int rows;
+  const int columns;
+  const int slotRows;
+  const int slotColumns;
+  float triWidth = 0.F;
+  float triHeight = 0.F;
+  std::vector<std::array<double, 6>> slotVertices; // x0 y0 x1 y1 x2 y2
+  std::vector<int> slotColors;
+  std::vector<HexAnchor> anchors;
+  std::vector<int> groupAnchors;
+
+  constexpr static float EPS = 0.001F;
+
+private:
+  // mirrors HexTile::updateVertices for a tile at its initial grid coordinate
+  void initSlots() {
+    const double a = ((GameUtil::HIGH_X - GameUtil::LOW_X) / columns / 2.) * GameUtil::TILE_SCALE_FACTOR;
+    const double h = std::sqrt(3.) / 2. * a;
+    triWidth = a;
+    triHeight = h;
+    for (int r = 0; r < slotRows; ++r) {
+      for (int c = 0; c < slotColumns; ++c) {
+        const double x = GameUtil::LOW_X + c * a * .5;
+        double y = GameUtil::HIGH_Y - r * h;
+        if ((c / 3) % 2) {
+          y -= h;
+        }
+        const std::array<double, 6> tri = {x, y - h, x + a, y - h, x + .5 * a, y};
+        const std::array<double, 6> invTri = {x + a, y, x, y, x + .5 * a, y - h};
+        const bool upright = (r % 2) ? (c % 3 == 1) : (c % 3 != 1);
+        slotVertices.push_back(upright ? tri : invTri);
+        slotColors.push_back((r / 2) * columns + (c / 3));
+      }
+    }
+  }
+
+  void initAnchors() {
+    std::vector<std::pair<double, double>> points;
+    for (const auto& v : slotVertices) {
+      for (int i = 0; i < 3; ++i) {
+        const double x = v[i * 2];
+        const double y = v[i * 2 + 1];
+        auto iter = std::find_if(points.begin(), points.end(), [x, y](const auto& p) {
+          return std::abs(p.first - x) <= EPS && std::abs(p.second - y) <= EPS;
+        });
+        if (iter == points.end()) {
+          points.push_back({x, y});
+        }
+      }
+    }
+    // top to bottom, left to right: the order of HexSpinMesh::collectAnchors
+    std::sort(points.begin(), points.end(), [](const auto& p, const auto& q) {
+      return std::abs(p.second - q.second) > EPS ? p.second > q.second : p.first < q.first;
+    });
+
+    groupAnchors.assign(rows * columns, -1);
+    for (const auto& p : points) {
+      std::vector<int> ring;
+      for (int s = 0; s < slotVertices.size(); ++s) {
+        const auto& v = slotVertices[s];
+        for (int i = 0; i < 3; ++i) {
+          if (std::abs(v[i * 2] - p.first) <= EPS && std::abs(v[i * 2 + 1] - p.second) <= EPS) {
+            ring.push_back(s);
+            break;
+          }
+        }
+      }
+      if (ring.size() != 6) {
+        continue;
+      }
+      std::sort(ring.begin(), ring.end(), [this, &p](int s1, int s2) {
+        return centroidAngle(s1, p) > centroidAngle(s2, p);
+      });
+
+      HexAnchor anchor;
+      anchor.x = p.first;
+      anchor.y = p.second;
+      std::copy(ring.begin(), ring.end(), anchor.ring.begin());
+      const int color = slotColors[ring[0]];
+      if (std::all_of(ring.begin(), ring.end(), [this, color](int s) { return slotColors[s] == color; })) {
+        anchor.groupRow = color / columns;
+        anchor.groupColumn = color % columns;
+        groupAnchors[color] = anchors.size();
+      }
+      anchors.push_back(anchor);
+    }
+  }
+
+  double centroidAngle(int slot, const std::pair<double, double>& p) const {
+    const auto& v = slotVertices[slot];
+    const double cx = (v[0] + v[2] + v[4]) / 3.;
+    const double cy = (v[1] + v[3] + v[5]) / 3.;
+    return std::atan2(cy - p.second, cx - p.first);
+  }
+};
+
+} // namespace tilepuzzles
+#endif
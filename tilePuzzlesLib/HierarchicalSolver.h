@@ -0,0 +1,456 @@
+#ifndef _HIERARCHICAL_SOLVER_H_
+#define _HIERARCHICAL_SOLVER_H_
+
+#include "BoardState.h"
+#include "MoveGenerator.h"
+#include "PermRank.h"
+#include "SliderSolver.h"
+#include "Solvability.h"
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <utility>
+#include <vector>
+
+namespace tilepuzzles {
+
+// receives every move as it is made; returning false stops the solve
+using MoveSink = std::function<bool(Move)>;
+
+/*
+ * Distance to solved of every position of a slider of at most 3x3 slots,
+ * one byte per lexicographic rank, 0xff for the unreachable half. Built by
+ * a breadth first search from solved once per shape and shared.
+ */
+struct EndgameTable {
+  static constexpr uint8_t UNREACHABLE = 0xff;
+
+  EndgameTable(int rows, int columns) : rows(rows), columns(columns), size(rows * columns) {
+    distances.assign(PermRank::factorial(size), UNREACHABLE);
+    std::array<uint8_t, 9> perm;
+    for (int s = 0; s < size; ++s) {
+      perm[s] = s;
+    }
+    std::vector<uint32_t> layer = {uint32_t(PermRank::lexRank<uint64_t>(perm.data(), size))};
+    distances[layer[0]] = 0;
+    std::vector<uint32_t> next;
+    for (int depth = 1; !layer.empty(); ++depth) {
+      next.clear();
+      for (uint32_t rank : layer) {
+        PermRank::lexUnrank<uint64_t>(rank, size, perm.data());
+        const int blank = std::find(perm.begin(), perm.begin() + size, size - 1) - perm.begin();
+        for (int slot : neighbors(blank)) {
+          if (slot < 0) {
+            continue;
+          }
+          std::swap(perm[slot], perm[blank]);
+          const uint64_t moved = PermRank::lexRank<uint64_t>(perm.data(), size);
+          std::swap(perm[slot], perm[blank]);
+          if (distances[moved] == UNREACHABLE) {
+            distances[moved] = depth;
+            next.push_back(moved);
+          }
+        }
+      }
+      layer.swap(next);
+    }
+  }
+
+  static const EndgameTable& get(int rows, int columns) {
+    static std::mutex mutex;
+    static std::map<std::pair<int, int>, std::unique_ptr<EndgameTable>> cache;
+    std::lock_guard<std::mutex> lock(mutex);
+    auto& table = cache[{rows, columns}];
+    if (!table) {
+      table.reset(new EndgameTable(rows, columns));
+    }
+    return *table;
+  }
+
+  // slots next to slot, -1 past an edge
+  std::array<int, 4> neighbors(int slot) const {
+    const int r = slot / columns;
+    const int c = slot % columns;
+    return {r > 0 ? slot - columns : -1, r < rows - 1 ? slot + columns : -1, c > 0 ? slot - 1 : -1,
+            c < columns - 1 ? slot + 1 : -1};
+  }
+
+  int distance(const uint8_t* perm) const {
+    return distances[PermRank::lexRank<uint64_t>(perm, size)];
+  }
+
+  int rows;
+  int columns;
+  int size;
+  std::vector<uint8_t> distances;
+};
+
+/*
+ * Constructive solver for sliders too large for any search, e.g. 100x100.
+ * Not optimal, but O(n^1.5) moves for n slots and O(n) memory.
+ *
+ * The unsolved region starts as the whole board. While it is larger than
+ * 3x3, its top row (or its left column when it is wider than tall) is
+ * placed tile by tile: the blank walks round the tile to the cell it should
+ * move into next, greedily and with a breadth first search over a small box
+ * when a placed tile or the tile itself is in the way. The last two tiles
+ * of a line go to the far end first, then finish with a search over the
+ * 3x2 box at the end of the line, tracking only them and the blank. The
+ * final 3x3 (or 2x3, 3x2, 2x2) region follows EndgameTable.
+ *
+ * Moves are single tile slides on a slot and tile index, no BoardState, and
+ * go to the sink as they are made, so a caller can animate or hint from
+ * the first moves while the rest are still coming.
+ */
+struct HierarchicalSolver {
+  // slides encode slots in 14 bits
+  static constexpr int MAX_SLOTS = 1 << 14;
+
+  HierarchicalSolver(int rows, int columns) : rows(rows), columns(columns) {
+  }
+
+  // false when start is unsolvable, too large, or sink or cancel stopped it
+  bool solve(const BoardState& start, const MoveSink& sink, const std::atomic<bool>* cancel = nullptr) {
+    if (start.rows != rows || start.columns != columns || rows < 2 || columns < 2 || start.size() > MAX_SLOTS ||
+        !Solvability::isSolvable(start)) {
+      return false;
+    }
+    this->sink = &sink;
+    stop = cancel;
+    stopped = false;
+    moveCount = 0;
+    grid = start.slots;
+    where.resize(grid.size());
+    for (int s = 0; s < grid.size(); ++s) {
+      where[grid[s]] = s;
+    }
+    blank = start.blank;
+    locked.assign(grid.size(), 0);
+    visited.assign(grid.size(), 0);
+    cameFrom.resize(grid.size());
+    stamp = 0;
+    top = 0;
+    left = 0;
+    while (!stopped && (rows - top > 3 || columns - left > 3)) {
+      if (rows - top >= columns - left) {
+        placeRow();
+      } else {
+        placeColumn();
+      }
+    }
+    if (!stopped) {
+      solveEndgame();
+    }
+    return !stopped && std::is_sorted(grid.begin(), grid.end());
+  }
+
+  // collects the moves of solve()
+  SolveResult solve(const BoardState& start, const std::atomic<bool>* cancel = nullptr) {
+    const auto begin = std::chrono::steady_clock::now();
+    SolveResult result;
+    const MoveSink collect = [&result](Move move) {
+      result.moves.push_back(move);
+      return true;
+    };
+    result.solved = solve(start, collect, cancel);
+    if (!result.solved) {
+      result.moves.clear();
+    }
+    result.nodes = moveCount;
+    result.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - begin).count();
+    return result;
+  }
+
+  int rows;
+  int columns;
+  // moves made by the last solve
+  uint64_t moveCount = 0;
+
+private:
+  // inclusive slot rectangle
+  struct Box {
+    int top;
+    int bottom;
+    int left;
+    int right;
+  };
+
+  bool inside(const Box& box, int slot) const {
+    const int r = slot / columns;
+    const int c = slot % columns;
+    return r >= box.top && r <= box.bottom && c >= box.left && c <= box.right;
+  }
+
+  // slides the tile on slot, a neighbor of the blank, into the blank
+  void step(int slot) {
+    const BoardState::TileId tile = grid[slot];
+    grid[blank] = tile;
+    where[tile] = blank;
+    grid[slot] = grid.size() - 1;
+    where[grid.size() - 1] = slot;
+    const Move move = MoveGenerator::slide(slot, blank);
+    blank = slot;
+    ++moveCount;
+    if (!(*sink)(move) || ((moveCount & 0xfff) == 0 && stop && stop->load(std::memory_order_relaxed))) {
+      stopped = true;
+    }
+  }
+
+  bool open(int slot, int avoid) const {
+    return !locked[slot] && slot != avoid;
+  }
+
+  // blank to target without moving avoid or a locked tile
+  void moveBlank(int target, int avoid) {
+    while (!stopped && blank != target) {
+      const int r = blank / columns;
+      const int c = blank % columns;
+      const int vertical = target / columns > r ? blank + columns : target / columns < r ? blank - columns : -1;
+      const int horizontal = target % columns > c ? blank + 1 : target % columns < c ? blank - 1 : -1;
+      if (vertical >= 0 && open(vertical, avoid)) {
+        step(vertical);
+      } else if (horizontal >= 0 && open(horizontal, avoid)) {
+        step(horizontal);
+      } else {
+        route(target, avoid);
+        return;
+      }
+    }
+  }
+
+  // shortest blank path to target, over the box around both first, then over the whole region
+  void route(int target, int avoid) {
+    const Box near = {std::max(top, std::min(blank, target) / columns - 2),
+                      std::min(rows - 1, std::max(blank, target) / columns + 2),
+                      std::max(left, std::min(blank % columns, target % columns) - 2),
+                      std::min(columns - 1, std::max(blank % columns, target % columns) + 2)};
+    const Box goal = {target / columns, target / columns, target % columns, target % columns};
+    if (!search(near, goal, avoid) && !search(region(), goal, avoid)) {
+      // cannot happen on a solvable board; stop rather than slide a tile that is not next to the blank
+      stopped = true;
+    }
+  }
+
+  Box region() const {
+    return {top, rows - 1, left, columns - 1};
+  }
+
+  // blank to the nearest open slot of goal, searching within box
+  bool search(const Box& box, const Box& goal, int avoid) {
+    ++stamp;
+    queue.clear();
+    queue.push_back(blank);
+    visited[blank] = stamp;
+    for (size_t head = 0; head < queue.size(); ++head) {
+      const int slot = queue[head];
+      if (inside(goal, slot)) {
+        path.clear();
+        for (int s = slot; s != blank; s = cameFrom[s]) {
+          path.push_back(s);
+        }
+        for (auto s = path.rbegin(); s != path.rend() && !stopped; ++s) {
+          step(*s);
+        }
+        return true;
+      }
+      const int r = slot / columns;
+      const int c = slot % columns;
+      for (int next : {r > box.top ? slot - columns : -1, r < box.bottom ? slot + columns : -1,
+                       c > box.left ? slot - 1 : -1, c < box.right ? slot + 1 : -1}) {
+        if (next >= 0 && visited[next] != stamp && open(next, avoid)) {
+          visited[next] = stamp;
+          cameFrom[next] = slot;
+          queue.push_back(next);
+        }
+      }
+    }
+    return false;
+  }
+
+  /*
+   * Moves tile one cell at a time until it is inside box, heading for
+   * target along rows first or columns first. The blank goes round to the
+   * next cell each time.
+   */
+  void moveTile(int tile, int target, const Box& box, bool rowsFirst) {
+    while (!stopped && !inside(box, where[tile])) {
+      const int slot = where[tile];
+      const int dr = target / columns - slot / columns;
+      const int dc = target % columns - slot % columns;
+      const int vertical = dr > 0 ? slot + columns : slot - columns;
+      const int horizontal = dc > 0 ? slot + 1 : slot - 1;
+      const int next = (rowsFirst ? dc != 0 : dr == 0) ? horizontal : vertical;
+      moveBlank(next, slot);
+      if (!stopped) {
+        step(slot);
+      }
+    }
+  }
+
+  void moveTile(int tile, int target, bool rowsFirst) {
+    moveTile(tile, target, {target / columns, target / columns, target % columns, target % columns}, rowsFirst);
+  }
+
+  void placeRow() {
+    for (int c = left; c + 2 < columns && !stopped; ++c) {
+      const int slot = top * columns + c;
+      moveTile(slot, slot, true);
+      locked[slot] = 1;
+    }
+    const int last = top * columns + columns - 1;
+    placePair(last - 1, last, {top, top + 2, columns - 2, columns - 1}, last + 2 * columns - 1, true);
+    ++top;
+  }
+
+  void placeColumn() {
+    for (int r = top; r + 2 < rows && !stopped; ++r) {
+      const int slot = r * columns + left;
+      moveTile(slot, slot, false);
+      locked[slot] = 1;
+    }
+    const int last = (rows - 1) * columns + left;
+    placePair(last - columns, last, {rows - 2, rows - 1, left, left + 2}, last - columns + 2, false);
+    ++left;
+  }
+
+  /*
+   * The last two slots a and b of a line. Tile a goes to b's slot and stays,
+   * tile b comes into box, the 3x2 block at the line's end, heading for its
+   * far corner, then the blank joins them and a search over box's slots
+   * finishes both.
+   */
+  void placePair(int a, int b, const Box& box, int corner, bool rowsFirst) {
+    if (grid[a] == a && grid[b] == b) {
+      locked[a] = locked[b] = 1;
+      return;
+    }
+    moveTile(a, b, rowsFirst);
+    locked[b] = 1;
+    moveTile(b, corner, box, rowsFirst);
+    locked[b] = 0;
+    if (stopped) {
+      return;
+    }
+    // the slot next to a's can be a dead end outside the search's reach, so any slot of box does
+    locked[where[a]] = 1;
+    const bool joined = search(region(), box, where[b]);
+    locked[where[a]] = 0;
+    if (!joined) {
+      stopped = true;
+      return;
+    }
+    finishPair(a, b, box);
+    locked[a] = locked[b] = 1;
+  }
+
+  int distance(int from, int to) const {
+    return std::abs(from / columns - to / columns) + std::abs(from % columns - to % columns);
+  }
+
+  // breadth first over the cells of a, b and the blank within box's 6 slots
+  void finishPair(int a, int b, const Box& box) {
+    std::array<int, 6> cells;
+    int count = 0;
+    for (int r = box.top; r <= box.bottom; ++r) {
+      for (int c = box.left; c <= box.right; ++c) {
+        cells[count++] = r * columns + c;
+      }
+    }
+    auto cellOf = [&](int slot) { return int(std::find(cells.begin(), cells.end(), slot) - cells.begin()); };
+    auto encode = [](int ia, int ib, int iblank) { return (ia * 6 + ib) * 6 + iblank; };
+    const int goal = encode(cellOf(a), cellOf(b), 0);
+    std::array<int16_t, 216> parent;
+    parent.fill(-1);
+    std::array<int16_t, 216> order;
+    int tail = 0;
+    const int root = encode(cellOf(where[a]), cellOf(where[b]), cellOf(blank));
+    parent[root] = root;
+    order[tail++] = root;
+    int found = -1;
+    for (int head = 0; head < tail && found < 0; ++head) {
+      const int code = order[head];
+      const int ia = code / 36;
+      const int ib = code / 6 % 6;
+      const int iblank = code % 6;
+      if (ia == goal / 36 && ib == goal / 6 % 6) {
+        found = code;
+        break;
+      }
+      for (int i = 0; i < 6; ++i) {
+        if (distance(cells[i], cells[iblank]) != 1) {
+          continue;
+        }
+        const int next = encode(ia == i ? iblank : ia, ib == i ? iblank : ib, i);
+        if (parent[next] < 0) {
+          parent[next] = code;
+          order[tail++] = next;
+        }
+      }
+    }
+    path.clear();
+    for (int code = found; code >= 0 && code != root; code = parent[code]) {
+      path.push_back(cells[code % 6]);
+    }
+    for (auto slot = path.rbegin(); slot != path.rend() && !stopped; ++slot) {
+      step(*slot);
+    }
+  }
+
+  // follows EndgameTable over the region left, relabeled as a board of its own
+  void solveEndgame() {
+    const int height = rows - top;
+    const int width = columns - left;
+    const int size = height * width;
+    const EndgameTable& table = EndgameTable::get(height, width);
+    auto local = [&](int slot) { return (slot / columns - top) * width + slot % columns - left; };
+    auto global = [&](int cell) { return (top + cell / width) * columns + left + cell % width; };
+    std::array<uint8_t, 9> perm;
+    for (int cell = 0; cell < size; ++cell) {
+      perm[cell] = local(grid[global(cell)]);
+    }
+    int cellBlank = local(blank);
+    for (int d = table.distance(perm.data()); d > 0 && d != EndgameTable::UNREACHABLE && !stopped; --d) {
+      for (int cell : table.neighbors(cellBlank)) {
+        if (cell < 0) {
+          continue;
+        }
+        std::swap(perm[cell], perm[cellBlank]);
+        if (table.distance(perm.data()) == d - 1) {
+          step(global(cell));
+          cellBlank = cell;
+          break;
+        }
+        std::swap(perm[cell], perm[cellBlank]);
+      }
+    }
+  }
+
+  const MoveSink* sink = nullptr;
+  const std::atomic<bool>* stop = nullptr;
+  bool stopped = false;
+  // first row and column of the unsolved region
+  int top = 0;
+  int left = 0;
+  int blank = 0;
+  // tile on every slot, slot of every tile
+  std::vector<BoardState::TileId> grid;
+  std::vector<uint16_t> where;
+  std::vector<uint8_t> locked;
+  // blank search storage, visited holds the stamp of the search that reached a slot
+  std::vector<uint32_t> visited;
+  std::vector<int> cameFrom;
+  std::vector<int> queue;
+  std::vector<int> path;
+  uint32_t stamp = 0;
+};
+
+} // namespace tilepuzzles
+#endif
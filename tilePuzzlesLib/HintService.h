@@ -0,0 +1,236 @@
+#ifndef _HINT_SERVICE_H_
+#define _HINT_SERVICE_H_
+
+#include "AnytimeSolver.h"
+#include "BoardState.h"
+#include "HexSolver.h"
+#include "HierarchicalSolver.h"
+#include "MoveGenerator.h"
+#include "PerfectTables.h"
+#include "SliderSolver.h"
+
+#include <tsl/robin_map.h>
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace tilepuzzles {
+
+/*
+ * Background hint engine. post() hands it the position on screen; a worker
+ * thread solves it and caches the next move of every position along the
+ * solution by state hash, so following a hint finds the next one already
+ * there. post() and poll() never wait for the worker: they try-lock, and
+ * the worker holds the lock only to take a position or to swap in a cache
+ * it built without it. A post() that misses the lock is retried by the
+ * next one.
+ *
+ * Posting a position that is not cached cancels the running search. Sliders
+ * and rollers get AnytimeSolver for budgetSeconds, publishing each shorter
+ * solution as it is found, then sliders of up to OPTIMAL_SLOTS slots an
+ * optimal IDA* run capped at optimalNodes. Hex boards get HexSolver.
+ * Sliders of HIERARCHICAL_SLOTS slots and more get HierarchicalSolver
+ * instead, publishing the first half cache's worth of its move stream.
+ *
+ * Boards PerfectTables covers skip all of that: the worker maps (or on the
+ * first post generates) the board's distance table once, and from then on
+ * poll() answers every position of that board straight from the table.
+ */
+struct HintService {
+  static constexpr int OPTIMAL_SLOTS = 16;
+  static constexpr int HIERARCHICAL_SLOTS = 400;
+
+  HintService() {
+  }
+
+  ~HintService() {
+    {
+      std::lock_guard<std::mutex> lock(mutex);
+      quit = true;
+      cancelled = true;
+    }
+    wake.notify_one();
+    if (worker.joinable()) {
+      worker.join();
+    }
+  }
+
+  HintService(const HintService&) = delete;
+  HintService& operator=(const HintService&) = delete;
+
+  // cheap for the position posted last, so callers may post every frame
+  void post(const BoardState& state) {
+    if (state.hash == postedHash) {
+      return;
+    }
+    const DistanceTable* perfect = table.load();
+    if (perfect && perfect->covers(state)) {
+      postedHash = state.hash;
+      return;
+    }
+    {
+      std::unique_lock<std::mutex> lock(mutex, std::try_to_lock);
+      if (!lock.owns_lock()) {
+        return;
+      }
+      postedHash = state.hash;
+      if (cache.count(state.hash) || state.isSolved()) {
+        return;
+      }
+      pending = std::make_unique<BoardState>(state);
+      cancelled = true;
+      if (!worker.joinable()) {
+        worker = std::thread([this] { run(); });
+      }
+    }
+    wake.notify_one();
+  }
+
+  // next move for state if one is ready; never blocks
+  bool poll(const BoardState& state, Move& move) {
+    const DistanceTable* perfect = table.load();
+    if (perfect && perfect->covers(state)) {
+      return perfect->hint(state, move);
+    }
+    std::unique_lock<std::mutex> lock(mutex, std::try_to_lock);
+    if (!lock.owns_lock()) {
+      return false;
+    }
+    const auto iter = cache.find(state.hash);
+    if (iter == cache.end()) {
+      return false;
+    }
+    move = iter->second;
+    return true;
+  }
+
+  // stops the running search and drops a pending position
+  void cancel() {
+    std::lock_guard<std::mutex> lock(mutex);
+    pending.reset();
+    cancelled = true;
+    postedHash = 0;
+  }
+
+  bool busy() const {
+    return searching;
+  }
+
+  size_t cachedCount() {
+    std::lock_guard<std::mutex> lock(mutex);
+    return cache.size();
+  }
+
+  double budgetSeconds = 1.;
+  uint64_t optimalNodes = 20000000;
+  size_t maxCached = 1 << 18;
+  // null searches small boards like any other
+  PerfectTables* tables = &PerfectTables::shared();
+
+private:
+  void run() {
+    while (true) {
+      std::unique_ptr<BoardState> state;
+      {
+        std::unique_lock<std::mutex> lock(mutex);
+        wake.wait(lock, [this] { return quit || pending; });
+        if (quit) {
+          return;
+        }
+        state = std::move(pending);
+        cancelled = false;
+        searching = true;
+      }
+      search(*state);
+      searching = false;
+    }
+  }
+
+  void search(const BoardState& start) {
+    if (tables && PerfectTables::covers(start)) {
+      if (const DistanceTable* perfect = tables->find(start)) {
+        table = perfect;
+        return;
+      }
+    }
+    if (start.type == PuzzleType::HexSpinPuzzle) {
+      HexSolver solver(start.rows, start.columns);
+      SolveResult result = solver.solve(start);
+      if (result.solved) {
+        publish(start, result.moves);
+      }
+      return;
+    }
+    if (start.type == PuzzleType::SliderPuzzle && start.size() >= HIERARCHICAL_SLOTS) {
+      HierarchicalSolver solver(start.rows, start.columns);
+      std::vector<Move> moves;
+      solver.solve(
+          start,
+          [&](Move move) {
+            moves.push_back(move);
+            return moves.size() < maxCached / 2;
+          },
+          &cancelled);
+      if (!cancelled) {
+        publish(start, moves);
+      }
+      return;
+    }
+    // kept across searches, rollers build their macros once per board size
+    if (!anytime || anytime->rows != start.rows || anytime->columns != start.columns ||
+        anytime->type != start.type) {
+      anytime = std::make_unique<AnytimeSolver>(start.rows, start.columns, start.type);
+    }
+    anytime->onSolution = [this, &start](const std::vector<Move>& moves) { publish(start, moves); };
+    anytime->solve(start, budgetSeconds, &cancelled);
+    if (start.type == PuzzleType::SliderPuzzle && start.size() <= OPTIMAL_SLOTS && !cancelled) {
+      SliderSolver solver(start.rows, start.columns);
+      SolveResult result = solver.solve(start, optimalNodes, &cancelled);
+      if (result.solved) {
+        publish(start, result.moves);
+      }
+    }
+  }
+
+  /*
+   * Later solutions overwrite earlier moves for the positions they share.
+   * Only the worker writes the cache, so it reads it unlocked to build the
+   * next one and locks just for the swap.
+   */
+  void publish(BoardState state, const std::vector<Move>& moves) {
+    Cache next;
+    if (cache.size() + moves.size() <= maxCached) {
+      next = cache;
+    }
+    next.reserve(next.size() + moves.size());
+    for (Move move : moves) {
+      next[state.hash] = move;
+      MoveGenerator::apply(state, move);
+    }
+    std::lock_guard<std::mutex> lock(mutex);
+    cache.swap(next);
+  }
+
+  std::mutex mutex;
+  std::condition_variable wake;
+  std::thread worker;
+  std::unique_ptr<BoardState> pending;
+  using Cache = tsl::robin_map<uint64_t, Move>;
+  Cache cache;
+  std::unique_ptr<AnytimeSolver> anytime;
+  // the perfect table of the board last posted, when it has one
+  std::atomic<const DistanceTable*> table = nullptr;
+  std::atomic<bool> cancelled = false;
+  std::atomic<bool> searching = false;
+  bool quit = false;
+  // only touched by the posting thread
+  uint64_t postedHash = 0;
+};
+
+} // namespace tilepuzzles
+#endif
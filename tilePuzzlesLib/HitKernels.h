@@ -0,0 +1,272 @@
+#ifndef _HIT_KERNELS_H_
+#define _HIT_KERNELS_H_
+
+#include <cmath>
+#include <vector>
+
+#if defined(__AVX__)
+#include <immintrin.h>
+#elif defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+namespace tilepuzzles {
+
+/*
+ * Point picking against a batch of shapes stored as structure of arrays.
+ * firstHit tests HitLanes::WIDTH shapes per instruction (8 with AVX, 4 with
+ * SSE2, one at a time otherwise) and returns the lowest index containing
+ * the point, so a batch answers like a linear scan over its shapes.
+ */
+#if defined(__AVX__)
+struct HitLanes {
+  using V = __m256;
+  static constexpr int WIDTH = 8;
+
+  static V load(const float* p) {
+    return _mm256_loadu_ps(p);
+  }
+  static V set(float f) {
+    return _mm256_set1_ps(f);
+  }
+  static V add(V a, V b) {
+    return _mm256_add_ps(a, b);
+  }
+  static V sub(V a, V b) {
+    return _mm256_sub_ps(a, b);
+  }
+  static V mul(V a, V b) {
+    return _mm256_mul_ps(a, b);
+  }
+  static V abs(V a) {
+    return _mm256_andnot_ps(_mm256_set1_ps(-0.F), a);
+  }
+  static V le(V a, V b) {
+    return _mm256_cmp_ps(a, b, _CMP_LE_OQ);
+  }
+  static V both(V a, V b) {
+    return _mm256_and_ps(a, b);
+  }
+  static int mask(V m) {
+    return _mm256_movemask_ps(m);
+  }
+};
+#elif defined(__SSE2__)
+struct HitLanes {
+  using V = __m128;
+  static constexpr int WIDTH = 4;
+
+  static V load(const float* p) {
+    return _mm_loadu_ps(p);
+  }
+  static V set(float f) {
+    return _mm_set1_ps(f);
+  }
+  static V add(V a, V b) {
+    return _mm_add_ps(a, b);
+  }
+  static V sub(V a, V b) {
+    return _mm_sub_ps(a, b);
+  }
+  static V mul(V a, V b) {
+    return _mm_mul_ps(a, b);
+  }
+  static V abs(V a) {
+    return _mm_andnot_ps(_mm_set1_ps(-0.F), a);
+  }
+  static V le(V a, V b) {
+    return _mm_cmple_ps(a, b);
+  }
+  static V both(V a, V b) {
+    return _mm_and_ps(a, b);
+  }
+  static int mask(V m) {
+    return _mm_movemask_ps(m);
+  }
+};
+#else
+struct HitLanes {
+  using V = float;
+  static constexpr int WIDTH = 1;
+
+  static V load(const float* p) {
+    return *p;
+  }
+  static V set(float f) {
+    return f;
+  }
+  static V add(V a, V b) {
+    return a + b;
+  }
+  static V sub(V a, V b) {
+    return a - b;
+  }
+  static V mul(V a, V b) {
+    return a * b;
+  }
+  static V abs(V a) {
+    return std::abs(a);
+  }
+  static V le(V a, V b) {
+    return a <= b ? 1.F : 0.F;
+  }
+  static V both(V a, V b) {
+    return a * b;
+  }
+  static int mask(V m) {
+    return m != 0.F;
+  }
+};
+#endif
+
+// fields are padded to a multiple of PAD so every load of a full lane group stays in bounds
+template <int FIELDS>
+struct ShapeBatch {
+  static constexpr int PAD = 8;
+
+  int size() const {
+    return count;
+  }
+
+  void resize(int size) {
+    count = size;
+    const int padded = (size + PAD - 1) / PAD * PAD;
+    for (auto& field : fields) {
+      field.resize(padded, 0.F);
+    }
+  }
+
+  // shapes items[0], items[1], ... of from, in that order
+  void gather(const ShapeBatch& from, const std::vector<int>& items) {
+    resize(items.size());
+    for (int f = 0; f < FIELDS; ++f) {
+      float* to = fields[f].data();
+      const float* source = from.fields[f].data();
+      for (int i = 0; i < items.size(); ++i) {
+        to[i] = source[items[i]];
+      }
+    }
+  }
+
+protected:
+  // lanes of the group at index i that hold shapes
+  int valid(int i) const {
+    const int left = count - i;
+    return left >= HitLanes::WIDTH ? (1 << HitLanes::WIDTH) - 1 : (1 << left) - 1;
+  }
+
+  static int lowestLane(int hits) {
+    return __builtin_ctz(hits);
+  }
+
+  std::vector<float> fields[FIELDS];
+  int count = 0;
+};
+
+/*
+ * Axis aligned quads, the shape Tile::onClick tests: a point is inside when
+ * minX <= x <= maxX and minY <= y <= maxY, edges included.
+ */
+struct QuadBatch : ShapeBatch<4> {
+  enum { MIN_X, MIN_Y, MAX_X, MAX_Y };
+
+  void set(int i, float minX, float minY, float maxX, float maxY) {
+    fields[MIN_X][i] = minX;
+    fields[MIN_Y][i] = minY;
+    fields[MAX_X][i] = maxX;
+    fields[MAX_Y][i] = maxY;
+  }
+
+  int firstHit(float x, float y) const {
+    using L = HitLanes;
+    const L::V px = L::set(x);
+    const L::V py = L::set(y);
+    for (int i = 0; i < count; i += L::WIDTH) {
+      const L::V inX = L::both(L::le(L::load(&fields[MIN_X][i]), px), L::le(px, L::load(&fields[MAX_X][i])));
+      const L::V inY = L::both(L::le(L::load(&fields[MIN_Y][i]), py), L::le(py, L::load(&fields[MAX_Y][i])));
+      const int hits = L::mask(L::both(inX, inY)) & valid(i);
+      if (hits) {
+        return i + lowestLane(hits);
+      }
+    }
+    return -1;
+  }
+};
+
+/*
+ * Triangles as edge functions e(x, y) = a * x + b * y + c, twice the signed
+ * area of the triangle the point makes with that edge. The three always sum
+ * to the triangle's own twice signed area, and a point is inside when
+ * |e0| + |e1| + |e2| exceeds |area| by at most 2 * eps: the area sum test of
+ * HexTile::isInside, including its tolerance, without a division.
+ */
+struct TriangleEdges {
+  float a[3];
+  float b[3];
+  float c[3];
+  float area;
+
+  template <typename V>
+  static TriangleEdges of(const V& v0, const V& v1, const V& v2) {
+    TriangleEdges edges;
+    const V* verts[] = {&v0, &v1, &v2};
+    for (int e = 0; e < 3; ++e) {
+      // the edge opposite vertex e, walked in v0 -> v1 -> v2 order
+      const V& p = *verts[(e + 1) % 3];
+      const V& q = *verts[(e + 2) % 3];
+      edges.a[e] = p[1] - q[1];
+      edges.b[e] = q[0] - p[0];
+      edges.c[e] = p[0] * q[1] - q[0] * p[1];
+    }
+    edges.area = (v1[0] - v0[0]) * (v2[1] - v0[1]) - (v2[0] - v0[0]) * (v1[1] - v0[1]);
+    return edges;
+  }
+
+  // same operations in the same order as TriangleBatch::firstHit
+  bool contains(float x, float y, float eps) const {
+    float sum = 0.F;
+    for (int e = 0; e < 3; ++e) {
+      sum = sum + std::abs(a[e] * x + b[e] * y + c[e]);
+    }
+    return sum - std::abs(area) <= 2.F * eps;
+  }
+};
+
+struct TriangleBatch : ShapeBatch<10> {
+  void set(int i, const TriangleEdges& edges) {
+    for (int e = 0; e < 3; ++e) {
+      fields[e * 3][i] = edges.a[e];
+      fields[e * 3 + 1][i] = edges.b[e];
+      fields[e * 3 + 2][i] = edges.c[e];
+    }
+    fields[AREA][i] = edges.area;
+  }
+
+  int firstHit(float x, float y, float eps) const {
+    using L = HitLanes;
+    const L::V px = L::set(x);
+    const L::V py = L::set(y);
+    const L::V slack = L::set(2.F * eps);
+    for (int i = 0; i < count; i += L::WIDTH) {
+      L::V sum = L::set(0.F);
+      for (int e = 0; e < 3; ++e) {
+        const L::V ax = L::mul(L::load(&fields[e * 3][i]), px);
+        const L::V by = L::mul(L::load(&fields[e * 3 + 1][i]), py);
+        const L::V edge = L::add(L::add(ax, by), L::load(&fields[e * 3 + 2][i]));
+        sum = L::add(sum, L::abs(edge));
+      }
+      const L::V excess = L::sub(sum, L::abs(L::load(&fields[AREA][i])));
+      const int hits = L::mask(L::le(excess, slack)) & valid(i);
+      if (hits) {
+        return i + lowestLane(hits);
+      }
+    }
+    return -1;
+  }
+
+private:
+  static constexpr int AREA = 9;
+};
+
+} // namespace tilepuzzles
+#endif
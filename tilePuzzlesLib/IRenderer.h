@@ -2,6 +2,8 @@
 #define _IRENDERER_H_
 
 #include "App.h"
+#include "BoardState.h"
+#include "MoveGenerator.h"
 
 namespace tilepuzzles {
 
@@ -43,6 +45,10 @@ struct IRenderer {
   virtual void setReadOnly(bool readOnly) = 0;
 
   virtual View* getView() = 0;
+
+  virtual const BoardState& getBoardState() = 0;
+
+  virtual void applyMove(Move move) = 0;
 };
 } // namespace tilepuzzles
 #endif
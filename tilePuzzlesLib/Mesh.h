@@ -13,6 +13,10 @@
 
 #include "AnchorTile.h"
 #include "App.h"
+#include "BoardState.h"
+#include "MoveGenerator.h"
+#include "Solvability.h"
+#include "SpatialGrid.h"
 #include "TVertexBuffer.h"
 #include "Tile.h"
 #include "TileGroup.h"
@@ -49,6 +53,11 @@ struct Mesh {
     initVertexBuffers();
     initTiles();
     initBorder();
+    initState();
+  }
+
+  virtual void initState() {
+    state = BoardState::fromConfig(configMgr.config);
   }
 
   virtual void initVertexBuffers() {
@@ -78,6 +87,41 @@ struct Mesh {
   virtual void rollTileGroups(const TileGroup<T>& tileGroup, Direction dir) {
   }
 
+  virtual void commitRotation(const TileGroup<T>& tileGroup, float angle) {
+  }
+
+  // replays a packed move without going through the mouse handlers
+  virtual void applyMove(Move move) {
+    MoveGenerator::apply(state, move);
+    tilesDirty = true;
+  }
+
+  int slotOf(const T& tile) const {
+    return tile.gridCoord.x * state.slotColumns() + tile.gridCoord.y;
+  }
+
+  virtual Point slotTopLeft(const T& tile, int row, int column) {
+    return {GameUtil::LOW_X + column * tile.size.x, GameUtil::HIGH_Y - row * tile.size.y};
+  }
+
+  // regenerates tile geometry from the board state after moves
+  virtual void syncTiles() {
+    if (!tilesDirty) {
+      return;
+    }
+    tilesDirty = false;
+    const int columns = state.slotColumns();
+    for (int s = 0; s < state.size(); ++s) {
+      T& tile = tiles[state.slots[s]];
+      tile.gridCoord = {s / columns, s % columns};
+      tile.topLeft = slotTopLeft(tile, s / columns, s % columns);
+      tile.updateVertices();
+      if (!hitGridStale) {
+        indexTileBounds(state.slots[s]);
+      }
+    }
+  }
+
   void logTiles() {
     std::for_each(std::begin(tiles), std::end(tiles), [](const T& t) {
       t.logVertices();
@@ -85,53 +129,133 @@ struct Mesh {
     });
   }
 
+  // state.slots is the grid index: every slide, roll, swap and shuffle goes through it
   virtual T* tileAt(int row, int column) {
-    auto tileIter = std::find_if(tiles.begin(), tiles.end(), [row, column](const T& t) {
-      return row == t.gridCoord.x && column == t.gridCoord.y;
-    });
-    if (tileIter != tiles.end()) {
-      return &*tileIter;
-    } else {
+    syncTiles();
+    const int columns = state.slotColumns();
+    if (row < 0 || column < 0 || column >= columns || row * columns + column >= state.size()) {
       return nullptr;
     }
+    return &tiles[state.slots[row * columns + column]];
   }
 
   virtual TileGroup<T>* tileGroupAt(int row, int column) {
-    auto tileIter =
-      std::find_if(tileGroupAnchors.begin(), tileGroupAnchors.end(),
-                   [row, column](const auto& t) { return row == t.gridCoord.x && column == t.gridCoord.y; });
-    if (tileIter != tileGroupAnchors.end()) {
-      return &*tileIter;
-    } else {
+    if (groupIndexed != tileGroupAnchors.size()) {
+      indexTileGroups();
+    }
+    if (row < 0 || column < 0 || row >= groupRows || column >= groupColumns) {
       return nullptr;
     }
+    const int index = groupIndex[row * groupColumns + column];
+    if (index < 0) {
+      return nullptr;
+    }
+    TileGroup<T>& group = tileGroupAnchors[index];
+    if (group.gridCoord.x != row || group.gridCoord.y != column) {
+      // the anchors were rebuilt differently since
+      indexTileGroups();
+      return tileGroupAt(row, column);
+    }
+    return &group;
+  }
+
+  /*
+   * Dense (row, column) to tileGroupAnchors index; groups without grid
+   * coordinates are left out. Also grids the anchor points for hitTestAnchor.
+   */
+  void indexTileGroups() {
+    groupRows = 0;
+    groupColumns = 0;
+    for (const auto& group : tileGroupAnchors) {
+      groupRows = std::max(groupRows, group.gridCoord.x + 1);
+      groupColumns = std::max(groupColumns, group.gridCoord.y + 1);
+    }
+    groupIndex.assign(groupRows * groupColumns, -1);
+    for (int i = tileGroupAnchors.size() - 1; i >= 0; --i) {
+      const math::int2 coord = tileGroupAnchors[i].gridCoord;
+      if (coord.x >= 0 && coord.y >= 0) {
+        groupIndex[coord.x * groupColumns + coord.y] = i;
+      }
+    }
+    groupIndexed = tileGroupAnchors.size();
+
+    const int dim = std::max(1, int(std::ceil(sqrt(tileGroupAnchors.size()))));
+    anchorGrid.reset(GameUtil::LOW_X, GameUtil::LOW_Y, GameUtil::HIGH_X, GameUtil::HIGH_Y, dim, dim);
+    for (int i = 0; i < tileGroupAnchors.size(); ++i) {
+      math::float2 point = tileGroupAnchors[i].anchorPoint;
+      anchorGrid.update(i, point.x - GeoUtil::EPS_4, point.y - GeoUtil::EPS_4, point.x + GeoUtil::EPS_4,
+                        point.y + GeoUtil::EPS_4);
+    }
   }
 
   virtual void setTileGroupZCoord(TileGroup<T>& tileGroup, float zCoord) {
   }
 
+  // the first tile, in tiles order, that accepts the point; only the tiles listed in its grid cell are tried
   virtual T* hitTest(const math::float3& clipCoord) {
-    auto tileIter = std::find_if(tiles.begin(), tiles.end(), [&clipCoord](const T& t) {
-      return t.onClick({clipCoord.x, clipCoord.y});
-    });
-    if (tileIter != tiles.end()) {
-      return &*tileIter;
-    } else {
-      return nullptr;
+    const math::float2 point = {clipCoord.x, clipCoord.y};
+    T* hit = nullptr;
+    hitTestPoints(&point, 1, &hit);
+    return hit;
+  }
+
+  /*
+   * hitTest for count points at once. The candidates of all their grid
+   * cells, in tiles order, are gathered into one batch that the points
+   * share, and each point tests the whole batch with T::firstHit.
+   */
+  void hitTestPoints(const math::float2* points, int count, T** hits) {
+    syncTiles();
+    if (hitGridStale) {
+      indexTileBounds();
+    }
+    hitItems.clear();
+    for (int p = 0; p < count; ++p) {
+      const std::vector<int>& cell = tileGrid.at(points[p].x, points[p].y);
+      hitItems.insert(hitItems.end(), cell.begin(), cell.end());
+    }
+    if (count > 1) {
+      std::sort(hitItems.begin(), hitItems.end());
+      hitItems.erase(std::unique(hitItems.begin(), hitItems.end()), hitItems.end());
+    }
+    hitCandidates.gather(hitShapes, hitItems);
+    for (int p = 0; p < count; ++p) {
+      const int index = T::firstHit(hitCandidates, points[p]);
+      hits[p] = index < 0 ? nullptr : &tiles[hitItems[index]];
     }
   }
 
   virtual TileGroup<T>* hitTestAnchor(const math::float3& clipCoord) {
-    auto iter =
-      std::find_if(tileGroupAnchors.begin(), tileGroupAnchors.end(), [&clipCoord](const auto& anch) {
-        math::float2 point = anch.anchorPoint;
-        return abs(point.x - clipCoord.x) <= GeoUtil::EPS_4 && abs(point.y - clipCoord.y) <= GeoUtil::EPS_4;
-      });
-    if (iter != tileGroupAnchors.end()) {
-      return &*iter;
-    } else {
-      return nullptr;
+    if (groupIndexed != tileGroupAnchors.size()) {
+      indexTileGroups();
     }
+    const int index = anchorGrid.find(clipCoord.x, clipCoord.y, [this, &clipCoord](int i) {
+      math::float2 point = tileGroupAnchors[i].anchorPoint;
+      return abs(point.x - clipCoord.x) <= GeoUtil::EPS_4 && abs(point.y - clipCoord.y) <= GeoUtil::EPS_4;
+    });
+    return index < 0 ? nullptr : &tileGroupAnchors[index];
+  }
+
+  // one cell per tile of the solved board
+  virtual void resetTileGrid() {
+    const int dim = std::max(1, int(sqrt(tiles.size())));
+    tileGrid.reset(GameUtil::LOW_X, GameUtil::LOW_Y, GameUtil::HIGH_X, GameUtil::HIGH_Y, dim, dim);
+  }
+
+  void indexTileBounds() {
+    resetTileGrid();
+    hitShapes.resize(tiles.size());
+    for (int i = 0; i < tiles.size(); ++i) {
+      indexTileBounds(i);
+    }
+    hitGridStale = false;
+  }
+
+  // after tile i's vertices moved; only the cells it enters or leaves change
+  void indexTileBounds(int i) {
+    const math::float4 box = tiles[i].bounds();
+    tileGrid.update(i, box.x, box.y, box.z, box.w);
+    tiles[i].storeHitShape(hitShapes, i);
   }
 
   virtual int getTileCount() {
@@ -164,7 +288,20 @@ struct Mesh {
   }
 
   virtual void shuffle() {
-    GameUtil::shuffle<T>(tiles);
+    GameUtil::shuffleSlots(state);
+    Solvability::makeSolvable(state);
+    tilesDirty = true;
+  }
+
+  // takes a board shuffled elsewhere, e.g. by ShuffleService to the config's "difficulty"
+  virtual void shuffleTo(const BoardState& shuffled) {
+    state = shuffled;
+    tilesDirty = true;
+  }
+
+  // random moves a shuffle to a difficulty may make
+  virtual int maxShuffleMoves() const {
+    return MAX_SHUFFLE_MOVES;
   }
 
   bool hasBorder() {
@@ -253,6 +390,23 @@ struct Mesh {
   std::shared_ptr<TQuadVertexBuffer> vertexBufferAnchors;
   std::vector<AnchorTile> anchorTiles;
   std::vector<TileGroup<T>> tileGroupAnchors;
+  std::vector<int> groupIndex;
+  size_t groupIndexed = 0;
+  int groupRows = 0;
+  int groupColumns = 0;
+  SpatialGrid anchorGrid;
+
+  // picking index over tile bounds; stale after geometry changes outside syncTiles
+  SpatialGrid tileGrid;
+  bool hitGridStale = true;
+  // every tile's hit shape by tile index, and the candidates of the latest hitTestPoints
+  typename T::HitBatch hitShapes;
+  typename T::HitBatch hitCandidates;
+  std::vector<int> hitItems;
+
+  BoardState state;
+  static constexpr int MAX_SHUFFLE_MOVES = 400;
+  bool tilesDirty = false;
 
 #ifdef USE_SDL
   Logger L;
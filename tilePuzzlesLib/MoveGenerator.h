@@ -0,0 +1,195 @@
+#ifndef _MOVE_GENERATOR_H_
+#define _MOVE_GENERATOR_H_
+
+#include "BoardState.h"
+#include "enums.h"
+
+#include <cstdint>
+
+namespace tilepuzzles {
+
+/*
+ * Moves packed into 32 bits:
+ *   bits 28..31 kind
+ *   bits  0..13 slide: slot the tile slides from; roll: row or column;
+ *               rotate: anchor index; group roll: group row or column
+ *   bits 14..27 slide: blank slot before the move; roll/group roll: Direction;
+ *               rotate: 0 for +60 degrees, 1 for -60 degrees
+ */
+using Move = uint32_t;
+
+enum MoveKind { SlideMove, RollMove, RotateMove, GroupRollMove };
+
+struct MoveGenerator {
+  static constexpr Move slide(int slot, int blank) {
+    return (Move(MoveKind::SlideMove) << KIND_SHIFT) | (Move(blank) << ARG_SHIFT) | Move(slot);
+  }
+
+  static constexpr Move roll(int line, Direction dir) {
+    return (Move(MoveKind::RollMove) << KIND_SHIFT) | (Move(dir) << ARG_SHIFT) | Move(line);
+  }
+
+  static constexpr Move rotate(int anchor, int steps) {
+    return (Move(MoveKind::RotateMove) << KIND_SHIFT) | (Move(steps < 0) << ARG_SHIFT) | Move(anchor);
+  }
+
+  static constexpr Move rollGroups(int line, Direction dir) {
+    return (Move(MoveKind::GroupRollMove) << KIND_SHIFT) | (Move(dir) << ARG_SHIFT) | Move(line);
+  }
+
+  static constexpr MoveKind kind(Move move) {
+    return MoveKind(move >> KIND_SHIFT);
+  }
+
+  static constexpr int index(Move move) {
+    return move & INDEX_MASK;
+  }
+
+  static constexpr int arg(Move move) {
+    return (move >> ARG_SHIFT) & INDEX_MASK;
+  }
+
+  static constexpr Direction direction(Move move) {
+    return Direction(arg(move));
+  }
+
+  static constexpr int steps(Move move) {
+    return arg(move) ? -1 : 1;
+  }
+
+  static constexpr Direction opposite(Direction dir) {
+    switch (dir) {
+      case Direction::left:
+        return Direction::right;
+      case Direction::right:
+        return Direction::left;
+      case Direction::up:
+        return Direction::down;
+      case Direction::down:
+        return Direction::up;
+      default:
+        return Direction::none;
+    }
+  }
+
+  static constexpr Move inverse(Move move) {
+    switch (kind(move)) {
+      case MoveKind::SlideMove:
+        return slide(arg(move), index(move));
+      case MoveKind::RollMove:
+        return roll(index(move), opposite(direction(move)));
+      case MoveKind::RotateMove:
+        return rotate(index(move), -steps(move));
+      case MoveKind::GroupRollMove:
+        return rollGroups(index(move), opposite(direction(move)));
+    }
+    return move;
+  }
+
+  // upper bound for the number of moves generate() writes
+  static int maxMoves(const BoardState& state) {
+    switch (state.type) {
+      case PuzzleType::SliderPuzzle:
+        return state.rows + state.columns - 2;
+      case PuzzleType::RollerPuzzle:
+        return 2 * (state.rows + state.columns);
+      default:
+        return 2 * state.topology->anchors.size() + 2 * (state.rows + state.columns);
+    }
+  }
+
+  // writes every legal move of state into moves, returns the move count; no allocation
+  static int generate(const BoardState& state, Move* moves) {
+    int count = 0;
+    switch (state.type) {
+      case PuzzleType::SliderPuzzle: {
+        const int blankRow = state.blank / state.columns;
+        const int blankCol = state.blank % state.columns;
+        for (int c = 0; c < state.columns; ++c) {
+          if (c != blankCol) {
+            moves[count++] = slide(blankRow * state.columns + c, state.blank);
+          }
+        }
+        for (int r = 0; r < state.rows; ++r) {
+          if (r != blankRow) {
+            moves[count++] = slide(r * state.columns + blankCol, state.blank);
+          }
+        }
+        break;
+      }
+      case PuzzleType::RollerPuzzle: {
+        count = generateLines(state.rows, state.columns, moves, count, roll);
+        break;
+      }
+      default: {
+        const int anchCount = state.topology->anchors.size();
+        for (int a = 0; a < anchCount; ++a) {
+          moves[count++] = rotate(a, 1);
+          moves[count++] = rotate(a, -1);
+        }
+        count = generateLines(state.rows, state.columns, moves, count, rollGroups);
+        break;
+      }
+    }
+    return count;
+  }
+
+  static void apply(BoardState& state, Move move) {
+    switch (kind(move)) {
+      case MoveKind::SlideMove:
+        state.slide(index(move));
+        break;
+      case MoveKind::RollMove: {
+        const Direction dir = direction(move);
+        if (dir == Direction::left || dir == Direction::right) {
+          state.rollRow(index(move), dir == Direction::right ? 1 : -1);
+        } else {
+          state.rollColumn(index(move), dir == Direction::down ? 1 : -1);
+        }
+        break;
+      }
+      case MoveKind::RotateMove:
+        state.rotateAnchor(index(move), steps(move));
+        break;
+      case MoveKind::GroupRollMove: {
+        const Direction dir = direction(move);
+        if (dir == Direction::left || dir == Direction::right) {
+          state.rollGroups(index(move), 0, dir);
+        } else {
+          state.rollGroups(0, index(move), dir);
+        }
+        break;
+      }
+    }
+  }
+
+  static void unapply(BoardState& state, Move move) {
+    apply(state, inverse(move));
+  }
+
+  static constexpr int KIND_SHIFT = 28;
+  static constexpr int ARG_SHIFT = 14;
+  static constexpr Move INDEX_MASK = (1 << ARG_SHIFT) - 1;
+
+private:
+  // rows roll left/right, columns roll up/down; lines of two only need one direction
+  template <typename F>
+  static int generateLines(int rows, int columns, Move* moves, int count, F make) {
+    for (int r = 0; r < rows && columns > 1; ++r) {
+      moves[count++] = make(r, Direction::right);
+      if (columns > 2) {
+        moves[count++] = make(r, Direction::left);
+      }
+    }
+    for (int c = 0; c < columns && rows > 1; ++c) {
+      moves[count++] = make(c, Direction::down);
+      if (rows > 2) {
+        moves[count++] = make(c, Direction::up);
+      }
+    }
+    return count;
+  }
+};
+
+} // namespace tilepuzzles
+#endif
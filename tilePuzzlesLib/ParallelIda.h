@@ -0,0 +1,523 @@
+#ifndef _PARALLEL_IDA_H_
+#define _PARALLEL_IDA_H_
+
+#include "BoardState.h"
+#include "BoardSymmetry.h"
+#include "MoveGenerator.h"
+#include "SliderSolver.h"
+#include "TranspositionTable.h"
+#include "Zobrist.h"
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <deque>
+#include <limits>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace tilepuzzles {
+
+/*
+ * Search domains for ParallelIdaSolver. A domain owns the move set and the
+ * heuristic:
+ *   Node node(state), Value evaluate(node), bool isGoal(node, value),
+ *   int expand(node, last, moves) writes the moves worth trying after last,
+ *   Value apply(node, value, move) applies move and returns the new value,
+ *   void undo(node, move), uint64_t hash(node),
+ *   uint64_t tableKey(node, last) for the transposition table. Keys are
+ *   shared with the board's diagonal reflection, which keeps move order
+ *   and distances, so one entry serves both, and BoardSymmetry mixes in
+ *   the puzzle type and dimensions, so boards of other shapes sharing the
+ *   table never hit them.
+ */
+template <typename H = SliderHeuristic>
+struct SliderDomain {
+  using Node = SliderNode;
+  using Value = typename H::Value;
+
+  SliderDomain(int rows, int columns, const H& heuristic)
+      : rows(rows), columns(columns), heuristic(heuristic),
+        symmetry(&BoardSymmetry::get(PuzzleType::SliderPuzzle, rows, columns)) {
+  }
+
+  int maxMoves() const {
+    return 4;
+  }
+
+  Node node(const BoardState& state) const {
+    return SliderNode(state);
+  }
+
+  Value evaluate(const Node& node) const {
+    return heuristic.evaluate(node);
+  }
+
+  bool isGoal(const Node& node, const Value& value) const {
+    return value.h() == 0 && node.isGoal();
+  }
+
+  // single tile moves into the blank, never straight back
+  int expand(const Node& node, Move last, Move* moves) const {
+    const int blank = node.blank;
+    const int previous = last == NO_MOVE ? -1 : MoveGenerator::arg(last);
+    const int r = blank / columns;
+    const int c = blank % columns;
+    int count = 0;
+    for (int slot : {r > 0 ? blank - columns : -1, r < rows - 1 ? blank + columns : -1, c > 0 ? blank - 1 : -1,
+                     c < columns - 1 ? blank + 1 : -1}) {
+      if (slot >= 0 && slot != previous) {
+        moves[count++] = MoveGenerator::slide(slot, blank);
+      }
+    }
+    return count;
+  }
+
+  Value apply(Node& node, const Value& value, Move move) const {
+    const int slot = MoveGenerator::index(move);
+    const int tile = node.tiles[slot];
+    node.slide(slot);
+    return heuristic.update(node, value, tile, slot, MoveGenerator::arg(move));
+  }
+
+  void undo(Node& node, Move move) const {
+    node.slide(MoveGenerator::arg(move));
+  }
+
+  // only needed with a transposition table, so SliderNode does not keep one up to date
+  uint64_t hash(const Node& node) const {
+    uint64_t h = 0;
+    for (int s = 0; s < node.size; ++s) {
+      h ^= Zobrist::key(node.tiles[s], s);
+    }
+    return h;
+  }
+
+  uint64_t tableKey(const Node& node, Move last) const {
+    return symmetry->tableKey(node.tiles.data(), node.size, last, NO_MOVE);
+  }
+
+  static constexpr Move NO_MOVE = ~Move(0);
+
+  int rows;
+  int columns;
+  H heuristic;
+  const BoardSymmetry* symmetry;
+};
+
+/*
+ * Roller lower bound. A row roll moves columns tiles one step sideways and
+ * nothing vertically, so the row rolls needed are at least the summed cyclic
+ * column distance / columns and at least any single tile's column distance;
+ * likewise for column rolls.
+ */
+struct RollerHeuristic {
+  struct Value {
+    int16_t total = 0;
+
+    int h() const {
+      return total;
+    }
+  };
+
+  static int cyclic(int a, int b, int length) {
+    const int d = std::abs(a - b);
+    return std::min(d, length - d);
+  }
+
+  Value evaluate(const BoardState& state) const {
+    int sumH = 0;
+    int sumV = 0;
+    int maxH = 0;
+    int maxV = 0;
+    for (int s = 0; s < state.size(); ++s) {
+      const int tile = state.slots[s];
+      const int dh = cyclic(tile % state.columns, s % state.columns, state.columns);
+      const int dv = cyclic(tile / state.columns, s / state.columns, state.rows);
+      sumH += dh;
+      sumV += dv;
+      maxH = std::max(maxH, dh);
+      maxV = std::max(maxV, dv);
+    }
+    Value v;
+    v.total = std::max(maxH, (sumH + state.columns - 1) / state.columns) +
+              std::max(maxV, (sumV + state.rows - 1) / state.rows);
+    return v;
+  }
+};
+
+struct RollerDomain {
+  using Node = BoardState;
+  using Value = RollerHeuristic::Value;
+
+  RollerDomain(int rows, int columns)
+      : rows(rows), columns(columns), symmetry(&BoardSymmetry::get(PuzzleType::RollerPuzzle, rows, columns)) {
+  }
+
+  int maxMoves() const {
+    return 2 * (rows + columns);
+  }
+
+  Node node(const BoardState& state) const {
+    return state;
+  }
+
+  Value evaluate(const Node& node) const {
+    return heuristic.evaluate(node);
+  }
+
+  bool isGoal(const Node& node, const Value& value) const {
+    return value.h() == 0 && node.isSolved();
+  }
+
+  /*
+   * Skips undoing the last roll (repeating it on a line of two), and since
+   * rolls of different rows (or of different columns) commute, only tries
+   * them in increasing line order.
+   */
+  int expand(const Node& node, Move last, Move* moves) const {
+    const int count = MoveGenerator::generate(node, moves);
+    if (last == NO_MOVE) {
+      return count;
+    }
+    const Move undo = MoveGenerator::inverse(last);
+    const bool lastHorizontal = horizontal(last);
+    int kept = 0;
+    for (int i = 0; i < count; ++i) {
+      const Move move = moves[i];
+      if (move == undo || (move == last && lineLength(move) == 2) ||
+          (horizontal(move) == lastHorizontal && MoveGenerator::index(move) < MoveGenerator::index(last))) {
+        continue;
+      }
+      moves[kept++] = move;
+    }
+    return kept;
+  }
+
+  Value apply(Node& node, const Value& value, Move move) const {
+    MoveGenerator::apply(node, move);
+    return heuristic.evaluate(node);
+  }
+
+  void undo(Node& node, Move move) const {
+    MoveGenerator::unapply(node, move);
+  }
+
+  uint64_t hash(const Node& node) const {
+    return node.hash;
+  }
+
+  uint64_t tableKey(const Node& node, Move last) const {
+    return symmetry->tableKey(node.slots.data(), node.size(), last, NO_MOVE);
+  }
+
+  int lineLength(Move move) const {
+    return horizontal(move) ? columns : rows;
+  }
+
+  static bool horizontal(Move move) {
+    const Direction dir = MoveGenerator::direction(move);
+    return dir == Direction::left || dir == Direction::right;
+  }
+
+  static constexpr Move NO_MOVE = ~Move(0);
+
+  int rows;
+  int columns;
+  RollerHeuristic heuristic;
+  const BoardSymmetry* symmetry;
+};
+
+// owner pushes and pops at the back, idle threads steal from the front
+template <typename T>
+struct WorkStealingDeque {
+  void push(const T& item) {
+    std::lock_guard<std::mutex> lock(mutex);
+    items.push_back(item);
+  }
+
+  bool pop(T& item) {
+    std::lock_guard<std::mutex> lock(mutex);
+    if (items.empty()) {
+      return false;
+    }
+    item = items.back();
+    items.pop_back();
+    return true;
+  }
+
+  bool steal(T& item) {
+    std::lock_guard<std::mutex> lock(mutex);
+    if (items.empty()) {
+      return false;
+    }
+    item = items.front();
+    items.pop_front();
+    return true;
+  }
+
+  std::mutex mutex;
+  std::deque<T> items;
+};
+
+/*
+ * IDA* across threads. Every iteration enumerates the tree down to a split
+ * depth deep enough for ITEMS_PER_THREAD subtrees per thread, deals the
+ * subtrees round robin into per thread deques and lets idle threads steal.
+ * A solution at the current bound is optimal, so the first thread to find
+ * one stops the rest.
+ *
+ * With a table set, every fully searched node stores the lower bound its
+ * subtree proved, keyed by hash, board shape and the move that led to it
+ * (the move decides which children expand() prunes), and later visits from
+ * any thread or any other search on the same table cut off on it.
+ */
+template <typename Domain>
+struct ParallelIdaSolver {
+  static constexpr int MAX_DEPTH = 256;
+  static constexpr int MAX_SPLIT = 16;
+  static constexpr int ITEMS_PER_THREAD = 16;
+
+  using Node = typename Domain::Node;
+  using Value = typename Domain::Value;
+
+  ParallelIdaSolver(const Domain& domain, int threads = std::thread::hardware_concurrency())
+      : domain(domain), threads(std::max(threads, 1)) {
+  }
+
+  SolveResult solve(const BoardState& start, uint64_t nodeLimit = 0, const std::atomic<bool>* cancel = nullptr) {
+    auto startTime = std::chrono::steady_clock::now();
+    SolveResult result;
+    root = domain.node(start);
+    rootValue = domain.evaluate(root);
+    limit = nodeLimit;
+    stop = cancel;
+    totalNodes = 0;
+    aborted = false;
+    threadNodes.assign(threads, 0);
+    if (table) {
+      table->newSearch();
+    }
+
+    int bound = rootValue.h();
+    if (domain.isGoal(root, rootValue)) {
+      result.solved = true;
+      bound = MAX_DEPTH;
+    }
+    while (bound < MAX_DEPTH && !aborted) {
+      found = false;
+      nextBound = std::numeric_limits<int>::max();
+      iterate(bound);
+      if (found) {
+        result.solved = true;
+        result.moves = solution;
+        break;
+      }
+      if (nextBound == std::numeric_limits<int>::max()) {
+        break;
+      }
+      bound = nextBound;
+    }
+    for (uint64_t n : threadNodes) {
+      result.nodes += n;
+    }
+    result.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - startTime).count();
+    return result;
+  }
+
+  Domain domain;
+  int threads;
+  // nodes expanded by each thread in the last solve(); thread 0 also splits the tree
+  std::vector<uint64_t> threadNodes;
+  // optional, usually TranspositionTable::shared()
+  TranspositionTable* table = nullptr;
+  int splitDepth = 0;
+
+private:
+  struct WorkItem {
+    std::array<Move, MAX_SPLIT> moves;
+    int depth = 0;
+  };
+
+  struct Worker {
+    Node node;
+    std::array<Move, MAX_DEPTH> path;
+    std::vector<Move> moves;
+    uint64_t nodes = 0;
+    uint64_t reported = 0;
+  };
+
+  void iterate(int bound) {
+    std::vector<WorkItem> items;
+    Worker splitter = makeWorker();
+    for (splitDepth = 1;; ++splitDepth) {
+      items.clear();
+      WorkItem item;
+      split(splitter, rootValue, item, Domain::NO_MOVE, bound, items);
+      if (found || items.size() >= threads * ITEMS_PER_THREAD || splitDepth >= std::min(MAX_SPLIT, bound)) {
+        break;
+      }
+    }
+    threadNodes[0] += splitter.nodes;
+    if (found) {
+      return;
+    }
+
+    std::vector<WorkStealingDeque<WorkItem>> deques(threads);
+    for (size_t i = 0; i < items.size(); ++i) {
+      deques[i % threads].push(items[i]);
+    }
+    std::vector<std::thread> workers;
+    for (int t = 1; t < threads; ++t) {
+      workers.emplace_back([this, t, bound, &deques]() { work(t, bound, deques); });
+    }
+    work(0, bound, deques);
+    for (auto& w : workers) {
+      w.join();
+    }
+  }
+
+  Worker makeWorker() const {
+    Worker worker;
+    worker.node = root;
+    worker.moves.resize((MAX_DEPTH + 1) * domain.maxMoves());
+    return worker;
+  }
+
+  // collects the nodes at splitDepth whose f is within bound
+  void split(Worker& worker, const Value& value, WorkItem& item, Move last, int bound, std::vector<WorkItem>& out) {
+    const int f = item.depth + value.h();
+    if (f > bound) {
+      lowerNextBound(f);
+      return;
+    }
+    if (domain.isGoal(worker.node, value)) {
+      publish(item.moves.data(), item.depth);
+      return;
+    }
+    if (item.depth == splitDepth) {
+      out.push_back(item);
+      return;
+    }
+    ++worker.nodes;
+    Move* moves = &worker.moves[item.depth * domain.maxMoves()];
+    const int count = domain.expand(worker.node, last, moves);
+    for (int i = 0; i < count && !found; ++i) {
+      const Value next = domain.apply(worker.node, value, moves[i]);
+      item.moves[item.depth++] = moves[i];
+      split(worker, next, item, moves[i], bound, out);
+      --item.depth;
+      domain.undo(worker.node, moves[i]);
+    }
+  }
+
+  void work(int thread, int bound, std::vector<WorkStealingDeque<WorkItem>>& deques) {
+    Worker worker = makeWorker();
+    WorkItem item;
+    while (!found && !aborted && nextItem(thread, deques, item)) {
+      Value value = rootValue;
+      for (int d = 0; d < item.depth; ++d) {
+        value = domain.apply(worker.node, value, item.moves[d]);
+        worker.path[d] = item.moves[d];
+      }
+      lowerNextBound(search(worker, value, item.depth, bound, item.moves[item.depth - 1]));
+      for (int d = item.depth - 1; d >= 0; --d) {
+        domain.undo(worker.node, item.moves[d]);
+      }
+    }
+    threadNodes[thread] += worker.nodes;
+  }
+
+  bool nextItem(int thread, std::vector<WorkStealingDeque<WorkItem>>& deques, WorkItem& item) {
+    if (deques[thread].pop(item)) {
+      return true;
+    }
+    for (int i = 1; i < threads; ++i) {
+      if (deques[(thread + i) % threads].steal(item)) {
+        return true;
+      }
+    }
+    return false;
+  }
+
+  // returns the smallest f beyond bound below this node
+  int search(Worker& worker, const Value& value, int g, int bound, Move last) {
+    int f = g + value.h();
+    uint64_t key = 0;
+    TTEntry entry;
+    if (table) {
+      key = domain.tableKey(worker.node, last);
+      if (table->probe(key, entry)) {
+        f = std::max(f, g + entry.bound);
+      }
+    }
+    if (f > bound) {
+      return f;
+    }
+    if (domain.isGoal(worker.node, value)) {
+      publish(worker.path.data(), g);
+      return f;
+    }
+    if ((++worker.nodes & 0xfff) == 0) {
+      const uint64_t total = totalNodes.fetch_add(worker.nodes - worker.reported) + worker.nodes - worker.reported;
+      worker.reported = worker.nodes;
+      if ((limit && total >= limit) || (stop && stop->load(std::memory_order_relaxed))) {
+        aborted = true;
+      }
+    }
+    if (found.load(std::memory_order_relaxed) || aborted.load(std::memory_order_relaxed)) {
+      return std::numeric_limits<int>::max();
+    }
+    int min = std::numeric_limits<int>::max();
+    Move* moves = &worker.moves[g * domain.maxMoves()];
+    const int count = domain.expand(worker.node, last, moves);
+    for (int i = 0; i < count; ++i) {
+      const Value next = domain.apply(worker.node, value, moves[i]);
+      worker.path[g] = moves[i];
+      const int t = search(worker, next, g + 1, bound, moves[i]);
+      domain.undo(worker.node, moves[i]);
+      if (found.load(std::memory_order_relaxed)) {
+        return min;
+      }
+      min = std::min(min, t);
+    }
+    if (table && !aborted.load(std::memory_order_relaxed)) {
+      entry.bound = std::min(min, MAX_DEPTH + g) - g;
+      entry.depth = std::min(bound - g, 255);
+      table->store(key, entry);
+    }
+    return min;
+  }
+
+  void publish(const Move* path, int length) {
+    std::lock_guard<std::mutex> lock(solutionMutex);
+    if (!found) {
+      solution.assign(path, path + length);
+      found = true;
+    }
+  }
+
+  void lowerNextBound(int f) {
+    int current = nextBound.load(std::memory_order_relaxed);
+    while (f < current && !nextBound.compare_exchange_weak(current, f, std::memory_order_relaxed)) {
+    }
+  }
+
+  Node root;
+  Value rootValue;
+  uint64_t limit = 0;
+  const std::atomic<bool>* stop = nullptr;
+  std::atomic<uint64_t> totalNodes = 0;
+  std::atomic<bool> aborted = false;
+  std::atomic<bool> found = false;
+  std::atomic<int> nextBound = 0;
+  std::mutex solutionMutex;
+  std::vector<Move> solution;
+};
+
+} // namespace tilepuzzles
+#endif
@@ -0,0 +1,710 @@
+#ifndef _PATTERN_DB_H_
+#define _PATTERN_DB_H_
+
+#ifdef USE_SDL
+#include "GLogger.h"
+#endif
+
+#include "PermRank.h"
+#include "SliderSolver.h"
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <functional>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace tilepuzzles {
+
+/*
+ * Additive disjoint pattern databases for the slider. A pattern is a set of
+ * tiles; its table holds, for every placement of those tiles, the fewest
+ * moves of pattern tiles needed to bring them home. Moves of other tiles are
+ * free, so the tables of disjoint patterns can be summed and stay admissible.
+ *
+ * Tables are indexed by PermRank::partialRank of the pattern tiles' slots.
+ */
+struct PatternDbProgress {
+  int distance = 0;
+  uint64_t layerStates = 0;
+  uint64_t visitedStates = 0;
+  uint64_t stateSpace = 0;
+  double seconds = 0.;
+
+  double statesPerSecond() const {
+    return seconds > 0. ? visitedStates / seconds : 0.;
+  }
+};
+
+using PatternDbProgressFn = std::function<void(const PatternDbProgress&)>;
+
+// visited marks shared by the builder threads; claim() succeeds for exactly one caller per bit
+struct AtomicBitset {
+  AtomicBitset(uint64_t bits) : words((bits + 63) / 64) {
+  }
+
+  bool claim(uint64_t index) {
+    std::atomic<uint64_t>& word = words[index >> 6];
+    const uint64_t mask = uint64_t(1) << (index & 63);
+    if (word.load(std::memory_order_relaxed) & mask) {
+      return false;
+    }
+    return !(word.fetch_or(mask, std::memory_order_relaxed) & mask);
+  }
+
+  std::vector<std::atomic<uint64_t>> words;
+};
+
+struct PatternDbBuilder {
+  static constexpr uint8_t UNSEEN = 0xff;
+  static constexpr size_t CHUNK = 4096;
+
+  /*
+   * Breadth first search over placements of the pattern tiles plus the blank,
+   * one distance layer at a time: first the closure of the layer under free
+   * blank moves, then the pattern tile moves that open the next layer. Layers
+   * are final once closed, so the first distance written for a placement is
+   * its minimum over all blank positions.
+   *
+   * Each pass over a layer is split into CHUNK sized pieces shared by threads
+   * workers. Every placement still lands in the same layer whatever the
+   * interleaving, so the table is byte identical for any thread count.
+   */
+  static std::vector<uint8_t> buildTable(int rows, int columns, const std::vector<uint8_t>& tiles, int threads = 1,
+                                         const PatternDbProgressFn& progress = nullptr) {
+    auto startTime = std::chrono::steady_clock::now();
+    const int n = rows * columns;
+    const int k = tiles.size();
+    threads = std::max(threads, 1);
+    std::vector<uint8_t> table(PermRank::partialCount(n, k), UNSEEN);
+    AtomicBitset visited(PermRank::partialCount(n, k + 1));
+
+    std::array<uint8_t, SliderNode::MAX_SLOTS> goal;
+    for (int i = 0; i < k; ++i) {
+      goal[i] = tiles[i];
+    }
+    goal[k] = n - 1;
+    std::vector<uint64_t> layer = {PermRank::partialRank(goal.data(), k + 1, n)};
+    visited.claim(layer[0]);
+
+    PatternDbProgress status;
+    status.stateSpace = PermRank::partialCount(n, k + 1);
+    std::vector<std::vector<uint64_t>> found(threads);
+    std::vector<uint64_t> next;
+    for (int distance = 0; !layer.empty(); ++distance) {
+      for (size_t begin = 0; begin < layer.size();) {
+        const size_t end = layer.size();
+        parallelFor(begin, end, threads, [&](size_t i, int thread) {
+          expand(rows, columns, k, layer[i], false, visited, found[thread]);
+        });
+        gather(found, layer);
+        begin = end;
+      }
+      parallelFor(0, layer.size(), threads, [&](size_t i, int thread) {
+        std::atomic_ref<uint8_t> entry(table[layer[i] / (n - k)]);
+        if (entry.load(std::memory_order_relaxed) == UNSEEN) {
+          entry.store(distance, std::memory_order_relaxed);
+        }
+      });
+      next.clear();
+      parallelFor(0, layer.size(), threads, [&](size_t i, int thread) {
+        expand(rows, columns, k, layer[i], true, visited, found[thread]);
+      });
+      gather(found, next);
+
+      status.distance = distance;
+      status.layerStates = layer.size();
+      status.visitedStates += layer.size();
+      status.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - startTime).count();
+      if (progress) {
+        progress(status);
+      }
+      layer.swap(next);
+    }
+    return table;
+  }
+
+  /*
+   * Appends the unvisited neighbors of the placement ranked index reached by
+   * a free blank move, or by moving a pattern tile when tileMoves is set.
+   */
+  static void expand(int rows, int columns, int k, uint64_t index, bool tileMoves, AtomicBitset& visited,
+                     std::vector<uint64_t>& out) {
+    const int n = rows * columns;
+    std::array<uint8_t, SliderNode::MAX_SLOTS> positions;
+    PermRank::partialUnrank(index, k + 1, n, positions.data());
+    std::array<int8_t, SliderNode::MAX_SLOTS> occupant;
+    occupant.fill(-1);
+    for (int i = 0; i < k; ++i) {
+      occupant[positions[i]] = i;
+    }
+    const int blank = positions[k];
+    const int r = blank / columns;
+    const int c = blank % columns;
+    for (int slot : {r > 0 ? blank - columns : -1, r < rows - 1 ? blank + columns : -1, c > 0 ? blank - 1 : -1,
+                     c < columns - 1 ? blank + 1 : -1}) {
+      if (slot < 0 || (occupant[slot] >= 0) != tileMoves) {
+        continue;
+      }
+      if (tileMoves) {
+        positions[occupant[slot]] = blank;
+      }
+      positions[k] = slot;
+      const uint64_t neighbor = PermRank::partialRank(positions.data(), k + 1, n);
+      if (visited.claim(neighbor)) {
+        out.push_back(neighbor);
+      }
+      if (tileMoves) {
+        positions[occupant[slot]] = slot;
+      }
+      positions[k] = blank;
+    }
+  }
+
+  // runs fn(i, thread) for i in [begin, end), threads workers taking CHUNK sized pieces
+  template <typename F>
+  static void parallelFor(size_t begin, size_t end, int threads, F fn) {
+    if (threads <= 1 || end - begin <= CHUNK) {
+      for (size_t i = begin; i < end; ++i) {
+        fn(i, 0);
+      }
+      return;
+    }
+    std::atomic<size_t> nextChunk(begin);
+    auto worker = [&](int thread) {
+      for (size_t first; (first = nextChunk.fetch_add(CHUNK)) < end;) {
+        const size_t last = std::min(first + CHUNK, end);
+        for (size_t i = first; i < last; ++i) {
+          fn(i, thread);
+        }
+      }
+    };
+    std::vector<std::thread> workers;
+    for (int t = 1; t < threads; ++t) {
+      workers.emplace_back(worker, t);
+    }
+    worker(0);
+    for (auto& w : workers) {
+      w.join();
+    }
+  }
+
+private:
+  static void gather(std::vector<std::vector<uint64_t>>& found, std::vector<uint64_t>& out) {
+    for (auto& f : found) {
+      out.insert(out.end(), f.begin(), f.end());
+      f.clear();
+    }
+  }
+};
+
+/*
+ * Set of pattern tables for one board size. build() keeps the tables in
+ * memory; open() maps a file written by save() read-only, so every solver
+ * process shares the page cache copy and startup costs one mmap. encode()
+ * repacks built byte tables with a compressed storage policy.
+ *
+ * File layout, little endian:
+ *   PatternDbHeader
+ *   PatternDbEntry[patternCount]
+ *   tables, each starting on a PAGE_ALIGN boundary
+ */
+struct PatternDbHeader {
+  char magic[8];
+  uint32_t version;
+  uint32_t rows;
+  uint32_t columns;
+  uint32_t patternCount;
+  uint32_t encoding;
+  uint32_t reserved;
+};
+
+struct PatternDbEntry {
+  uint32_t tileCount;
+  uint8_t tiles[32];
+  uint64_t offset;
+  uint64_t entries;
+  uint64_t bytes;
+};
+
+struct PatternDb {
+  static constexpr char MAGIC[8] = {'T', 'P', 'P', 'D', 'B', 0, 0, 0};
+  static constexpr uint32_t VERSION = 1;
+  static constexpr uint32_t BYTE_ENCODING = 0;
+  static constexpr uint32_t NIBBLE_ENCODING = 1;
+  static constexpr uint32_t MOD3_ENCODING = 2;
+  static constexpr uint64_t PAGE_ALIGN = 4096;
+  // values a heuristic keeps per node, one per pattern
+  static constexpr int MAX_PATTERNS = 16;
+
+  PatternDb() {
+  }
+
+  PatternDb(const PatternDb&) = delete;
+  PatternDb& operator=(const PatternDb&) = delete;
+
+  ~PatternDb() {
+    close();
+  }
+
+  // 6-6-3 for 4x4 and 6-6-6-6 for 5x5, otherwise row-major runs of at most 6 tiles
+  static std::vector<std::vector<uint8_t>> defaultPatterns(int rows, int columns) {
+    if (rows == 4 && columns == 4) {
+      return {{3, 6, 7, 10, 11, 14}, {4, 5, 8, 9, 12, 13}, {0, 1, 2}};
+    }
+    if (rows == 5 && columns == 5) {
+      return {{12, 17, 18, 19, 22, 23}, {10, 11, 15, 16, 20, 21}, {3, 4, 8, 9, 13, 14}, {0, 1, 2, 5, 6, 7}};
+    }
+    std::vector<std::vector<uint8_t>> patterns;
+    for (int tile = 0; tile < rows * columns - 1; ++tile) {
+      if (tile % 6 == 0) {
+        patterns.emplace_back();
+      }
+      patterns.back().push_back(tile);
+    }
+    return patterns;
+  }
+
+  void build(int rows, int columns, const std::vector<std::vector<uint8_t>>& patterns, int threads = 1,
+             const PatternDbProgressFn& progress = nullptr) {
+    close();
+    this->rows = rows;
+    this->columns = columns;
+    this->patterns = patterns;
+    initDistances();
+    owned.clear();
+    for (const auto& tiles : patterns) {
+      owned.push_back(PatternDbBuilder::buildTable(rows, columns, tiles, threads, progress));
+    }
+    encoding = BYTE_ENCODING;
+    tables.clear();
+    for (const auto& table : owned) {
+      tables.push_back(table.data());
+    }
+  }
+
+  // repacks the byte tables of a build() with Storage
+  template <typename Storage>
+  void encode() {
+    if (encoding != BYTE_ENCODING || owned.size() != patterns.size()) {
+      return;
+    }
+    for (int p = 0; p < patterns.size(); ++p) {
+      owned[p] = Storage::encode(*this, p);
+      tables[p] = owned[p].data();
+    }
+    encoding = Storage::ENCODING;
+  }
+
+  bool save(const std::string& path) const {
+    FILE* file = std::fopen(path.c_str(), "wb");
+    if (!file) {
+      return false;
+    }
+    PatternDbHeader header = {};
+    std::memcpy(header.magic, MAGIC, sizeof(MAGIC));
+    header.version = VERSION;
+    header.rows = rows;
+    header.columns = columns;
+    header.patternCount = patterns.size();
+    header.encoding = encoding;
+    bool ok = std::fwrite(&header, sizeof(header), 1, file) == 1;
+
+    uint64_t offset = alignUp(sizeof(PatternDbHeader) + patterns.size() * sizeof(PatternDbEntry));
+    for (int p = 0; p < patterns.size(); ++p) {
+      PatternDbEntry entry = {};
+      entry.tileCount = patterns[p].size();
+      std::copy(patterns[p].begin(), patterns[p].end(), entry.tiles);
+      entry.offset = offset;
+      entry.entries = tableSize(p);
+      entry.bytes = tableBytes(p);
+      ok = ok && std::fwrite(&entry, sizeof(entry), 1, file) == 1;
+      offset = alignUp(offset + entry.bytes);
+    }
+    for (int p = 0; p < patterns.size(); ++p) {
+      ok = ok && std::fseek(file, 0, SEEK_END) == 0;
+      const long padding = alignUp(std::ftell(file)) - std::ftell(file);
+      static const std::array<uint8_t, PAGE_ALIGN> zeros = {};
+      ok = ok && std::fwrite(zeros.data(), 1, padding, file) == padding;
+      ok = ok && std::fwrite(tables[p], 1, tableBytes(p), file) == tableBytes(p);
+    }
+    return std::fclose(file) == 0 && ok;
+  }
+
+  bool open(const std::string& path) {
+    close();
+    int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0) {
+      return fail("cannot open", path);
+    }
+    struct stat info;
+    if (fstat(fd, &info) != 0 || info.st_size < sizeof(PatternDbHeader)) {
+      ::close(fd);
+      return fail("truncated", path);
+    }
+    void* data = mmap(nullptr, info.st_size, PROT_READ, MAP_SHARED, fd, 0);
+    ::close(fd);
+    if (data == MAP_FAILED) {
+      return fail("cannot map", path);
+    }
+    mapped = static_cast<const uint8_t*>(data);
+    mappedSize = info.st_size;
+
+    const PatternDbHeader* header = reinterpret_cast<const PatternDbHeader*>(mapped);
+    if (std::memcmp(header->magic, MAGIC, sizeof(MAGIC)) != 0 || header->version != VERSION ||
+        header->encoding > MOD3_ENCODING || header->patternCount > MAX_PATTERNS ||
+        sizeof(PatternDbHeader) + header->patternCount * sizeof(PatternDbEntry) > mappedSize) {
+      close();
+      return fail("unsupported format", path);
+    }
+    // sizes and tile ids index fixed arrays, so check them before anything is filled in
+    const uint64_t slots = uint64_t(header->rows) * header->columns;
+    if (header->rows == 0 || header->columns == 0 || slots > SliderNode::MAX_SLOTS) {
+      close();
+      return fail("unsupported board", path);
+    }
+    rows = header->rows;
+    columns = header->columns;
+    encoding = header->encoding;
+    initDistances();
+    const PatternDbEntry* entries = reinterpret_cast<const PatternDbEntry*>(header + 1);
+    // a tile in two patterns would be counted twice and the sum overestimate
+    uint64_t used = 0;
+    for (int p = 0; p < header->patternCount; ++p) {
+      const PatternDbEntry& entry = entries[p];
+      if (entry.tileCount == 0 || entry.tileCount >= slots || entry.tileCount > sizeof(entry.tiles) ||
+          std::any_of(entry.tiles, entry.tiles + entry.tileCount, [slots, &used](uint8_t tile) {
+            if (tile >= slots || (used >> tile & 1)) {
+              return true;
+            }
+            used |= uint64_t(1) << tile;
+            return false;
+          })) {
+        close();
+        return fail("corrupt pattern", path);
+      }
+      patterns.emplace_back(entry.tiles, entry.tiles + entry.tileCount);
+      if (entry.offset + entry.bytes > mappedSize || entry.entries != tableSize(p) || entry.bytes != tableBytes(p)) {
+        close();
+        return fail("corrupt table", path);
+      }
+      tables.push_back(mapped + entry.offset);
+    }
+    return true;
+  }
+
+  void close() {
+    if (mapped) {
+      munmap(const_cast<uint8_t*>(mapped), mappedSize);
+      mapped = nullptr;
+      mappedSize = 0;
+    }
+    tables.clear();
+    patterns.clear();
+    owned.clear();
+    encoding = BYTE_ENCODING;
+  }
+
+  uint64_t tableSize(int pattern) const {
+    return PermRank::partialCount(rows * columns, patterns[pattern].size());
+  }
+
+  uint64_t tableBytes(int pattern) const {
+    const uint64_t entries = tableSize(pattern);
+    switch (encoding) {
+      case NIBBLE_ENCODING:
+        return (entries + 1) / 2;
+      case MOD3_ENCODING:
+        return (entries + 3) / 4;
+      default:
+        return entries;
+    }
+  }
+
+  // byte tables only, see the storage policies for packed ones
+  int lookup(int pattern, uint64_t index) const {
+    return tables[pattern][index];
+  }
+
+  int manhattan(int pattern, const uint8_t* positions) const {
+    const std::vector<uint8_t>& tiles = patterns[pattern];
+    int distance = 0;
+    for (int i = 0; i < tiles.size(); ++i) {
+      distance += distances[tiles[i]][positions[i]];
+    }
+    return distance;
+  }
+
+  // calls fn() with positions changed by every single step of a pattern tile into a slot no pattern tile holds
+  template <typename F>
+  void forEachTileMove(int pattern, uint8_t* positions, F fn) const {
+    const int k = patterns[pattern].size();
+    uint64_t occupied = 0;
+    for (int i = 0; i < k; ++i) {
+      occupied |= uint64_t(1) << positions[i];
+    }
+    for (int i = 0; i < k; ++i) {
+      const int from = positions[i];
+      const int r = from / columns;
+      const int c = from % columns;
+      for (int slot : {r > 0 ? from - columns : -1, r < rows - 1 ? from + columns : -1, c > 0 ? from - 1 : -1,
+                       c < columns - 1 ? from + 1 : -1}) {
+        if (slot >= 0 && !(occupied & (uint64_t(1) << slot))) {
+          positions[i] = slot;
+          fn();
+          positions[i] = from;
+        }
+      }
+    }
+  }
+
+  int rows = 0;
+  int columns = 0;
+  uint32_t encoding = BYTE_ENCODING;
+  std::vector<std::vector<uint8_t>> patterns;
+  std::vector<const uint8_t*> tables;
+
+private:
+  static uint64_t alignUp(uint64_t offset) {
+    return (offset + PAGE_ALIGN - 1) / PAGE_ALIGN * PAGE_ALIGN;
+  }
+
+  static bool fail(const char* reason, const std::string& path) {
+#ifdef USE_SDL
+    constexpr static Logger L = Logger::getLogger();
+    L.error("PatternDb", reason, path);
+#endif
+    return false;
+  }
+
+  void initDistances() {
+    for (int tile = 0; tile < rows * columns; ++tile) {
+      for (int slot = 0; slot < rows * columns; ++slot) {
+        distances[tile][slot] = std::abs(tile / columns - slot / columns) + std::abs(tile % columns - slot % columns);
+      }
+    }
+  }
+
+  std::array<std::array<uint8_t, SliderNode::MAX_SLOTS>, SliderNode::MAX_SLOTS> distances;
+  std::vector<std::vector<uint8_t>> owned;
+  const uint8_t* mapped = nullptr;
+  size_t mappedSize = 0;
+};
+
+/*
+ * Storage policies for pattern tables. value() returns the exact stored
+ * distance of the placement at positions, ranked index; parent is the
+ * pattern's value before the move that led here, or -1 at the search root.
+ *
+ * ByteStorage: one byte per placement.
+ * NibbleStorage: two placements per byte. A pattern's distance and the
+ *   Manhattan distance of its tiles have the same parity, so the nibble holds
+ *   (distance - manhattan) / 2, exact up to a gap of 30 and capped beyond.
+ * Mod3Storage: four placements per byte holding the distance mod 3. Values
+ *   are first lowered to the largest bound that changes by at most one per
+ *   tile move, so a child's value is recovered from its parent's, and the
+ *   root's by walking down to the goal placement.
+ */
+struct ByteStorage {
+  static constexpr uint32_t ENCODING = PatternDb::BYTE_ENCODING;
+
+  static std::vector<uint8_t> encode(const PatternDb& db, int pattern) {
+    return std::vector<uint8_t>(db.tables[pattern], db.tables[pattern] + db.tableSize(pattern));
+  }
+
+  static int value(const PatternDb& db, int pattern, const uint8_t* positions, uint64_t index, int parent) {
+    return db.tables[pattern][index];
+  }
+};
+
+struct NibbleStorage {
+  static constexpr uint32_t ENCODING = PatternDb::NIBBLE_ENCODING;
+
+  static std::vector<uint8_t> encode(const PatternDb& db, int pattern) {
+    const int k = db.patterns[pattern].size();
+    const uint64_t entries = db.tableSize(pattern);
+    std::vector<uint8_t> packed((entries + 1) / 2, 0);
+    std::array<uint8_t, SliderNode::MAX_SLOTS> positions;
+    for (uint64_t index = 0; index < entries; ++index) {
+      PermRank::partialUnrank(index, k, db.rows * db.columns, positions.data());
+      const int gap = std::min((db.tables[pattern][index] - db.manhattan(pattern, positions.data())) / 2, 15);
+      packed[index >> 1] |= gap << ((index & 1) * 4);
+    }
+    return packed;
+  }
+
+  static int value(const PatternDb& db, int pattern, const uint8_t* positions, uint64_t index, int parent) {
+    const int gap = (db.tables[pattern][index >> 1] >> ((index & 1) * 4)) & 0xf;
+    return db.manhattan(pattern, positions) + 2 * gap;
+  }
+};
+
+struct Mod3Storage {
+  static constexpr uint32_t ENCODING = PatternDb::MOD3_ENCODING;
+
+  static std::vector<uint8_t> encode(const PatternDb& db, int pattern) {
+    const int k = db.patterns[pattern].size();
+    const int n = db.rows * db.columns;
+    const uint64_t entries = db.tableSize(pattern);
+    // smooth the table in increasing value order: value(q) <= value(p) + 1 for neighbors
+    std::vector<uint8_t> smooth(db.tables[pattern], db.tables[pattern] + entries);
+    const int maxValue = *std::max_element(smooth.begin(), smooth.end());
+    std::array<uint8_t, SliderNode::MAX_SLOTS> positions;
+    for (int v = 0; v < maxValue; ++v) {
+      for (uint64_t index = 0; index < entries; ++index) {
+        if (smooth[index] != v) {
+          continue;
+        }
+        PermRank::partialUnrank(index, k, n, positions.data());
+        db.forEachTileMove(pattern, positions.data(), [&]() {
+          uint8_t& neighbor = smooth[PermRank::partialRank(positions.data(), k, n)];
+          neighbor = std::min<int>(neighbor, v + 1);
+        });
+      }
+    }
+    std::vector<uint8_t> packed((entries + 3) / 4, 0);
+    for (uint64_t index = 0; index < entries; ++index) {
+      packed[index >> 2] |= (smooth[index] % 3) << ((index & 3) * 2);
+    }
+    return packed;
+  }
+
+  static int stored(const PatternDb& db, int pattern, uint64_t index) {
+    return (db.tables[pattern][index >> 2] >> ((index & 3) * 2)) & 3;
+  }
+
+  static int value(const PatternDb& db, int pattern, const uint8_t* positions, uint64_t index, int parent) {
+    const int mod = stored(db, pattern, index);
+    if (parent >= 0) {
+      static constexpr int8_t delta[3] = {0, 1, -1};
+      return parent + delta[(mod - parent % 3 + 3) % 3];
+    }
+    return descend(db, pattern, positions, mod);
+  }
+
+  // every placement but the goal has a neighbor one lower, so counting steps down gives the value
+  static int descend(const PatternDb& db, int pattern, const uint8_t* start, int mod) {
+    const std::vector<uint8_t>& tiles = db.patterns[pattern];
+    const int k = tiles.size();
+    const int n = db.rows * db.columns;
+    std::array<uint8_t, SliderNode::MAX_SLOTS> positions;
+    std::copy(start, start + k, positions.begin());
+    int steps = 0;
+    while (!std::equal(tiles.begin(), tiles.end(), positions.begin())) {
+      const int lower = (mod + 2) % 3;
+      std::array<uint8_t, SliderNode::MAX_SLOTS> next;
+      bool found = false;
+      db.forEachTileMove(pattern, positions.data(), [&]() {
+        if (!found && stored(db, pattern, PermRank::partialRank(positions.data(), k, n)) == lower) {
+          next = positions;
+          found = true;
+        }
+      });
+      if (!found) {
+        break;
+      }
+      positions = next;
+      mod = lower;
+      ++steps;
+    }
+    return steps;
+  }
+};
+
+/*
+ * Sum of the pattern tables. A move changes one tile, so update re-ranks
+ * only the pattern holding it, O(pattern size). Tables packed with another
+ * encoding than Storage's are not read at all: matches() is false and the
+ * heuristic is 0.
+ */
+template <typename Storage = ByteStorage>
+struct PatternDbHeuristic {
+  static constexpr int MAX_PATTERNS = PatternDb::MAX_PATTERNS;
+
+  struct Value {
+    int16_t total = 0;
+    std::array<uint8_t, MAX_PATTERNS> values;
+
+    int h() const {
+      return total;
+    }
+  };
+
+  PatternDbHeuristic(const PatternDb& db) : db(&db) {
+    patternOf.fill(-1);
+    if (!matches()) {
+      return;
+    }
+    for (int p = 0; p < db.patterns.size(); ++p) {
+      for (uint8_t tile : db.patterns[p]) {
+        patternOf[tile] = p;
+      }
+    }
+  }
+
+  int patternValue(const SliderNode& node, int pattern, int parent) const {
+    const std::vector<uint8_t>& tiles = db->patterns[pattern];
+    std::array<uint8_t, SliderNode::MAX_SLOTS> positions;
+    for (int i = 0; i < tiles.size(); ++i) {
+      positions[i] = node.where[tiles[i]];
+    }
+    const uint64_t index = PermRank::partialRank(positions.data(), tiles.size(), node.size);
+    return Storage::value(*db, pattern, positions.data(), index, parent);
+  }
+
+  bool matches() const {
+    return Storage::ENCODING == db->encoding && db->patterns.size() <= MAX_PATTERNS;
+  }
+
+  Value evaluate(const SliderNode& node) const {
+    Value v;
+    for (int p = 0; p < (matches() ? db->patterns.size() : 0); ++p) {
+      v.values[p] = patternValue(node, p, -1);
+      v.total += v.values[p];
+    }
+    return v;
+  }
+
+  Value update(const SliderNode& node, const Value& before, int tile, int from, int to) const {
+    const int p = patternOf[tile];
+    if (p < 0) {
+      return before;
+    }
+    Value v = before;
+    v.values[p] = patternValue(node, p, before.values[p]);
+    v.total += v.values[p] - before.values[p];
+    return v;
+  }
+
+  const PatternDb* db;
+  std::array<int8_t, SliderNode::MAX_SLOTS> patternOf;
+};
+
+// unsolved at once when db's tables are not packed with Storage
+template <typename Storage = ByteStorage>
+struct PatternDbSolver : IdaStarSolver<PatternDbHeuristic<Storage>> {
+  PatternDbSolver(const PatternDb& db)
+      : IdaStarSolver<PatternDbHeuristic<Storage>>(db.rows, db.columns, PatternDbHeuristic<Storage>(db)) {
+  }
+
+  SolveResult solve(const BoardState& start, uint64_t nodeLimit = 0, const std::atomic<bool>* cancel = nullptr) {
+    if (!this->heuristic.matches()) {
+      return SolveResult();
+    }
+    return IdaStarSolver<PatternDbHeuristic<Storage>>::solve(start, nodeLimit, cancel);
+  }
+};
+
+} // namespace tilepuzzles
+#endif
@@ -0,0 +1,118 @@
+#ifndef _PERFECT_TABLES_H_
+#define _PERFECT_TABLES_H_
+
+#include "BoardState.h"
+#include "BoardSymmetry.h"
+#include "ExternalBfs.h"
+#include "MoveGenerator.h"
+
+#include <cstdio>
+#include <filesystem>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <tuple>
+#include <vector>
+
+namespace tilepuzzles {
+
+/*
+ * Distance tables of every position for sliders and rollers of at most
+ * MAX_SLOTS slots, one directory per board shape under dir. find() maps a
+ * board's table, generating it with ExternalBfs the first time the board
+ * comes up (a fraction of a second for 3x3 boards), and keeps it mapped
+ * for the process. Boards with symmetries get symmetric tables, one
+ * distance per BoardSymmetry class. An optimal next move is then the neighbor one move
+ * closer, found by probing DistanceTable::hint, without any search.
+ */
+struct PerfectTables {
+  static constexpr int MAX_SLOTS = 9;
+
+  PerfectTables(const std::string& dir = defaultDir()) : dir(dir) {
+  }
+
+  // process wide; the first call fixes the directory
+  static PerfectTables& shared(const std::string& dir = defaultDir()) {
+    static PerfectTables tables(dir);
+    return tables;
+  }
+
+  static std::string defaultDir() {
+    std::error_code error;
+    const std::filesystem::path temp = std::filesystem::temp_directory_path(error);
+    return ((error ? std::filesystem::path(".") : temp) / "tilepuzzles_tables").string();
+  }
+
+  static bool covers(const BoardState& state) {
+    return state.type != PuzzleType::HexSpinPuzzle && state.size() <= MAX_SLOTS;
+  }
+
+  std::string tableDir(const BoardState& shape) const {
+    char name[64];
+    std::snprintf(name, sizeof(name), "/%s-%dx%d", shape.type == PuzzleType::SliderPuzzle ? "slider" : "roller",
+                  shape.rows, shape.columns);
+    return dir + name;
+  }
+
+  /*
+   * The table for state's board, null when the board is too large or its
+   * table cannot be written. Without build, only a table already on disk.
+   */
+  const DistanceTable* find(const BoardState& state, bool build = true) {
+    if (!covers(state)) {
+      return nullptr;
+    }
+    std::lock_guard<std::mutex> lock(mutex);
+    auto& entry = tables[{state.type, state.rows, state.columns}];
+    if (entry.table || entry.failed) {
+      return entry.table.get();
+    }
+    const BoardState shape(state.type, state.rows, state.columns);
+    auto table = std::make_unique<DistanceTable>();
+    ExternalBfs bfs(shape, tableDir(shape));
+    bfs.symmetric = BoardSymmetry::get(shape).size() > 1;
+    if (!std::filesystem::exists(bfs.distancesPath())) {
+      if (!build) {
+        return nullptr;
+      }
+      entry.failed = !bfs.run() || !bfs.done;
+    }
+    if (!entry.failed && table->open(bfs.distancesPath()) && table->covers(shape)) {
+      entry.table = std::move(table);
+    } else {
+      entry.failed = true;
+    }
+    return entry.table.get();
+  }
+
+  // writes the table of shape's board unless it is there; false on an I/O error
+  bool generate(const BoardState& shape) {
+    return find(shape) != nullptr;
+  }
+
+  // an optimal solution following the table; false when start is unreachable
+  static bool solve(const DistanceTable& table, BoardState start, std::vector<Move>& moves) {
+    moves.clear();
+    Move move;
+    while (table.hint(start, move)) {
+      moves.push_back(move);
+      MoveGenerator::apply(start, move);
+    }
+    return start.isSolved();
+  }
+
+  std::string dir;
+
+private:
+  struct Entry {
+    std::unique_ptr<DistanceTable> table;
+    bool failed = false;
+  };
+
+  std::mutex mutex;
+  std::map<std::tuple<PuzzleType, int, int>, Entry> tables;
+};
+
+} // namespace tilepuzzles
+#endif
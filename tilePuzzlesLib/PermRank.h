@@ -0,0 +1,275 @@
+#ifndef _PERM_RANK_H_
+#define _PERM_RANK_H_
+
+#include "BoardState.h"
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+namespace tilepuzzles {
+
+/*
+ * 256 bit rank for permutations that overflow 128 bits, e.g. the 54 slot
+ * hex board (54! ~ 2^237). Only supports what Horner style ranking needs.
+ */
+struct WideRank {
+  std::array<uint64_t, 4> words = {0, 0, 0, 0};
+
+  WideRank() {
+  }
+
+  WideRank(uint64_t value) {
+    words[0] = value;
+  }
+
+  bool operator==(const WideRank& other) const {
+    return words == other.words;
+  }
+
+  bool operator!=(const WideRank& other) const {
+    return words != other.words;
+  }
+
+  bool operator<(const WideRank& other) const {
+    for (int i = 3; i >= 0; --i) {
+      if (words[i] != other.words[i]) {
+        return words[i] < other.words[i];
+      }
+    }
+    return false;
+  }
+};
+
+using Rank128 = unsigned __int128;
+
+/*
+ * Bijections between permutations of n <= 64 values and dense integers:
+ * lexicographic order, Myrvold-Ruskey order (linear time, not ordered) and
+ * partial permutations of k pattern tiles over n slots for pattern
+ * databases. R is uint64_t for n <= 20, Rank128 for n <= 34 and WideRank
+ * beyond that.
+ */
+struct PermRank {
+  static constexpr int MAX_N = 64;
+
+  static constexpr uint64_t factorial(int n) {
+    uint64_t f = 1;
+    for (int i = 2; i <= n; ++i) {
+      f *= i;
+    }
+    return f;
+  }
+
+  // n! / (n - k)!: number of placements of k distinct tiles over n slots
+  static constexpr uint64_t partialCount(int n, int k) {
+    uint64_t c = 1;
+    for (int i = 0; i < k; ++i) {
+      c *= n - i;
+    }
+    return c;
+  }
+
+  template <typename R>
+  static void mulAdd(R& rank, uint32_t mul, uint32_t add) {
+    if constexpr (std::is_same_v<R, WideRank>) {
+      Rank128 carry = add;
+      for (auto& w : rank.words) {
+        Rank128 v = Rank128(w) * mul + carry;
+        w = uint64_t(v);
+        carry = v >> 64;
+      }
+    } else {
+      rank = rank * mul + add;
+    }
+  }
+
+  // divides rank by div in place and returns the remainder
+  template <typename R>
+  static uint32_t divMod(R& rank, uint32_t div) {
+    if constexpr (std::is_same_v<R, WideRank>) {
+      Rank128 rem = 0;
+      for (int i = 3; i >= 0; --i) {
+        Rank128 v = (rem << 64) | rank.words[i];
+        rank.words[i] = uint64_t(v / div);
+        rem = v % div;
+      }
+      return uint32_t(rem);
+    } else {
+      uint32_t rem = uint32_t(rank % div);
+      rank /= div;
+      return rem;
+    }
+  }
+
+  template <typename R = uint64_t, typename V>
+  static R lexRank(const V* perm, int n) {
+    uint64_t seen = 0;
+    R rank = 0;
+    for (int i = 0; i < n; ++i) {
+      const uint64_t below = (uint64_t(1) << perm[i]) - 1;
+      const int smallerUnused = perm[i] - __builtin_popcountll(seen & below);
+      mulAdd(rank, n - i, smallerUnused);
+      seen |= uint64_t(1) << perm[i];
+    }
+    return rank;
+  }
+
+  template <typename R, typename V>
+  static void lexUnrank(R rank, int n, V* perm) {
+    std::array<uint8_t, MAX_N> digits;
+    for (int i = n - 1; i >= 0; --i) {
+      digits[i] = divMod(rank, n - i);
+    }
+    uint64_t unused = n == 64 ? ~uint64_t(0) : (uint64_t(1) << n) - 1;
+    for (int i = 0; i < n; ++i) {
+      uint64_t bits = unused;
+      for (int d = 0; d < digits[i]; ++d) {
+        bits &= bits - 1;
+      }
+      perm[i] = __builtin_ctzll(bits);
+      unused &= ~(uint64_t(1) << perm[i]);
+    }
+  }
+
+  template <typename R = uint64_t, typename V>
+  static R mrRank(const V* perm, int n) {
+    std::array<uint8_t, MAX_N> pi;
+    std::array<uint8_t, MAX_N> inv;
+    for (int i = 0; i < n; ++i) {
+      pi[i] = perm[i];
+      inv[perm[i]] = i;
+    }
+    std::array<uint8_t, MAX_N> digits;
+    for (int i = n; i > 1; --i) {
+      const uint8_t s = pi[i - 1];
+      digits[i - 1] = s;
+      std::swap(pi[i - 1], pi[inv[i - 1]]);
+      std::swap(inv[s], inv[i - 1]);
+    }
+    // rank = s(n) + n * (s(n - 1) + (n - 1) * (...))
+    R rank = 0;
+    for (int i = 2; i <= n; ++i) {
+      mulAdd(rank, i, digits[i - 1]);
+    }
+    return rank;
+  }
+
+  template <typename R, typename V>
+  static void mrUnrank(R rank, int n, V* perm) {
+    for (int i = 0; i < n; ++i) {
+      perm[i] = i;
+    }
+    for (int i = n; i > 0; --i) {
+      std::swap(perm[i - 1], perm[divMod(rank, i)]);
+    }
+  }
+
+  // lexicographic rank of the slots held by k pattern tiles, in [0, partialCount(n, k))
+  template <typename V>
+  static uint64_t partialRank(const V* positions, int k, int n) {
+    uint64_t seen = 0;
+    uint64_t rank = 0;
+    for (int i = 0; i < k; ++i) {
+      const uint64_t below = (uint64_t(1) << positions[i]) - 1;
+      rank = rank * (n - i) + positions[i] - __builtin_popcountll(seen & below);
+      seen |= uint64_t(1) << positions[i];
+    }
+    return rank;
+  }
+
+  template <typename V>
+  static void partialUnrank(uint64_t rank, int k, int n, V* positions) {
+    std::array<uint8_t, MAX_N> digits;
+    for (int i = k - 1; i >= 0; --i) {
+      digits[i] = rank % (n - i);
+      rank /= n - i;
+    }
+    uint64_t unused = n == 64 ? ~uint64_t(0) : (uint64_t(1) << n) - 1;
+    for (int i = 0; i < k; ++i) {
+      uint64_t bits = unused;
+      for (int d = 0; d < digits[i]; ++d) {
+        bits &= bits - 1;
+      }
+      positions[i] = __builtin_ctzll(bits);
+      unused &= ~(uint64_t(1) << positions[i]);
+    }
+  }
+
+  template <typename R = uint64_t>
+  static R rank(const BoardState& state) {
+    return lexRank<R>(state.slots.data(), state.size());
+  }
+
+  template <typename R>
+  static BoardState unrank(const BoardState& shape, R rank) {
+    BoardState state = shape;
+    lexUnrank(rank, state.size(), state.slots.data());
+    finishUnrank(state);
+    return state;
+  }
+
+  /*
+   * Lexicographic ranks of count states of equal size. Each lexicographic
+   * digit is the number of later values smaller than perm[i]; the SSE2 path
+   * finds it for 16 slots per compare instead of one.
+   */
+  template <typename R = uint64_t>
+  static void rankBatch(const BoardState* states, size_t count, R* ranks) {
+    std::array<uint8_t, MAX_N> perm;
+    for (size_t b = 0; b < count; ++b) {
+      const BoardState& state = states[b];
+      const int n = state.size();
+      for (int i = 0; i < n; ++i) {
+        perm[i] = state.slots[i];
+      }
+      ranks[b] = lexRankBytes<R>(perm.data(), n);
+    }
+  }
+
+  template <typename R = uint64_t>
+  static R lexRankBytes(const uint8_t* perm, int n) {
+#if defined(__SSE2__)
+    // lanes past n are zero padded and masked out by valid
+    alignas(16) std::array<uint8_t, MAX_N> lanes;
+    std::copy(perm, perm + n, lanes.begin());
+    std::fill(lanes.begin() + n, lanes.end(), 0);
+    const int chunks = (n + 15) / 16;
+    __m128i values[MAX_N / 16];
+    for (int c = 0; c < chunks; ++c) {
+      values[c] = _mm_load_si128(reinterpret_cast<const __m128i*>(lanes.data() + c * 16));
+    }
+    const uint64_t valid = n == 64 ? ~uint64_t(0) : (uint64_t(1) << n) - 1;
+    R rank = 0;
+    for (int i = 0; i < n; ++i) {
+      const __m128i pivot = _mm_set1_epi8(char(perm[i]));
+      uint64_t smaller = 0;
+      for (int c = 0; c < chunks; ++c) {
+        const __m128i lt = _mm_cmplt_epi8(values[c], pivot);
+        smaller |= uint64_t(uint32_t(_mm_movemask_epi8(lt))) << (c * 16);
+      }
+      const uint64_t later = ~((uint64_t(2) << i) - 1);
+      mulAdd(rank, n - i, __builtin_popcountll(smaller & later & valid));
+    }
+    return rank;
+#else
+    return lexRank<R>(perm, n);
+#endif
+  }
+
+private:
+  static void finishUnrank(BoardState& state) {
+    if (state.type == PuzzleType::SliderPuzzle) {
+      state.blank = state.slotOf(state.blankTile());
+    }
+    state.rehash();
+  }
+};
+
+} // namespace tilepuzzles
+#endif
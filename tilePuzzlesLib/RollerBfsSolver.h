@@ -0,0 +1,289 @@
+#ifndef _ROLLER_BFS_SOLVER_H_
+#define _ROLLER_BFS_SOLVER_H_
+
+#include "BoardState.h"
+#include "MoveGenerator.h"
+#include "ParallelIda.h"
+#include "SliderSolver.h"
+
+#include <tsl/robin_set.h>
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <limits>
+#include <numeric>
+#include <thread>
+#include <vector>
+
+namespace tilepuzzles {
+
+/*
+ * Meet in the middle breadth first search for roller boards of up to 42
+ * slots. One search grows from the scramble and one from the solved board,
+ * both with the same move set since it holds every roll's inverse, always
+ * expanding the smaller frontier by a whole layer. Finishing the
+ * layer and keeping the shortest meeting makes the result optimal.
+ *
+ * States are packed tile ids, bitsPerTile bits each, in a two or four word
+ * key. Layers are kept as separate tsl::robin_set so the path is rebuilt by
+ * stepping back one layer at a time instead of storing parent moves.
+ *
+ * maxStates caps the states held by both searches. A layer that has met
+ * the other search is always finished, so it may run past the cap by the
+ * rest of that last layer. When the cap is hit before a meeting, or the
+ * board has more than MAX_SLOTS slots and its states do not fit a key, the
+ * solver falls back to ParallelIdaSolver<RollerDomain> limited to
+ * fallbackNodes nodes, and usedFallback tells the caller.
+ */
+struct RollerBfsSolver {
+  static constexpr int MAX_SLOTS = 42;
+  static constexpr size_t DEFAULT_MAX_STATES = 32 << 20;
+
+  RollerBfsSolver(int rows, int columns, size_t maxStates = DEFAULT_MAX_STATES)
+      : rows(rows), columns(columns), maxStates(maxStates) {
+    const BoardState shape = BoardState::roller(rows, columns);
+    moves.resize(MoveGenerator::maxMoves(shape));
+    moves.resize(MoveGenerator::generate(shape, moves.data()));
+    bitsPerTile = 1;
+    while ((1 << bitsPerTile) < rows * columns) {
+      ++bitsPerTile;
+    }
+  }
+
+  // bytes one stored state costs at the robin_set's maximum load factor
+  size_t bytesPerState() const {
+    return (wordsNeeded() <= 2 ? 16 : 32) * 2 + 8;
+  }
+
+  SolveResult solve(const BoardState& start) {
+    usedFallback = false;
+    if (rows * columns > MAX_SLOTS) {
+      storedStates = 0;
+      return fallback(start);
+    }
+    return wordsNeeded() <= 2 ? solveWith<2>(start) : solveWith<4>(start);
+  }
+
+  int rows;
+  int columns;
+  size_t maxStates;
+  uint64_t fallbackNodes = 50000000;
+  int fallbackThreads = std::thread::hardware_concurrency();
+  bool usedFallback = false;
+  // states held by both searches at the end of the last solve
+  size_t storedStates = 0;
+
+private:
+  template <int WORDS>
+  struct Key {
+    std::array<uint64_t, WORDS> words;
+
+    bool operator==(const Key& other) const {
+      return words == other.words;
+    }
+  };
+
+  template <int WORDS>
+  struct KeyHash {
+    size_t operator()(const Key<WORDS>& key) const {
+      uint64_t h = 0;
+      for (uint64_t w : key.words) {
+        h = (h ^ w) * 0x9e3779b97f4a7c15ULL;
+        h ^= h >> 29;
+      }
+      return h ^ (h >> 32);
+    }
+  };
+
+  template <int WORDS>
+  using Layer = tsl::robin_set<Key<WORDS>, KeyHash<WORDS>>;
+
+  using Slots = std::array<uint8_t, MAX_SLOTS>;
+
+  int wordsNeeded() const {
+    return (rows * columns * bitsPerTile + 63) / 64;
+  }
+
+  template <int WORDS>
+  Key<WORDS> pack(const Slots& slots) const {
+    Key<WORDS> key;
+    key.words.fill(0);
+    int bit = 0;
+    for (int s = 0; s < rows * columns; ++s, bit += bitsPerTile) {
+      key.words[bit >> 6] |= uint64_t(slots[s]) << (bit & 63);
+      if ((bit & 63) + bitsPerTile > 64) {
+        key.words[(bit >> 6) + 1] |= uint64_t(slots[s]) >> (64 - (bit & 63));
+      }
+    }
+    return key;
+  }
+
+  template <int WORDS>
+  void unpack(const Key<WORDS>& key, Slots& slots) const {
+    const uint64_t mask = (uint64_t(1) << bitsPerTile) - 1;
+    int bit = 0;
+    for (int s = 0; s < rows * columns; ++s, bit += bitsPerTile) {
+      uint64_t v = key.words[bit >> 6] >> (bit & 63);
+      if ((bit & 63) + bitsPerTile > 64) {
+        v |= key.words[(bit >> 6) + 1] << (64 - (bit & 63));
+      }
+      slots[s] = v & mask;
+    }
+  }
+
+  void apply(Slots& slots, Move move) const {
+    const int line = MoveGenerator::index(move);
+    switch (MoveGenerator::direction(move)) {
+      case Direction::right:
+        std::rotate(&slots[line * columns], &slots[line * columns + columns - 1], &slots[line * columns + columns]);
+        break;
+      case Direction::left:
+        std::rotate(&slots[line * columns], &slots[line * columns + 1], &slots[line * columns + columns]);
+        break;
+      case Direction::down: {
+        const uint8_t wrap = slots[(rows - 1) * columns + line];
+        for (int r = rows - 1; r > 0; --r) {
+          slots[r * columns + line] = slots[(r - 1) * columns + line];
+        }
+        slots[line] = wrap;
+        break;
+      }
+      case Direction::up: {
+        const uint8_t wrap = slots[line];
+        for (int r = 0; r < rows - 1; ++r) {
+          slots[r * columns + line] = slots[(r + 1) * columns + line];
+        }
+        slots[(rows - 1) * columns + line] = wrap;
+        break;
+      }
+      default:
+        break;
+    }
+  }
+
+  // on lines of two a roll is its own inverse and only one direction is generated
+  Move inverse(Move move) const {
+    const Move back = MoveGenerator::inverse(move);
+    return std::find(moves.begin(), moves.end(), back) == moves.end() ? move : back;
+  }
+
+  template <int WORDS>
+  static int depthOf(const std::vector<Layer<WORDS>>& layers, const Key<WORDS>& key) {
+    for (int d = layers.size() - 1; d >= 0; --d) {
+      if (layers[d].count(key)) {
+        return d;
+      }
+    }
+    return -1;
+  }
+
+  template <int WORDS>
+  SolveResult solveWith(const BoardState& start) {
+    auto startTime = std::chrono::steady_clock::now();
+    SolveResult result;
+    Slots slots;
+    std::copy(start.slots.begin(), start.slots.end(), slots.begin());
+    const Key<WORDS> from = pack<WORDS>(slots);
+    std::iota(slots.begin(), slots.begin() + rows * columns, 0);
+    const Key<WORDS> to = pack<WORDS>(slots);
+
+    std::array<std::vector<Layer<WORDS>>, 2> sides;
+    sides[0].emplace_back();
+    sides[0][0].insert(from);
+    sides[1].emplace_back();
+    sides[1][0].insert(to);
+    storedStates = 2;
+
+    Key<WORDS> meeting = from;
+    int best = from == to ? 0 : std::numeric_limits<int>::max();
+    int meetDepth[2] = {0, 0};
+    while (best == std::numeric_limits<int>::max()) {
+      const int side = sides[0].back().size() <= sides[1].back().size() ? 0 : 1;
+      std::vector<Layer<WORDS>>& own = sides[side];
+      const std::vector<Layer<WORDS>>& other = sides[1 - side];
+      if (own.back().empty()) {
+        break;
+      }
+      const int depth = own.size();
+      Layer<WORDS> next;
+      for (const Key<WORDS>& key : own.back()) {
+        unpack(key, slots);
+        ++result.nodes;
+        for (Move move : moves) {
+          Slots child = slots;
+          apply(child, move);
+          const Key<WORDS> childKey = pack<WORDS>(child);
+          // neighbors of layer d lie in layers d - 1, d or d + 1
+          if ((depth >= 2 && own[depth - 2].count(childKey)) || own[depth - 1].count(childKey) ||
+              !next.insert(childKey).second) {
+            continue;
+          }
+          const int otherDepth = depthOf(other, childKey);
+          if (otherDepth >= 0 && depth + otherDepth < best) {
+            best = depth + otherDepth;
+            meeting = childKey;
+            meetDepth[side] = depth;
+            meetDepth[1 - side] = otherDepth;
+          }
+        }
+        // a partial layer could miss a shorter meeting, so only a layer without one stops early
+        if (best == std::numeric_limits<int>::max() && storedStates + next.size() > maxStates) {
+          break;
+        }
+      }
+      storedStates += next.size();
+      own.push_back(std::move(next));
+      if (storedStates > maxStates && best == std::numeric_limits<int>::max()) {
+        result = fallback(start);
+        storedStates = 0;
+        return result;
+      }
+    }
+
+    if (best != std::numeric_limits<int>::max()) {
+      result.solved = true;
+      result.moves = pathTo(sides[0], meeting, meetDepth[0]);
+      std::reverse(result.moves.begin(), result.moves.end());
+      for (Move move : pathTo(sides[1], meeting, meetDepth[1])) {
+        result.moves.push_back(inverse(move));
+      }
+    }
+    result.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - startTime).count();
+    return result;
+  }
+
+  // moves leading from layer 0 to key, last move first
+  template <int WORDS>
+  std::vector<Move> pathTo(const std::vector<Layer<WORDS>>& layers, Key<WORDS> key, int depth) const {
+    std::vector<Move> path;
+    Slots slots;
+    for (int d = depth - 1; d >= 0; --d) {
+      unpack(key, slots);
+      for (Move move : moves) {
+        Slots previous = slots;
+        apply(previous, inverse(move));
+        const Key<WORDS> previousKey = pack<WORDS>(previous);
+        if (layers[d].count(previousKey)) {
+          path.push_back(move);
+          key = previousKey;
+          break;
+        }
+      }
+    }
+    return path;
+  }
+
+  SolveResult fallback(const BoardState& start) {
+    usedFallback = true;
+    ParallelIdaSolver<RollerDomain> ida(RollerDomain(rows, columns), fallbackThreads);
+    return ida.solve(start, fallbackNodes);
+  }
+
+  std::vector<Move> moves;
+  int bitsPerTile = 1;
+};
+
+} // namespace tilepuzzles
+#endif
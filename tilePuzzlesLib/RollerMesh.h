@@ -26,10 +26,8 @@ struct RollerMesh : Mesh<TQuadVertexBuffer, Tile> {
 
   virtual std::vector<Tile*> rollTiles(const Tile& tile, Direction dir) {
     auto rollerTiles = tilesToRoll(tile, dir);
-    const int dim = sqrt(tiles.size());
-    std::for_each(rollerTiles.begin(), rollerTiles.end(),
-                  [this, dir, dim](Tile* t) { rollTile(*t, dir, dim - 1); });
-
+    state.roll(slotOf(tile), dir);
+    tilesDirty = true;
     return rollerTiles;
   }
 
@@ -58,46 +56,6 @@ struct RollerMesh : Mesh<TQuadVertexBuffer, Tile> {
     }
   }
 
-  void rollTile(Tile& tile, Direction dir, int maxCoord) {
-    switch (dir) {
-      case Direction::up:
-        tile.topLeft.y += tile.size.y;
-        tile.gridCoord.x -= 1;
-        if (tile.gridCoord.x < 0) {          
-          tile.topLeft.y = low_y + tile.size.y;
-          tile.gridCoord.x = maxCoord;
-        }
-        break;
-      case Direction::down:
-        tile.topLeft.y -= tile.size.y;
-        tile.gridCoord.x += 1;
-        if (tile.gridCoord.x > maxCoord) {
-          tile.topLeft.y = high_y;
-          tile.gridCoord.x = 0;
-        }
-        break;
-      case Direction::left:
-        tile.topLeft[0] -= tile.size.x;
-        tile.gridCoord.y -= 1;
-        if (tile.gridCoord.y < 0) {
-          tile.topLeft.x = high_x - tile.size.x;
-          tile.gridCoord.y = maxCoord;
-        }
-        break;
-      case Direction::right:
-        tile.topLeft.x += tile.size.x;
-        tile.gridCoord.y += 1;
-        if (tile.gridCoord.y > maxCoord) {
-          tile.topLeft.x = low_x;
-          tile.gridCoord.y = 0;
-        }
-        break;
-      default:
-        break;
-    }
-    tile.updateVertices();
-  }
-
   void initTileBounds() {
     low_x = low_y = std::numeric_limits<float>::max();
     high_x = high_y = std::numeric_limits<float>::min();
@@ -48,8 +48,7 @@ struct RollerRenderer : TRenderer<TQuadVertexBuffer, Tile> {
 
   virtual Tile* onRightMouseDown(const float2& viewCoord) {
     if (!readOnly) {
-      mesh->shuffle();
-      needsDraw = true;
+      shuffle();
     }
     math::float3 clipCoord = normalizeViewCoord(viewCoord);
     Tile* tile = mesh->hitTest(clipCoord);
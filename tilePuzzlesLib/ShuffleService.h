@@ -0,0 +1,121 @@
+#ifndef _SHUFFLE_SERVICE_H_
+#define _SHUFFLE_SERVICE_H_
+
+#include "BoardState.h"
+#include "DifficultyEstimator.h"
+
+#include <atomic>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <thread>
+
+namespace tilepuzzles {
+
+/*
+ * Scrambles boards to a difficulty off the UI thread. post() hands it the
+ * solved board and a target from 0 (solved) to 1 (as hard as a fully
+ * shuffled board); a worker thread makes random moves until
+ * DifficultyEstimator scores the board there or maxMoves were made.
+ * poll() picks up the result once ready and never waits for the worker.
+ *
+ * Posting again drops the board being scrambled, only the last post is
+ * delivered.
+ */
+struct ShuffleService {
+  ShuffleService() {
+  }
+
+  ~ShuffleService() {
+    {
+      std::lock_guard<std::mutex> lock(mutex);
+      quit = true;
+    }
+    wake.notify_one();
+    if (worker.joinable()) {
+      worker.join();
+    }
+  }
+
+  ShuffleService(const ShuffleService&) = delete;
+  ShuffleService& operator=(const ShuffleService&) = delete;
+
+  void post(const BoardState& solved, double difficulty, int maxMoves) {
+    {
+      std::lock_guard<std::mutex> lock(mutex);
+      pending = std::make_unique<Request>(Request{solved, difficulty, maxMoves});
+      ready.reset();
+      ++posted;
+      if (!worker.joinable()) {
+        worker = std::thread([this] { run(); });
+      }
+    }
+    wake.notify_one();
+  }
+
+  // the board of the last post once scrambled; never blocks
+  bool poll(BoardState& shuffled) {
+    std::unique_lock<std::mutex> lock(mutex, std::try_to_lock);
+    if (!lock.owns_lock() || !ready) {
+      return false;
+    }
+    shuffled = std::move(*ready);
+    ready.reset();
+    return true;
+  }
+
+  bool busy() const {
+    return shuffling;
+  }
+
+private:
+  struct Request {
+    BoardState state;
+    double difficulty;
+    int maxMoves;
+  };
+
+  void run() {
+    while (true) {
+      std::unique_ptr<Request> request;
+      uint64_t serial;
+      {
+        std::unique_lock<std::mutex> lock(mutex);
+        wake.wait(lock, [this] { return quit || pending; });
+        if (quit) {
+          return;
+        }
+        request = std::move(pending);
+        serial = posted;
+        shuffling = true;
+      }
+      BoardState& state = request->state;
+      // kept across posts, calibration and solvers are set up once per board size
+      if (!estimator || estimator->type != state.type || estimator->rows != state.rows ||
+          estimator->columns != state.columns) {
+        estimator = std::make_unique<DifficultyEstimator>(state.type, state.rows, state.columns);
+      }
+      estimator->scrambleTo(state, request->difficulty, request->maxMoves);
+      {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (serial == posted) {
+          ready = std::make_unique<BoardState>(std::move(state));
+        }
+      }
+      shuffling = false;
+    }
+  }
+
+  std::mutex mutex;
+  std::condition_variable wake;
+  std::thread worker;
+  std::unique_ptr<Request> pending;
+  std::unique_ptr<BoardState> ready;
+  std::unique_ptr<DifficultyEstimator> estimator;
+  std::atomic<bool> shuffling = false;
+  bool quit = false;
+  uint64_t posted = 0;
+};
+
+} // namespace tilepuzzles
+#endif
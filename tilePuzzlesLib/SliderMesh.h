@@ -47,19 +47,14 @@ struct SliderMesh : Mesh<TQuadVertexBuffer, Tile> {
   }
 
   virtual Tile* const blankTile() {
-    auto tileIter = std::find_if(tiles.begin(), tiles.end(), [](const Tile& t) { return t.isBlank; });
-    if (tileIter != tiles.end()) {
-      int index = std::distance(tiles.begin(), tileIter);
-      return &tiles[index];
-    } else {
-      return nullptr;
-    }
+    syncTiles();
+    return &tiles[state.blankTile()];
   }
 
   virtual void slideTiles(const Tile& tile) {
-    auto tiles = tilesToSlide(tile);
-    Tile* blank = blankTile();
-    std::for_each(tiles.begin(), tiles.end(), [blank](Tile* t) { t->swap(blank); });
+    if (state.slide(slotOf(tile))) {
+      tilesDirty = true;
+    }
   }
 
   std::vector<Tile*> tilesToSlide(const Tile& tile) {
@@ -47,8 +47,7 @@ struct SliderRenderer : TRenderer<TQuadVertexBuffer, Tile> {
 
   virtual Tile* onRightMouseDown(const float2& viewCoord) {
     if (!readOnly) {
-      mesh->shuffle();
-      needsDraw = true;
+      shuffle();
     }
     math::float3 clipCoord = normalizeViewCoord(viewCoord);
     Tile* tile = mesh->hitTest(clipCoord);
@@ -0,0 +1,383 @@
+#ifndef _SOLUTION_OPTIMIZER_H_
+#define _SOLUTION_OPTIMIZER_H_
+
+#include "BoardState.h"
+#include "MoveGenerator.h"
+
+#include <tsl/robin_map.h>
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <tuple>
+#include <vector>
+
+namespace tilepuzzles {
+
+/*
+ * Roller and hex spin moves are fixed slot permutations, so each one is a
+ * power of a generator: a roll of its line, a 60 degree turn of its anchor
+ * or a group roll. MoveAlgebra keeps per move its axis (the generator) and
+ * exponent, per axis its order and the shortest run of moves for every
+ * exponent, and whether two axes commute. Built once per board shape and
+ * shared, like HexTopology.
+ */
+struct MoveAlgebra {
+  struct Axis {
+    int order = 1;
+    // moves adding up to exponent e, fewest first
+    std::vector<std::vector<Move>> shortest;
+  };
+
+  MoveAlgebra(PuzzleType type, int rows, int columns) {
+    const BoardState shape(type, rows, columns);
+    std::vector<Move> moves(MoveGenerator::maxMoves(shape));
+    moves.resize(MoveGenerator::generate(shape, moves.data()));
+    // solvers also emit the inverse roll of a line of two, which generate() leaves out
+    for (int i = moves.size() - 1; i >= 0; --i) {
+      if (std::find(moves.begin(), moves.end(), MoveGenerator::inverse(moves[i])) == moves.end()) {
+        moves.push_back(MoveGenerator::inverse(moves[i]));
+      }
+    }
+    std::vector<std::vector<uint16_t>> generators;
+    std::vector<std::vector<Move>> members;
+    for (Move move : moves) {
+      const std::vector<uint16_t> perm = permutation(shape, {move});
+      int axis = -1;
+      int exponent = 0;
+      for (int a = 0; a < generators.size() && axis < 0; ++a) {
+        std::vector<uint16_t> power = generators[a];
+        for (int e = 1; e < axes[a].order; ++e, power = compose(power, generators[a])) {
+          if (power == perm) {
+            axis = a;
+            exponent = e;
+            break;
+          }
+        }
+      }
+      if (axis < 0) {
+        axis = generators.size();
+        exponent = 1;
+        generators.push_back(perm);
+        members.emplace_back();
+        Axis entry;
+        for (std::vector<uint16_t> power = perm; !isIdentity(power); power = compose(power, perm)) {
+          ++entry.order;
+        }
+        axes.push_back(entry);
+      }
+      axisOf[move] = {axis, exponent};
+      members[axis].push_back(move);
+    }
+    for (int a = 0; a < axes.size(); ++a) {
+      initShortest(axes[a], members[a]);
+    }
+    commuting.resize(axes.size() * axes.size());
+    for (int a = 0; a < axes.size(); ++a) {
+      for (int b = 0; b < axes.size(); ++b) {
+        commuting[a * axes.size() + b] =
+            compose(generators[a], generators[b]) == compose(generators[b], generators[a]);
+      }
+    }
+  }
+
+  static const MoveAlgebra& get(PuzzleType type, int rows, int columns) {
+    static std::mutex mutex;
+    static std::map<std::tuple<PuzzleType, int, int>, std::unique_ptr<MoveAlgebra>> cache;
+    std::lock_guard<std::mutex> lock(mutex);
+    auto& algebra = cache[{type, rows, columns}];
+    if (!algebra) {
+      algebra.reset(new MoveAlgebra(type, rows, columns));
+    }
+    return *algebra;
+  }
+
+  bool commute(int a, int b) const {
+    return commuting[a * axes.size() + b];
+  }
+
+  std::vector<Axis> axes;
+  // axis and exponent of every generated move
+  tsl::robin_map<Move, std::pair<int, int>> axisOf;
+
+private:
+  // slot each slot's content ends up in
+  static std::vector<uint16_t> permutation(const BoardState& shape, const std::vector<Move>& moves) {
+    BoardState state = shape;
+    for (Move move : moves) {
+      MoveGenerator::apply(state, move);
+    }
+    std::vector<uint16_t> perm(state.size());
+    for (int s = 0; s < state.size(); ++s) {
+      perm[state.slots[s]] = s;
+    }
+    return perm;
+  }
+
+  // first then second
+  static std::vector<uint16_t> compose(const std::vector<uint16_t>& first, const std::vector<uint16_t>& second) {
+    std::vector<uint16_t> result(first.size());
+    for (int s = 0; s < first.size(); ++s) {
+      result[s] = second[first[s]];
+    }
+    return result;
+  }
+
+  static bool isIdentity(const std::vector<uint16_t>& perm) {
+    for (int s = 0; s < perm.size(); ++s) {
+      if (perm[s] != s) {
+        return false;
+      }
+    }
+    return true;
+  }
+
+  // breadth first over the exponents, a line of two has only one direction to add
+  void initShortest(Axis& axis, const std::vector<Move>& moves) {
+    axis.shortest.assign(axis.order, {});
+    std::vector<bool> reached(axis.order, false);
+    reached[0] = true;
+    std::vector<int> layer = {0};
+    while (!layer.empty()) {
+      std::vector<int> next;
+      for (int e : layer) {
+        for (Move move : moves) {
+          const int to = (e + axisOf[move].second) % axis.order;
+          if (!reached[to]) {
+            reached[to] = true;
+            axis.shortest[to] = axis.shortest[e];
+            axis.shortest[to].push_back(move);
+            next.push_back(to);
+          }
+        }
+      }
+      layer.swap(next);
+    }
+  }
+
+  std::vector<bool> commuting;
+};
+
+/*
+ * Shortens a move sequence to an equivalent one, reaching the same position
+ * from the same start.
+ *
+ * The peephole pass keeps the output as a stack of tokens. On rollers and
+ * hex boards a token is an axis with an exponent: a new move looks back
+ * past the tokens it commutes with for one on its own axis and adds its
+ * exponent there, dropping the token at zero, so back and forth rolls and
+ * six turns of an anchor vanish even with commuting moves in between. The
+ * tokens go back out as the shortest moves for their exponents. On sliders
+ * consecutive slides along one line merge into a single slide, or nothing.
+ *
+ * The window pass enumerates every position within radius moves of each
+ * position on the path, radius being the largest whose branching^radius
+ * stays within windowNodes, and jumps to the latest path position it
+ * reaches in fewer moves than the path takes. The passes alternate until
+ * one of them removes nothing. A result that fails replay is dropped.
+ */
+struct SolutionOptimizer {
+  static constexpr int DEFAULT_WINDOW_NODES = 1024;
+  static constexpr int MAX_RADIUS = 6;
+
+  SolutionOptimizer(PuzzleType type, int rows, int columns)
+      : type(type), rows(rows), columns(columns),
+        algebra(type == PuzzleType::SliderPuzzle ? nullptr : &MoveAlgebra::get(type, rows, columns)) {
+    branching = std::max(2, MoveGenerator::maxMoves(BoardState(type, rows, columns)));
+  }
+
+  // returns the number of moves removed
+  size_t optimize(const BoardState& start, std::vector<Move>& moves) {
+    const size_t length = moves.size();
+    BoardState end = start;
+    for (Move move : moves) {
+      MoveGenerator::apply(end, move);
+    }
+    std::vector<Move> result = moves;
+    peephole(result);
+    // a window pass that removed nothing needs no peephole pass after it, and the reverse
+    for (size_t before = result.size(); true; before = result.size()) {
+      shortcutWindows(start, result);
+      if (result.size() == before) {
+        break;
+      }
+      before = result.size();
+      peephole(result);
+      if (result.size() == before) {
+        break;
+      }
+    }
+    BoardState replay = start;
+    for (Move move : result) {
+      MoveGenerator::apply(replay, move);
+    }
+    if (replay.hash != end.hash) {
+      return 0;
+    }
+    moves.swap(result);
+    return length - moves.size();
+  }
+
+  // the window radius in moves
+  int windowRadius() const {
+    int radius = 1;
+    for (int64_t nodes = branching * branching; radius < MAX_RADIUS && nodes <= windowNodes; nodes *= branching) {
+      ++radius;
+    }
+    return radius;
+  }
+
+  PuzzleType type;
+  int rows;
+  int columns;
+  int64_t windowNodes = DEFAULT_WINDOW_NODES;
+
+private:
+  struct Token {
+    int axis;
+    int exponent;
+  };
+
+  void peephole(std::vector<Move>& moves) const {
+    if (type == PuzzleType::SliderPuzzle) {
+      mergeSlides(moves);
+    } else {
+      mergeTokens(moves);
+    }
+  }
+
+  void mergeTokens(std::vector<Move>& moves) const {
+    std::vector<Token> tokens;
+    for (Move move : moves) {
+      const auto& [axis, exponent] = algebra->axisOf.at(move);
+      const int order = algebra->axes[axis].order;
+      bool merged = false;
+      for (int k = tokens.size() - 1; k >= 0; --k) {
+        if (tokens[k].axis == axis) {
+          tokens[k].exponent = (tokens[k].exponent + exponent) % order;
+          if (tokens[k].exponent == 0) {
+            tokens.erase(tokens.begin() + k);
+          }
+          merged = true;
+          break;
+        }
+        if (!algebra->commute(tokens[k].axis, axis)) {
+          break;
+        }
+      }
+      if (!merged) {
+        tokens.push_back({axis, exponent});
+      }
+    }
+    moves.clear();
+    for (const Token& token : tokens) {
+      const std::vector<Move>& run = algebra->axes[token.axis].shortest[token.exponent];
+      moves.insert(moves.end(), run.begin(), run.end());
+    }
+  }
+
+  bool collinear(int a, int b, int c) const {
+    return (a / columns == b / columns && b / columns == c / columns) ||
+           (a % columns == b % columns && b % columns == c % columns);
+  }
+
+  void mergeSlides(std::vector<Move>& moves) const {
+    std::vector<Move> merged;
+    for (Move move : moves) {
+      if (!merged.empty()) {
+        const int blank = MoveGenerator::arg(merged.back());
+        const int slot = MoveGenerator::index(move);
+        if (collinear(blank, MoveGenerator::index(merged.back()), slot)) {
+          merged.pop_back();
+          if (slot != blank) {
+            merged.push_back(MoveGenerator::slide(slot, blank));
+          }
+          continue;
+        }
+      }
+      merged.push_back(move);
+    }
+    moves.swap(merged);
+  }
+
+  void shortcutWindows(const BoardState& start, std::vector<Move>& moves) {
+    last.clear();
+    BoardState state = start;
+    last[state.hash] = 0;
+    for (int i = 0; i < moves.size(); ++i) {
+      MoveGenerator::apply(state, moves[i]);
+      last[state.hash] = i + 1;
+    }
+    const int radius = windowRadius();
+    std::vector<Move> shorter;
+    state = start;
+    for (int i = 0; i < moves.size();) {
+      bestGain = 0;
+      position = i;
+      // a later visit of this very position is a cycle to cut
+      const int revisit = last[state.hash];
+      if (revisit > i) {
+        bestGain = revisit - i;
+        bestTarget = revisit;
+        best.clear();
+      }
+      word.clear();
+      explore(state, radius);
+      if (bestGain == 0) {
+        shorter.push_back(moves[i]);
+        MoveGenerator::apply(state, moves[i]);
+        ++i;
+        continue;
+      }
+      for (Move move : best) {
+        shorter.push_back(move);
+        MoveGenerator::apply(state, move);
+      }
+      i = bestTarget;
+    }
+    moves.swap(shorter);
+  }
+
+  void explore(BoardState& state, int depth) {
+    std::array<Move, 256> children;
+    const int count = MoveGenerator::generate(state, children.data());
+    for (int k = 0; k < count; ++k) {
+      if (!word.empty() && children[k] == MoveGenerator::inverse(word.back())) {
+        continue;
+      }
+      MoveGenerator::apply(state, children[k]);
+      word.push_back(children[k]);
+      const auto iter = last.find(state.hash);
+      if (iter != last.end()) {
+        const int gain = iter->second - position - int(word.size());
+        if (gain > bestGain) {
+          bestGain = gain;
+          bestTarget = iter->second;
+          best = word;
+        }
+      }
+      if (depth > 1) {
+        explore(state, depth - 1);
+      }
+      word.pop_back();
+      MoveGenerator::unapply(state, children[k]);
+    }
+  }
+
+  const MoveAlgebra* algebra;
+  int branching = 2;
+
+  // window search state
+  tsl::robin_map<uint64_t, int> last;
+  std::vector<Move> word;
+  std::vector<Move> best;
+  int position = 0;
+  int bestGain = 0;
+  int bestTarget = 0;
+};
+
+} // namespace tilepuzzles
+#endif
@@ -0,0 +1,139 @@
+#ifndef _SOLVABILITY_H_
+#define _SOLVABILITY_H_
+
+#include "BoardState.h"
+
+#include <cstdint>
+#include <cstdlib>
+#include <vector>
+
+namespace tilepuzzles {
+
+/*
+ * Linear time reachability checks against the solved board.
+ *
+ * slider: every move is one transposition with the blank, so permutation
+ *   parity must equal the parity of the blank's distance from its home slot.
+ *   Single row or column boards can only move the blank.
+ * roller: a roll is a row/column length cycle. On odd x odd boards all rolls
+ *   are even permutations and exactly the even permutations are reachable;
+ *   with an even dimension every permutation is. Single row or column boards
+ *   can only rotate.
+ * hex: a 60 degree rotation is a 6-cycle, an odd permutation, and the
+ *   anchor rotations generate every permutation of the triangles, so the
+ *   only invariant is six triangles of each color.
+ */
+struct Solvability {
+  static bool isPermutation(const BoardState& state) {
+    std::vector<uint8_t>& seen = scratch(state.size());
+    for (auto tile : state.slots) {
+      if (tile >= state.size() || seen[tile]) {
+        return false;
+      }
+      seen[tile] = 1;
+    }
+    return state.type != PuzzleType::SliderPuzzle || state.slots[state.blank] == state.blankTile();
+  }
+
+  // 0 for even, 1 for odd permutations: (n - cycles) mod 2
+  static int permutationParity(const BoardState& state) {
+    std::vector<uint8_t>& seen = scratch(state.size());
+    int cycles = 0;
+    for (int s = 0; s < state.size(); ++s) {
+      if (!seen[s]) {
+        ++cycles;
+        for (int t = s; !seen[t]; t = state.slots[t]) {
+          seen[t] = 1;
+        }
+      }
+    }
+    return (state.size() - cycles) & 1;
+  }
+
+  static bool isSolvable(const BoardState& state) {
+    if (!isPermutation(state)) {
+      return false;
+    }
+    switch (state.type) {
+      case PuzzleType::SliderPuzzle: {
+        if (state.rows == 1 || state.columns == 1) {
+          return inOrderSkippingBlank(state);
+        }
+        const int home = state.blankTile();
+        const int blankDistance = std::abs(state.blank / state.columns - home / state.columns) +
+                                  std::abs(state.blank % state.columns - home % state.columns);
+        return permutationParity(state) == (blankDistance & 1);
+      }
+      case PuzzleType::RollerPuzzle: {
+        if (state.rows == 1 || state.columns == 1) {
+          return isRotation(state);
+        }
+        if ((state.rows & 1) && (state.columns & 1)) {
+          return permutationParity(state) == 0;
+        }
+        return true;
+      }
+      default:
+        return colorCounts(state);
+    }
+  }
+
+  // flips the parity of an unsolvable board by swapping two tiles other than the blank
+  static bool makeSolvable(BoardState& state) {
+    if (isSolvable(state)) {
+      return true;
+    }
+    if (state.rows > 1 && state.columns > 1 && state.type != PuzzleType::HexSpinPuzzle) {
+      int first = state.blank == 0 ? 1 : 0;
+      int second = state.blank == first + 1 ? first + 2 : first + 1;
+      state.swapSlots(first, second);
+    }
+    return isSolvable(state);
+  }
+
+private:
+  static std::vector<uint8_t>& scratch(int size) {
+    thread_local std::vector<uint8_t> seen;
+    seen.assign(size, 0);
+    return seen;
+  }
+
+  static bool inOrderSkippingBlank(const BoardState& state) {
+    int next = 0;
+    for (auto tile : state.slots) {
+      if (tile != state.blankTile()) {
+        if (tile != next++) {
+          return false;
+        }
+      }
+    }
+    return true;
+  }
+
+  static bool isRotation(const BoardState& state) {
+    const int n = state.size();
+    const int offset = state.slots[0];
+    for (int s = 0; s < n; ++s) {
+      if (state.slots[s] != (s + offset) % n) {
+        return false;
+      }
+    }
+    return true;
+  }
+
+  static bool colorCounts(const BoardState& state) {
+    std::vector<uint8_t>& counts = scratch(state.rows * state.columns);
+    for (auto tile : state.slots) {
+      ++counts[state.topology->slotColor(tile)];
+    }
+    for (auto count : counts) {
+      if (count != 6) {
+        return false;
+      }
+    }
+    return true;
+  }
+};
+
+} // namespace tilepuzzles
+#endif
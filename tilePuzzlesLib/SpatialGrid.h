@@ -0,0 +1,120 @@
+#ifndef _SPATIAL_GRID_H_
+#define _SPATIAL_GRID_H_
+
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+namespace tilepuzzles {
+
+/*
+ * Uniform grid over a clip space rectangle for picking. Each item is listed,
+ * in ascending item order, in every cell its bounds overlap, so the cell of
+ * a point holds every item that can contain it. update() only edits the
+ * cells an item enters or leaves, so moving a few tiles costs a few cells.
+ * Points and bounds outside the rectangle are clamped to its edge cells.
+ */
+struct SpatialGrid {
+  SpatialGrid() {
+  }
+
+  void reset(float lowX, float lowY, float highX, float highY, int columns, int rows) {
+    this->lowX = lowX;
+    this->lowY = lowY;
+    this->columns = std::max(1, columns);
+    this->rows = std::max(1, rows);
+    cellWidth = (highX - lowX) / this->columns;
+    cellHeight = (highY - lowY) / this->rows;
+    cells.assign(this->columns * this->rows, std::vector<int>());
+    ranges.clear();
+  }
+
+  bool empty() const {
+    return cells.empty();
+  }
+
+  void update(int item, float minX, float minY, float maxX, float maxY) {
+    if (item >= ranges.size()) {
+      ranges.resize(item + 1);
+    }
+    const Range range = {column(minX), row(minY), column(maxX), row(maxY)};
+    Range& current = ranges[item];
+    if (current == range) {
+      return;
+    }
+    forCells(current, [item](std::vector<int>& cell) {
+      auto iter = std::lower_bound(cell.begin(), cell.end(), item);
+      if (iter != cell.end() && *iter == item) {
+        cell.erase(iter);
+      }
+    });
+    forCells(range, [item](std::vector<int>& cell) {
+      auto iter = std::lower_bound(cell.begin(), cell.end(), item);
+      if (iter == cell.end() || *iter != item) {
+        cell.insert(iter, item);
+      }
+    });
+    current = range;
+  }
+
+  // the items whose bounds overlap the cell of (x, y), ascending
+  const std::vector<int>& at(float x, float y) const {
+    return cells[row(y) * columns + column(x)];
+  }
+
+  // first candidate of (x, y) that hit accepts, -1 when none does
+  template <typename F>
+  int find(float x, float y, F hit) const {
+    if (cells.empty()) {
+      return -1;
+    }
+    for (int item : at(x, y)) {
+      if (hit(item)) {
+        return item;
+      }
+    }
+    return -1;
+  }
+
+private:
+  // inclusive cell columns and rows; empty until the item is first placed
+  struct Range {
+    int left = 0;
+    int bottom = 0;
+    int right = -1;
+    int top = -1;
+
+    bool operator==(const Range& other) const {
+      return left == other.left && bottom == other.bottom && right == other.right && top == other.top;
+    }
+  };
+
+  template <typename F>
+  void forCells(const Range& range, F f) {
+    for (int r = range.bottom; r <= range.top; ++r) {
+      for (int c = range.left; c <= range.right; ++c) {
+        f(cells[r * columns + c]);
+      }
+    }
+  }
+
+  int column(float x) const {
+    return std::clamp(int(std::floor((x - lowX) / cellWidth)), 0, columns - 1);
+  }
+
+  int row(float y) const {
+    return std::clamp(int(std::floor((y - lowY) / cellHeight)), 0, rows - 1);
+  }
+
+  float lowX = 0.F;
+  float lowY = 0.F;
+  float cellWidth = 1.F;
+  float cellHeight = 1.F;
+  int columns = 0;
+  int rows = 0;
+  std::vector<std::vector<int>> cells;
+  std::vector<Range> ranges;
+};
+
+} // namespace tilepuzzles
+#endif
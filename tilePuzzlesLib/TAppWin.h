@@ -9,6 +9,7 @@
 #include "App.h"
 #include "GameUtil.h"
 #include "HexSpinRenderer.h"
+#include "HintService.h"
 #include "IRenderer.h"
 #include "RollerRenderer.h"
 #include "SliderRenderer.h"
@@ -134,6 +135,7 @@ struct TAppWin {
   }
 
   void cleanup() {
+    hints.cancel();
     renderer->destroy();
     if (roRenderer != nullptr) {
       roRenderer->destroy();
@@ -189,6 +191,22 @@ struct TAppWin {
         win.roRenderer->animate(dt);
       }
       win.needsDraw = true;
+      // post() returns at once for an unchanged position, so the hint engine warms up on each move
+      win.hints.post(win.renderer->getBoardState());
+    }
+  }
+
+  // the hint is applied by pollHint() on the first frame it is ready
+  void requestHint() {
+    hintRequested = true;
+  }
+
+  void pollHint() {
+    Move move;
+    if (hintRequested && hints.poll(renderer->getBoardState(), move)) {
+      hintRequested = false;
+      renderer->applyMove(move);
+      needsDraw = true;
     }
   }
 
@@ -328,6 +346,12 @@ struct TAppWin {
             }
             break;
 
+          case SDL_KEYDOWN:
+            if (event.key.keysym.sym == SDLK_h) {
+              requestHint();
+            }
+            break;
+
           case SDL_WINDOWEVENT:
             switch (event.window.event) {
               case SDL_WINDOWEVENT_RESIZED:
@@ -356,6 +380,7 @@ struct TAppWin {
       lastTime = endTicks;
 
       time += dt;
+      pollHint();
       if (onNewFrame) {
         onNewFrame(*this, time);
       }
@@ -383,6 +408,7 @@ struct TAppWin {
 
   void game_loop(double t) {
     if (renderer && swapChain) {
+      pollHint();
       if (onNewFrame) {
         onNewFrame(*this, t);
       }
@@ -415,6 +441,8 @@ struct TAppWin {
   double lastDrawTime = 0.0;
   std::shared_ptr<IRenderer> renderer;
   std::shared_ptr<IRenderer> roRenderer;
+  HintService hints;
+  bool hintRequested = false;
   SwapChain* swapChain = nullptr;
   GameContext* gameContext;
   App app;
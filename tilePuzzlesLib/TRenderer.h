@@ -7,6 +7,7 @@
 #include "IOUtil.h"
 #include "IRenderer.h"
 #include "Mesh.h"
+#include "ShuffleService.h"
 #include "Tile.h"
 
 #include <filament/Camera.h>
@@ -169,8 +170,14 @@ struct TRenderer : IRenderer {
   }
 
   virtual void update(double dt) {
+    BoardState shuffled;
+    if (shuffler.poll(shuffled)) {
+      mesh->shuffleTo(shuffled);
+      needsDraw = true;
+    }
     if (needsDraw && !readOnly) {
       needsDraw = false;
+      mesh->syncTiles();
       vb->setBufferAt(*engine, 0,
                       VertexBuffer::BufferDescriptor(mesh->vertexBuffer->cloneVertices(),
                                                      mesh->vertexBuffer->getSize(),
@@ -430,11 +437,30 @@ struct TRenderer : IRenderer {
     // tcm.setTransform(inst, scale);
   }
 
+  // with a "difficulty" in the config the board is scrambled off this thread and shown once ready
   virtual void shuffle() {
+    const auto& config = mesh->configMgr.config;
+    if (config.contains("difficulty")) {
+      const BoardState& state = mesh->state;
+      shuffler.post(BoardState(state.type, state.rows, state.columns), config["difficulty"].template get<double>(),
+                    mesh->maxShuffleMoves());
+      return;
+    }
     mesh->shuffle();
     needsDraw = true;
   }
 
+  virtual const BoardState& getBoardState() {
+    return mesh->state;
+  }
+
+  virtual void applyMove(Move move) {
+    if (!readOnly) {
+      mesh->applyMove(move);
+      needsDraw = true;
+    }
+  }
+
   virtual SwapChain* getSwapChain() {
     // return swapChain;
     return nullptr;
@@ -483,6 +509,7 @@ struct TRenderer : IRenderer {
   }
 
   std::shared_ptr<Mesh<VB, T>> mesh;
+  ShuffleService shuffler;
 
 #ifdef USE_SDL
   Logger L;
@@ -7,6 +7,7 @@
 #endif
 
 #include "GameUtil.h"
+#include "HitKernels.h"
 #include "Vertex.h"
 #include "enums.h"
 
@@ -96,6 +97,25 @@ struct Tile {
            (*quadVertices)[0].position.y <= coord.y && (*quadVertices)[2].position.y >= coord.y;
   }
 
+  using HitBatch = QuadBatch;
+
+  // stores the shape onClick tests as entry i of a batch
+  void storeHitShape(HitBatch& batch, int i) const {
+    batch.set(i, (*quadVertices)[0].position.x, (*quadVertices)[0].position.y, (*quadVertices)[1].position.x,
+              (*quadVertices)[2].position.y);
+  }
+
+  // index of the first shape in batch that onClick would accept the point for, -1 when none
+  static int firstHit(const HitBatch& batch, const math::float2& point) {
+    return batch.firstHit(point.x, point.y);
+  }
+
+  // min x, min y, max x, max y of every point onClick accepts
+  virtual math::float4 bounds() const {
+    return {(*quadVertices)[0].position.x, (*quadVertices)[0].position.y, (*quadVertices)[1].position.x,
+            (*quadVertices)[2].position.y};
+  }
+
   virtual void updateVertices() {
     // bottom left
     (*quadVertices)[0].position = {topLeft[0], topLeft[1] - size[1], depth};
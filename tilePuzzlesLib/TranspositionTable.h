@@ -0,0 +1,142 @@
+#ifndef _TRANSPOSITION_TABLE_H_
+#define _TRANSPOSITION_TABLE_H_
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <memory>
+
+namespace tilepuzzles {
+
+struct TTEntry {
+  // lower bound on the moves left to the goal
+  uint16_t bound = 0;
+  // remaining search depth the bound was proven with, the replacement priority
+  uint8_t depth = 0;
+  uint8_t generation = 0;
+};
+
+/*
+ * Fixed size, lock free hash table of search results keyed by Zobrist hash,
+ * shared by every solver thread. Each slot is two 64 bit words: the packed
+ * entry and key ^ entry. Stores and probes are plain relaxed atomic word
+ * accesses; a slot torn by two concurrent writers fails the XOR check and
+ * reads as a miss, so there are no locks on either path.
+ *
+ * Slots are grouped four to a 64 byte bucket. A store replaces the slot
+ * holding the same key, else the emptiest or oldest slot, preferring to keep
+ * entries proven with deeper searches in the current generation.
+ */
+struct TranspositionTable {
+  static constexpr int BUCKET_SLOTS = 4;
+  static constexpr size_t DEFAULT_MEGABYTES = 64;
+
+  TranspositionTable(size_t megabytes = DEFAULT_MEGABYTES) {
+    size_t count = 1;
+    while (count * 2 * sizeof(Bucket) <= megabytes << 20) {
+      count *= 2;
+    }
+    buckets.reset(new Bucket[count]);
+    mask = count - 1;
+  }
+
+  // process wide table; the first call fixes its size
+  static TranspositionTable& shared(size_t megabytes = DEFAULT_MEGABYTES) {
+    static TranspositionTable table(megabytes);
+    return table;
+  }
+
+  bool probe(uint64_t key, TTEntry& entry) const {
+    const Bucket& bucket = buckets[key & mask];
+    for (const Slot& slot : bucket.slots) {
+      const uint64_t data = slot.data.load(std::memory_order_relaxed);
+      if (data && (slot.check.load(std::memory_order_relaxed) ^ data) == key) {
+        entry = unpack(data);
+        return true;
+      }
+    }
+    return false;
+  }
+
+  void store(uint64_t key, TTEntry entry) {
+    entry.generation = generation.load(std::memory_order_relaxed) & 0x7f;
+    Bucket& bucket = buckets[key & mask];
+    Slot* victim = nullptr;
+    int victimScore = std::numeric_limits<int>::max();
+    for (Slot& slot : bucket.slots) {
+      const uint64_t data = slot.data.load(std::memory_order_relaxed);
+      if (data && (slot.check.load(std::memory_order_relaxed) ^ data) == key) {
+        victim = &slot;
+        break;
+      }
+      const int score = replaceScore(data, entry.generation);
+      if (score < victimScore) {
+        victim = &slot;
+        victimScore = score;
+      }
+    }
+    const uint64_t data = pack(entry);
+    victim->data.store(data, std::memory_order_relaxed);
+    victim->check.store(key ^ data, std::memory_order_relaxed);
+  }
+
+  // ages every stored entry so the next search prefers replacing them
+  void newSearch() {
+    generation.fetch_add(1, std::memory_order_relaxed);
+  }
+
+  void clear() {
+    for (size_t b = 0; b <= mask; ++b) {
+      for (Slot& slot : buckets[b].slots) {
+        slot.data.store(0, std::memory_order_relaxed);
+        slot.check.store(0, std::memory_order_relaxed);
+      }
+    }
+  }
+
+  size_t capacity() const {
+    return (mask + 1) * BUCKET_SLOTS;
+  }
+
+  static uint64_t pack(const TTEntry& entry) {
+    // bit 63 keeps a stored entry non-zero, zero marks an empty slot
+    return uint64_t(entry.bound) | uint64_t(entry.depth) << 16 | uint64_t(entry.generation & 0x7f) << 24 |
+           uint64_t(1) << 63;
+  }
+
+  static TTEntry unpack(uint64_t data) {
+    TTEntry entry;
+    entry.bound = uint16_t(data);
+    entry.depth = uint8_t(data >> 16);
+    entry.generation = uint8_t(data >> 24) & 0x7f;
+    return entry;
+  }
+
+private:
+  struct Slot {
+    std::atomic<uint64_t> check = 0;
+    std::atomic<uint64_t> data = 0;
+  };
+
+  struct alignas(64) Bucket {
+    Slot slots[BUCKET_SLOTS];
+  };
+
+  static int replaceScore(uint64_t data, uint8_t generation) {
+    if (!data) {
+      return -1;
+    }
+    const TTEntry entry = unpack(data);
+    const bool current = entry.generation == generation;
+    return entry.depth + (current ? 256 : 0);
+  }
+
+  std::unique_ptr<Bucket[]> buckets;
+  size_t mask = 0;
+  std::atomic<uint8_t> generation = 0;
+};
+
+} // namespace tilepuzzles
+#endif
@@ -0,0 +1,48 @@
+#ifndef _ZOBRIST_H_
+#define _ZOBRIST_H_
+
+#include <array>
+#include <cstdint>
+
+namespace tilepuzzles {
+
+/*
+ * Zobrist keys for (tile, slot) pairs. Keys are a pure function of the pair,
+ * so hashes agree across processes and can be stored on disk. Small boards
+ * read them from a precomputed table, larger ones mix them on the fly.
+ */
+struct Zobrist {
+  static uint64_t key(int tile, int slot) {
+    if (tile < TABLE_DIM && slot < TABLE_DIM) {
+      return table()[tile * TABLE_DIM + slot];
+    }
+    return mix(tile, slot);
+  }
+
+  static constexpr uint64_t mix(int tile, int slot) {
+    // splitmix64 finalizer
+    uint64_t z = (uint64_t(tile) << 32 | uint32_t(slot)) + 0x9e3779b97f4a7c15ULL;
+    z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ULL;
+    z = (z ^ (z >> 27)) * 0x94d049bb133111ebULL;
+    return z ^ (z >> 31);
+  }
+
+  static constexpr int TABLE_DIM = 64;
+
+private:
+  static const std::array<uint64_t, TABLE_DIM * TABLE_DIM>& table() {
+    static const std::array<uint64_t, TABLE_DIM * TABLE_DIM> keys = [] {
+      std::array<uint64_t, TABLE_DIM * TABLE_DIM> k;
+      for (int t = 0; t < TABLE_DIM; ++t) {
+        for (int s = 0; s < TABLE_DIM; ++s) {
+          k[t * TABLE_DIM + s] = mix(t, s);
+        }
+      }
+      return k;
+    }();
+    return keys;
+  }
+};
+
+} // namespace tilepuzzles
+#endif
@@ -0,0 +1,68 @@
+#include "BatchSolver.h"
+
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+
+using namespace tilepuzzles;
+
+/*
+ * batch_solver [--threads N] [--window N] [--budget SECONDS] [--nodes N] [--no-optimize] [--no-tables]
+ *              [in.jsonl [out.jsonl]]
+ *
+ * Reads boards as JSON lines from in.jsonl or stdin and writes one result
+ * line per board, in input order, to out.jsonl or stdout.
+ */
+static int usage(const char* program) {
+  std::cerr << "usage: " << program
+            << " [--threads N] [--window N] [--budget SECONDS] [--nodes N] [--no-optimize] [--no-tables]"
+               " [in.jsonl [out.jsonl]]\n";
+  return 2;
+}
+
+int main(int argc, char** argv) {
+  std::ios::sync_with_stdio(false);
+  BatchOptions options;
+  std::vector<const char*> paths;
+  for (int i = 1; i < argc; ++i) {
+    const bool hasValue = i + 1 < argc;
+    if (!std::strcmp(argv[i], "--threads") && hasValue) {
+      options.threads = std::max(1, std::atoi(argv[++i]));
+    } else if (!std::strcmp(argv[i], "--window") && hasValue) {
+      options.window = std::strtoull(argv[++i], nullptr, 10);
+    } else if (!std::strcmp(argv[i], "--budget") && hasValue) {
+      options.budgetSeconds = std::atof(argv[++i]);
+    } else if (!std::strcmp(argv[i], "--nodes") && hasValue) {
+      options.nodeLimit = std::strtoull(argv[++i], nullptr, 10);
+    } else if (!std::strcmp(argv[i], "--no-optimize")) {
+      options.optimize = false;
+    } else if (!std::strcmp(argv[i], "--no-tables")) {
+      options.perfectTables = false;
+    } else if (argv[i][0] == '-' || paths.size() == 2) {
+      return usage(argv[0]);
+    } else {
+      paths.push_back(argv[i]);
+    }
+  }
+
+  std::ifstream inFile;
+  std::ofstream outFile;
+  if (paths.size() > 0) {
+    inFile.open(paths[0]);
+    if (!inFile) {
+      std::cerr << "cannot open " << paths[0] << "\n";
+      return 1;
+    }
+  }
+  if (paths.size() > 1) {
+    outFile.open(paths[1]);
+    if (!outFile) {
+      std::cerr << "cannot open " << paths[1] << "\n";
+      return 1;
+    }
+  }
+  BatchSolver solver(options);
+  solver.run(paths.size() > 0 ? inFile : std::cin, paths.size() > 1 ? outFile : std::cout);
+  return 0;
+}
@@ -4,5 +4,6 @@
 namespace tilepuzzles {
 enum Direction { left, right, up, down, none };
 enum DragAction { TileDrag, AnchorDrag, noDrag };
+enum PuzzleType { SliderPuzzle, RollerPuzzle, HexSpinPuzzle };
 } // namespace tilepuzzles
 #endif
@@ -0,0 +1,55 @@
+#include "PerfectTables.h"
+
+#include <cstdio>
+#include <cstring>
+#include <iostream>
+
+using namespace tilepuzzles;
+
+/*
+ * perfect_tables [--dir DIR] [slider|roller ROWSxCOLUMNS]...
+ *
+ * Generates the PerfectTables distance tables for the given boards, the 3x3
+ * slider and roller when none are given, so games and batch runs map them
+ * instead of generating them on first use.
+ */
+static int usage(const char* program) {
+  std::cerr << "usage: " << program << " [--dir DIR] [slider|roller ROWSxCOLUMNS]...\n";
+  return 2;
+}
+
+int main(int argc, char** argv) {
+  std::string dir = PerfectTables::defaultDir();
+  std::vector<BoardState> shapes;
+  for (int i = 1; i < argc; ++i) {
+    int rows = 0;
+    int columns = 0;
+    if (!std::strcmp(argv[i], "--dir") && i + 1 < argc) {
+      dir = argv[++i];
+    } else if ((!std::strcmp(argv[i], "slider") || !std::strcmp(argv[i], "roller")) && i + 1 < argc &&
+               std::sscanf(argv[i + 1], "%dx%d", &rows, &columns) == 2 && rows > 1 && columns > 1) {
+      const PuzzleType type = argv[i][0] == 's' ? PuzzleType::SliderPuzzle : PuzzleType::RollerPuzzle;
+      shapes.push_back(BoardState(type, rows, columns));
+      ++i;
+    } else {
+      return usage(argv[0]);
+    }
+  }
+  if (shapes.empty()) {
+    shapes = {BoardState::slider(3, 3), BoardState::roller(3, 3)};
+  }
+  PerfectTables tables(dir);
+  for (const BoardState& shape : shapes) {
+    if (!PerfectTables::covers(shape)) {
+      std::cerr << shape.rows << "x" << shape.columns << " has more than " << PerfectTables::MAX_SLOTS
+                << " slots\n";
+      return 1;
+    }
+    if (!tables.generate(shape)) {
+      std::cerr << "cannot write " << tables.tableDir(shape) << "\n";
+      return 1;
+    }
+    std::cout << tables.tableDir(shape) << "/distances.bin\n";
+  }
+  return 0;
+}
@@ -1,7 +1,12 @@
 #ifndef _TEST_UTIL_H_
 #define _TEST_UTIL_H_
 
+#include "BoardState.h"
 #include "GLogger.h"
+#include "GameUtil.h"
+#include "MoveGenerator.h"
+
+#include <vector>
 
 namespace tilepuzzles {
 
@@ -14,6 +19,23 @@ struct TestUtil {
     }
   }
 };
+
+// steps random generated moves away from state
+inline BoardState scramble(BoardState state, int steps) {
+  Move moves[256];
+  for (int i = 0; i < steps; ++i) {
+    int count = MoveGenerator::generate(state, moves);
+    MoveGenerator::apply(state, moves[GameUtil::trand(0, count)]);
+  }
+  return state;
+}
+
+inline bool replaysToSolved(BoardState state, const std::vector<Move>& moves) {
+  for (Move move : moves) {
+    MoveGenerator::apply(state, move);
+  }
+  return state.isSolved();
+}
 } // namespace tilepuzzles
 
-#endif
\ No newline at end of file
+#endif
@@ -0,0 +1,82 @@
+#define CATCH_CONFIG_PREFIX_ALL
+#include "AnytimeSolver.h"
+#include "BoardState.h"
+#include "GLogger.h"
+#include "GameUtil.h"
+#include "MoveGenerator.h"
+#include "TestUtil.h"
+#include <catch2/catch_test_macros.hpp>
+
+using namespace tilepuzzles;
+
+CATCH_TEST_CASE("AnytimeSolver", "[anytime_solver]") {
+  tilepuzzles::TestUtil::init_test();
+  tilepuzzles::Logger L;
+  GameUtil::init();
+
+  CATCH_SECTION("large boards within budget") {
+    for (PuzzleType type : {PuzzleType::SliderPuzzle, PuzzleType::RollerPuzzle}) {
+      for (int dim : {6, 10, 16, 20}) {
+        AnytimeSolver solver(dim, dim, type);
+        BoardState state = scramble(BoardState(type, dim, dim), 20 * dim * dim);
+        const double budget = dim > 10 ? 5. : 2.;
+        SolveResult result = solver.solve(state, budget);
+        CATCH_REQUIRE(result.solved);
+        CATCH_REQUIRE(replaysToSolved(state, result.moves));
+        CATCH_REQUIRE(result.seconds < budget + 0.5);
+        CATCH_REQUIRE_FALSE(solver.progress.empty());
+        for (size_t i = 1; i < solver.progress.size(); ++i) {
+          CATCH_REQUIRE(solver.progress[i].length < solver.progress[i - 1].length);
+          CATCH_REQUIRE(solver.progress[i].seconds >= solver.progress[i - 1].seconds);
+        }
+        CATCH_REQUIRE(solver.progress.back().length == result.moves.size());
+        L.info(type == PuzzleType::SliderPuzzle ? "slider" : "roller", dim, "first",
+               solver.progress.front().length, "at", solver.progress.front().seconds, "best",
+               result.moves.size(), "rounds", solver.progress.back().round, "secs", result.seconds);
+      }
+    }
+  }
+
+  CATCH_SECTION("rectangular boards") {
+    for (PuzzleType type : {PuzzleType::SliderPuzzle, PuzzleType::RollerPuzzle}) {
+      for (auto dims : {std::pair{4, 3}, std::pair{3, 5}, std::pair{2, 5}, std::pair{5, 2}, std::pair{4, 5}}) {
+        AnytimeSolver solver(dims.first, dims.second, type);
+        BoardState state = scramble(BoardState(type, dims.first, dims.second), 500);
+        SolveResult result = solver.solve(state, 0.2);
+        CATCH_REQUIRE(result.solved);
+        CATCH_REQUIRE(replaysToSolved(state, result.moves));
+      }
+    }
+  }
+
+  CATCH_SECTION("cancel and solved board") {
+    AnytimeSolver solver(4, 4, PuzzleType::SliderPuzzle);
+    SolveResult result = solver.solve(BoardState::slider(4, 4), 1.);
+    CATCH_REQUIRE(result.solved);
+    CATCH_REQUIRE(result.moves.empty());
+
+    std::atomic<bool> cancel = true;
+    result = solver.solve(scramble(BoardState::slider(4, 4), 200), 10., &cancel);
+    CATCH_REQUIRE_FALSE(result.solved);
+  }
+
+  CATCH_SECTION("shorten removes detours") {
+    BoardState state = scramble(BoardState::slider(5, 5), 300);
+    AnytimeSolver solver(5, 5, PuzzleType::SliderPuzzle);
+    SolveResult result = solver.solve(state, 0.5);
+    CATCH_REQUIRE(result.solved);
+
+    // a slide out and back in front of the solution
+    std::vector<Move> padded;
+    BoardState walk = state;
+    Move moves[256];
+    MoveGenerator::generate(walk, moves);
+    padded.push_back(moves[0]);
+    padded.push_back(MoveGenerator::inverse(moves[0]));
+    padded.insert(padded.end(), result.moves.begin(), result.moves.end());
+    CATCH_REQUIRE(replaysToSolved(state, padded));
+    AnytimeSolver::shorten(state, padded);
+    CATCH_REQUIRE(replaysToSolved(state, padded));
+    CATCH_REQUIRE(padded.size() <= result.moves.size());
+  }
+}
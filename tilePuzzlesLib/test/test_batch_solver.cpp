@@ -0,0 +1,170 @@
+#define CATCH_CONFIG_PREFIX_ALL
+#include "BatchSolver.h"
+#include "BoardState.h"
+#include "BoardSymmetry.h"
+#include "GameUtil.h"
+#include "MoveGenerator.h"
+#include "TestUtil.h"
+#include <catch2/catch_test_macros.hpp>
+
+#include <sstream>
+
+using namespace tilepuzzles;
+
+static json boardLine(const std::string& type, const json& dimension, const BoardState& state, int id) {
+  json line;
+  line["type"] = type;
+  line["dimension"] = dimension;
+  line["slots"] = state.slots;
+  line["id"] = id;
+  return line;
+}
+
+CATCH_TEST_CASE("BatchSolver", "[batch_solver]") {
+  tilepuzzles::TestUtil::init_test();
+  GameUtil::init();
+
+  CATCH_SECTION("results stream in input order and replay to solved") {
+    std::vector<BoardState> boards;
+    std::stringstream in;
+    for (int i = 0; i < 30; ++i) {
+      BoardState state;
+      json line;
+      switch (i % 4) {
+        case 0:
+          state = scramble(BoardState::slider(3, 3), 40);
+          line = boardLine("slider", {{"count", 8}}, state, i);
+          break;
+        case 1:
+          state = scramble(BoardState::roller(3, 3), 10);
+          line = boardLine("roller", {{"count", 9}}, state, i);
+          break;
+        case 2:
+          state = scramble(BoardState::hexSpinner(2, 2), 30);
+          line = boardLine("HexSpinner", {{"rows", 2}, {"columns", 2}}, state, i);
+          break;
+        default:
+          if (i == 27) {
+            state = scramble(BoardState::slider(25, 25), 5000);
+            line = boardLine("slider", {{"count", 624}}, state, i);
+          } else {
+            state = scramble(BoardState::slider(6, 6), 300);
+            line = boardLine("slider", {{"count", 35}}, state, i);
+          }
+          break;
+      }
+      boards.push_back(state);
+      in << line.dump() << "\n";
+    }
+    BatchOptions options;
+    options.threads = 2;
+    options.window = 3;
+    options.budgetSeconds = 0.1;
+    BatchSolver solver(options);
+    std::stringstream out;
+    CATCH_REQUIRE(solver.run(in, out) == boards.size());
+
+    std::string text;
+    size_t line = 0;
+    while (std::getline(out, text)) {
+      const json result = json::parse(text);
+      CATCH_REQUIRE(result["line"] == line);
+      CATCH_REQUIRE(result["id"] == line);
+      CATCH_REQUIRE(result["solved"] == true);
+      BoardState state = boards[line];
+      for (Move move : result["moves"].get<std::vector<Move>>()) {
+        MoveGenerator::apply(state, move);
+      }
+      CATCH_REQUIRE(state.isSolved());
+      if (line % 4 < 2) {
+        CATCH_REQUIRE(result["optimal"] == true);
+      }
+      ++line;
+    }
+    CATCH_REQUIRE(line == boards.size());
+  }
+
+  CATCH_SECTION("boards repeating up to symmetry are solved once") {
+    const BoardState roller = scramble(BoardState::roller(3, 3), 12);
+    const BoardState slider = scramble(BoardState::slider(4, 4), 60);
+    const BoardSymmetry& rollerSymmetry = BoardSymmetry::get(roller);
+    std::vector<BoardState> boards = {roller, slider, rollerSymmetry.transform(roller, 5),
+                                      BoardSymmetry::get(slider).transform(slider, 1), roller};
+    std::stringstream in;
+    for (size_t i = 0; i < boards.size(); ++i) {
+      const BoardState& board = boards[i];
+      in << boardLine(board.type == PuzzleType::SliderPuzzle ? "slider" : "roller",
+                      {{"count", board.type == PuzzleType::SliderPuzzle ? 15 : 9}}, board, i)
+                .dump()
+         << "\n";
+    }
+    BatchOptions options;
+    options.threads = 1;
+    BatchSolver solver(options);
+    std::stringstream out;
+    CATCH_REQUIRE(solver.run(in, out) == boards.size());
+
+    std::vector<json> results;
+    std::string text;
+    while (std::getline(out, text)) {
+      results.push_back(json::parse(text));
+    }
+    CATCH_REQUIRE_FALSE(results[0].contains("duplicateOf"));
+    CATCH_REQUIRE_FALSE(results[1].contains("duplicateOf"));
+    CATCH_REQUIRE(results[2]["duplicateOf"] == 0);
+    CATCH_REQUIRE(results[3]["duplicateOf"] == 1);
+    CATCH_REQUIRE(results[4]["duplicateOf"] == 0);
+    for (size_t i = 0; i < boards.size(); ++i) {
+      BoardState state = boards[i];
+      for (Move move : results[i]["moves"].get<std::vector<Move>>()) {
+        MoveGenerator::apply(state, move);
+      }
+      CATCH_REQUIRE(state.isSolved());
+      CATCH_REQUIRE(results[i]["length"] == results[i % 2]["length"]);
+    }
+
+    // solutions past the stored move budget are not kept for reuse
+    options.dedupeMoves = results[0]["length"].get<size_t>() - 1;
+    BatchSolver capped(options);
+    in.clear();
+    in.seekg(0);
+    std::stringstream cappedOut;
+    CATCH_REQUIRE(capped.run(in, cappedOut) == boards.size());
+    std::vector<json> cappedResults;
+    while (std::getline(cappedOut, text)) {
+      cappedResults.push_back(json::parse(text));
+    }
+    CATCH_REQUIRE_FALSE(cappedResults[2].contains("duplicateOf"));
+    CATCH_REQUIRE_FALSE(cappedResults[4].contains("duplicateOf"));
+    CATCH_REQUIRE(cappedResults[4]["solved"] == true);
+  }
+
+  CATCH_SECTION("bad lines report errors and keep their place") {
+    BoardState unsolvable = BoardState::slider(3, 3);
+    std::swap(unsolvable.slots[0], unsolvable.slots[1]);
+    std::stringstream in;
+    in << "not json\n";
+    in << R"({"type":"slider","dimension":{"count":8},"slots":[0,1,2]})" << "\n";
+    in << "\n";
+    in << boardLine("slider", {{"count", 8}}, unsolvable, 7).dump() << "\n";
+    in << R"({"type":"roller","dimension":{"count":9}})" << "\n";
+    BatchOptions options;
+    options.threads = 1;
+    BatchSolver solver(options);
+    std::stringstream out;
+    CATCH_REQUIRE(solver.run(in, out) == 4);
+
+    std::vector<json> results;
+    std::string text;
+    while (std::getline(out, text)) {
+      results.push_back(json::parse(text));
+    }
+    CATCH_REQUIRE(results.size() == 4);
+    CATCH_REQUIRE(results[0].contains("error"));
+    CATCH_REQUIRE(results[1].contains("error"));
+    CATCH_REQUIRE(results[2]["error"] == "unsolvable");
+    CATCH_REQUIRE(results[2]["id"] == 7);
+    CATCH_REQUIRE(results[3]["solved"] == true);
+    CATCH_REQUIRE(results[3]["length"] == 0);
+  }
+}
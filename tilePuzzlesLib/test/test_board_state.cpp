@@ -0,0 +1,114 @@
+#define CATCH_CONFIG_PREFIX_ALL
+#include "BoardState.h"
+#include "GLogger.h"
+#include "TestUtil.h"
+#include <catch2/catch_test_macros.hpp>
+
+using namespace tilepuzzles;
+
+CATCH_TEST_CASE("BoardState", "[board_state]") {
+  tilepuzzles::TestUtil::init_test();
+  tilepuzzles::Logger L;
+
+  CATCH_SECTION("slider slide") {
+    BoardState state = BoardState::slider(4, 4);
+    CATCH_REQUIRE(state.blank == 15);
+    CATCH_REQUIRE(state.slide(3));
+    CATCH_REQUIRE(state.blank == 3);
+    CATCH_REQUIRE(state.slots[15] == 11);
+    CATCH_REQUIRE(state.slots[7] == 3);
+    CATCH_REQUIRE_FALSE(state.slide(5));
+    CATCH_REQUIRE(state.slide(15));
+    CATCH_REQUIRE(state.isSolved());
+  }
+
+  CATCH_SECTION("roller roll") {
+    BoardState state = BoardState::roller(5, 5);
+    state.roll(12, Direction::right);
+    CATCH_REQUIRE(state.slots[10] == 14);
+    CATCH_REQUIRE(state.slots[11] == 10);
+    state.roll(12, Direction::left);
+    state.roll(3, Direction::down);
+    CATCH_REQUIRE(state.slots[3] == 23);
+    state.roll(3, Direction::up);
+    CATCH_REQUIRE(state.isSolved());
+  }
+
+  CATCH_SECTION("hex topology") {
+    BoardState state = BoardState::hexSpinner(3, 3);
+    CATCH_REQUIRE(state.size() == 54);
+    CATCH_REQUIRE(state.topology->anchors.size() == 17);
+    int dragable = std::count_if(state.topology->anchors.begin(), state.topology->anchors.end(),
+                                 [](const HexAnchor& a) { return a.dragable(); });
+    CATCH_REQUIRE(dragable == 9);
+    L.info("hex anchors", state.topology->anchors.size(), "dragable", dragable);
+  }
+
+  CATCH_SECTION("hex rotate and roll") {
+    const BoardState solved = BoardState::hexSpinner(3, 3);
+    BoardState state = solved;
+    state.rotateAnchor(2, 1);
+    CATCH_REQUIRE_FALSE(state.isSolved());
+    state.rotateAnchor(2, 5);
+    CATCH_REQUIRE(state == solved);
+
+    state.rollGroups(0, 1, Direction::down);
+    CATCH_REQUIRE_FALSE(state.isSolved());
+    state.rollGroups(0, 1, Direction::up);
+    CATCH_REQUIRE(state == solved);
+  }
+
+  CATCH_SECTION("state from config") {
+    const auto cfg = R"({
+      "type":"slider",
+        "dimension": {
+          "count": 15
+        }
+    })";
+    BoardState state = BoardState::fromConfig(json::parse(cfg));
+    CATCH_REQUIRE(state.type == PuzzleType::SliderPuzzle);
+    CATCH_REQUIRE(state.size() == 16);
+  }
+}
+
+CATCH_TEST_CASE("Zobrist", "[zobrist]") {
+  tilepuzzles::TestUtil::init_test();
+
+  CATCH_SECTION("incremental hash matches full rehash") {
+    BoardState slider = BoardState::slider(4, 4);
+    slider.slide(3);
+    slider.slide(0);
+    BoardState roller = BoardState::roller(5, 5);
+    roller.roll(7, Direction::down);
+    roller.roll(7, Direction::left);
+    BoardState hex = BoardState::hexSpinner(3, 3);
+    hex.rotateAnchor(6, 1);
+    hex.rollGroups(1, 0, Direction::right);
+
+    for (BoardState* state : {&slider, &roller, &hex}) {
+      const uint64_t hash = state->hash;
+      state->rehash();
+      CATCH_REQUIRE(hash == state->hash);
+    }
+  }
+
+  CATCH_SECTION("hash tracks position") {
+    const BoardState solved = BoardState::roller(5, 5);
+    BoardState state = solved;
+    state.roll(0, Direction::right);
+    CATCH_REQUIRE(state.hash != solved.hash);
+    state.roll(0, Direction::left);
+    CATCH_REQUIRE(state.hash == solved.hash);
+
+    BoardState hex = BoardState::hexSpinner(3, 3);
+    const uint64_t hexHash = hex.hash;
+    hex.rotateAnchor(0, 1);
+    CATCH_REQUIRE(hex.hash == hexHash);
+  }
+
+  CATCH_SECTION("large board keys") {
+    CATCH_REQUIRE(Zobrist::key(10, 70) == Zobrist::mix(10, 70));
+    CATCH_REQUIRE(Zobrist::key(3, 5) == Zobrist::mix(3, 5));
+    CATCH_REQUIRE(Zobrist::key(3, 5) != Zobrist::key(5, 3));
+  }
+}
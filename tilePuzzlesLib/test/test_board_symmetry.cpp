@@ -0,0 +1,119 @@
+#define CATCH_CONFIG_PREFIX_ALL
+#include "BoardState.h"
+#include "BoardSymmetry.h"
+#include "GameUtil.h"
+#include "MoveGenerator.h"
+#include "ParallelIda.h"
+#include "TestUtil.h"
+#include "TranspositionTable.h"
+#include <catch2/catch_test_macros.hpp>
+
+using namespace tilepuzzles;
+
+CATCH_TEST_CASE("BoardSymmetry", "[symmetry]") {
+  tilepuzzles::TestUtil::init_test();
+  GameUtil::init();
+
+  CATCH_SECTION("group sizes") {
+    CATCH_REQUIRE(BoardSymmetry::get(PuzzleType::SliderPuzzle, 4, 4).size() == 2);
+    CATCH_REQUIRE(BoardSymmetry::get(PuzzleType::SliderPuzzle, 3, 4).size() == 1);
+    // 8 mirrors and turns of the square times 9 shifts
+    CATCH_REQUIRE(BoardSymmetry::get(PuzzleType::RollerPuzzle, 3, 3).size() == 72);
+    CATCH_REQUIRE(BoardSymmetry::get(PuzzleType::RollerPuzzle, 3, 4).size() == 48);
+    CATCH_REQUIRE(BoardSymmetry::get(PuzzleType::HexSpinPuzzle, 3, 3).size() > 1);
+  }
+
+  CATCH_SECTION("images keep the solved board and map moves") {
+    for (BoardState shape : {BoardState::slider(4, 4), BoardState::roller(3, 4), BoardState::roller(4, 4),
+                             BoardState::hexSpinner(2, 2), BoardState::hexSpinner(3, 3)}) {
+      const BoardSymmetry& symmetry = BoardSymmetry::get(shape);
+      for (int e = 0; e < symmetry.size(); ++e) {
+        CATCH_REQUIRE(symmetry.transform(shape, e).isSolved());
+        BoardState state = scramble(shape, 20);
+        Move moves[256];
+        for (int i = 0; i < 20; ++i) {
+          const Move move = moves[GameUtil::trand(0, MoveGenerator::generate(state, moves))];
+          BoardState image = symmetry.transform(state, e);
+          MoveGenerator::apply(state, move);
+          MoveGenerator::apply(image, symmetry.mapMove(move, e));
+          CATCH_REQUIRE(image == symmetry.transform(state, e));
+        }
+        CATCH_REQUIRE(symmetry.transform(symmetry.transform(state, e), symmetry.inverse(e)) == state);
+      }
+    }
+  }
+
+  CATCH_SECTION("a class shares its canonical form") {
+    for (BoardState shape : {BoardState::slider(3, 3), BoardState::roller(3, 3), BoardState::hexSpinner(3, 3)}) {
+      const BoardSymmetry& symmetry = BoardSymmetry::get(shape);
+      const BoardState state = scramble(shape, 30);
+      const BoardState canonical = symmetry.canonical(state);
+      for (int e = 0; e < symmetry.size(); ++e) {
+        const BoardState image = symmetry.transform(state, e);
+        CATCH_REQUIRE(symmetry.canonicalHash(image) == canonical.hash);
+        CATCH_REQUIRE(symmetry.canonical(image) == canonical);
+        if (shape.type != PuzzleType::HexSpinPuzzle) {
+          CATCH_REQUIRE(symmetry.canonicalRank(image) == symmetry.canonicalRank(state));
+        }
+      }
+    }
+  }
+
+  CATCH_SECTION("unique keeps one board per class") {
+    const BoardSymmetry& symmetry = BoardSymmetry::get(PuzzleType::RollerPuzzle, 3, 3);
+    std::vector<BoardState> boards;
+    for (int i = 0; i < 10; ++i) {
+      const BoardState state = scramble(BoardState::roller(3, 3), 40);
+      boards.push_back(state);
+      boards.push_back(symmetry.transform(state, GameUtil::trand(0, symmetry.size())));
+    }
+    boards.push_back(BoardState::slider(3, 3));
+    const std::vector<size_t> kept = BoardSymmetry::unique(boards);
+    CATCH_REQUIRE(kept.size() == 11);
+    CATCH_REQUIRE(kept.back() == boards.size() - 1);
+  }
+
+  CATCH_SECTION("table keys tell board shapes apart") {
+    // the same tile array on boards of other types and dimensions
+    const BoardState wide = BoardState::slider(2, 4);
+    const BoardState tall = BoardState::slider(4, 2);
+    const BoardState roller = BoardState::roller(2, 4);
+    const Move noMove = ~Move(0);
+    const uint64_t wideKey = BoardSymmetry::get(wide).tableKey(wide.slots.data(), wide.size(), noMove, noMove);
+    CATCH_REQUIRE(wideKey != BoardSymmetry::get(tall).tableKey(tall.slots.data(), tall.size(), noMove, noMove));
+    CATCH_REQUIRE(wideKey != BoardSymmetry::get(roller).tableKey(roller.slots.data(), roller.size(), noMove, noMove));
+  }
+
+  CATCH_SECTION("table keys do not merge shifted boards of non-square rollers") {
+    const BoardSymmetry& symmetry = BoardSymmetry::get(PuzzleType::RollerPuzzle, 3, 4);
+    const Move noMove = ~Move(0);
+    for (int i = 0; i < 20; ++i) {
+      const BoardState state = scramble(BoardState::roller(3, 4), 30);
+      const uint64_t key = symmetry.tableKey(state.slots.data(), state.size(), noMove, noMove);
+      for (int e = 1; e < symmetry.size(); ++e) {
+        const BoardState image = symmetry.transform(state, e);
+        if (image.slots != state.slots) {
+          CATCH_REQUIRE(symmetry.tableKey(image.slots.data(), image.size(), noMove, noMove) != key);
+        }
+      }
+    }
+  }
+
+  CATCH_SECTION("searches sharing entries across the diagonal stay optimal") {
+    TranspositionTable table(4);
+    ParallelIdaSolver<SliderDomain<>> cached(SliderDomain<>(4, 4, SliderHeuristic(4, 4)), 2);
+    cached.table = &table;
+    ParallelIdaSolver<SliderDomain<>> plain(SliderDomain<>(4, 4, SliderHeuristic(4, 4)), 2);
+    const BoardSymmetry& symmetry = BoardSymmetry::get(PuzzleType::SliderPuzzle, 4, 4);
+    for (int i = 0; i < 5; ++i) {
+      const BoardState state = scramble(BoardState::slider(4, 4), 50);
+      const SolveResult expected = plain.solve(state);
+      table.newSearch();
+      const SolveResult first = cached.solve(state);
+      table.newSearch();
+      const SolveResult mirrored = cached.solve(symmetry.transform(state, 1));
+      CATCH_REQUIRE(first.moves.size() == expected.moves.size());
+      CATCH_REQUIRE(mirrored.moves.size() == expected.moves.size());
+    }
+  }
+}
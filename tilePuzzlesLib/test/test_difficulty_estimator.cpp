@@ -0,0 +1,93 @@
+#define CATCH_CONFIG_PREFIX_ALL
+#include "BoardState.h"
+#include "DifficultyEstimator.h"
+#include "GLogger.h"
+#include "GameUtil.h"
+#include "MoveGenerator.h"
+#include "TestUtil.h"
+#include <catch2/catch_test_macros.hpp>
+
+#include <chrono>
+
+using namespace tilepuzzles;
+
+static double meanScore(DifficultyEstimator& estimator, const BoardState& shape, int steps) {
+  double total = 0.;
+  for (int i = 0; i < 40; ++i) {
+    const Difficulty difficulty = estimator.estimate(scramble(shape, steps));
+    CATCH_REQUIRE(difficulty.solved);
+    CATCH_REQUIRE(difficulty.lowerBound <= difficulty.length);
+    CATCH_REQUIRE(difficulty.gap >= 0.);
+    CATCH_REQUIRE(difficulty.gap <= 1.);
+    CATCH_REQUIRE(difficulty.deadEnds <= 1.);
+    total += difficulty.score;
+  }
+  return total / 40;
+}
+
+CATCH_TEST_CASE("DifficultyEstimator", "[difficulty]") {
+  tilepuzzles::TestUtil::init_test();
+  tilepuzzles::Logger L;
+  GameUtil::init();
+
+  CATCH_SECTION("solved boards score zero, unsolvable ones are not solved") {
+    DifficultyEstimator estimator(PuzzleType::SliderPuzzle, 3, 3);
+    const Difficulty solved = estimator.estimate(BoardState::slider(3, 3));
+    CATCH_REQUIRE(solved.solved);
+    CATCH_REQUIRE(solved.length == 0);
+    CATCH_REQUIRE(solved.score == 0.);
+
+    BoardState unsolvable = BoardState::slider(3, 3);
+    unsolvable.swapSlots(0, 1);
+    CATCH_REQUIRE(!estimator.estimate(unsolvable).solved);
+  }
+
+  CATCH_SECTION("small sliders get optimal lengths") {
+    DifficultyEstimator estimator(PuzzleType::SliderPuzzle, 3, 3);
+    const BoardState board = scramble(BoardState::slider(3, 3), 200);
+    const Difficulty difficulty = estimator.estimate(board);
+    CATCH_REQUIRE(difficulty.optimal);
+    CATCH_REQUIRE(difficulty.length > 0);
+    CATCH_REQUIRE(difficulty.branching >= 1.);
+  }
+
+  CATCH_SECTION("scores rise with the scramble towards one") {
+    for (BoardState shape : {BoardState::slider(3, 3), BoardState::slider(4, 4), BoardState::roller(4, 4),
+                             BoardState::hexSpinner(3, 3)}) {
+      DifficultyEstimator estimator(shape.type, shape.rows, shape.columns);
+      const double light = meanScore(estimator, shape, 3);
+      const double medium = meanScore(estimator, shape, 12);
+      const double heavy = meanScore(estimator, shape, 400);
+      L.info("type", int(shape.type), "rows", shape.rows, "scores", light, medium, heavy);
+      CATCH_REQUIRE(light < medium);
+      CATCH_REQUIRE(medium < heavy);
+      CATCH_REQUIRE(heavy > 0.7);
+      CATCH_REQUIRE(heavy < 1.3);
+    }
+  }
+
+  CATCH_SECTION("scrambleTo stops at the target score") {
+    DifficultyEstimator estimator(PuzzleType::HexSpinPuzzle, 3, 3);
+    BoardState board = BoardState::hexSpinner(3, 3);
+    const int moves = estimator.scrambleTo(board, 0.5, 400);
+    CATCH_REQUIRE(moves < 400);
+    CATCH_REQUIRE(estimator.estimate(board).score >= 0.5);
+  }
+
+  CATCH_SECTION("tens of thousands of boards per minute") {
+    std::vector<BoardState> boards;
+    for (int i = 0; i < 2000; ++i) {
+      const BoardState shape = i % 2 ? BoardState::slider(3, 3) : BoardState::roller(4, 4);
+      boards.push_back(scramble(shape, GameUtil::trand(5, 40)));
+    }
+    // the per shape calibration is paid once, not per board
+    DifficultyEstimator::estimateAll({boards[0], boards[1]});
+    const auto begin = std::chrono::steady_clock::now();
+    const std::vector<Difficulty> results = DifficultyEstimator::estimateAll(boards);
+    const double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - begin).count();
+    L.info("boards per minute", boards.size() / seconds * 60);
+    CATCH_REQUIRE(results.size() == boards.size());
+    CATCH_REQUIRE(std::all_of(results.begin(), results.end(), [](const Difficulty& d) { return d.solved; }));
+    CATCH_REQUIRE(boards.size() / seconds * 60 > 20000.);
+  }
+}
@@ -1,6 +1,9 @@
 #define CATCH_CONFIG_PREFIX_ALL
 #include "GLogger.h"
 #include "SliderMesh.h"
+#include "RollerMesh.h"
+#include "HexSpinMesh.h"
+#include "MoveGenerator.h"
 #include "TestUtil.h"
 #include "Tile.h"
 #include "Vertex.h"
@@ -77,3 +80,202 @@ CATCH_TEST_CASE("EntityCreation", "[entity_creation]") {
     }
   }
 }
+
+// what tileAt and tileGroupAt answered before the grid index
+template <typename M>
+static auto scanTileAt(M& mesh, int row, int column) {
+  mesh.syncTiles();
+  auto iter = std::find_if(mesh.tiles.begin(), mesh.tiles.end(), [row, column](const auto& t) {
+    return row == t.gridCoord.x && column == t.gridCoord.y;
+  });
+  return iter != mesh.tiles.end() ? &*iter : nullptr;
+}
+
+template <typename M>
+static bool indexMatchesScan(M& mesh, int rows, int columns) {
+  for (int r = -1; r <= rows; ++r) {
+    for (int c = -1; c <= columns; ++c) {
+      if (mesh.tileAt(r, c) != scanTileAt(mesh, r, c)) {
+        return false;
+      }
+    }
+  }
+  return true;
+}
+
+// random packed moves through applyMove, the way replays and hints reach the meshes
+template <typename M>
+static void randomMoves(M& mesh, int count) {
+  tilepuzzles::Move moves[256];
+  for (int i = 0; i < count; ++i) {
+    const int n = tilepuzzles::MoveGenerator::generate(mesh.state, moves);
+    mesh.applyMove(moves[tilepuzzles::GameUtil::trand(0, n)]);
+  }
+}
+
+CATCH_TEST_CASE("MeshGridIndex", "[mesh_grid_index]") {
+  tilepuzzles::TestUtil::init_test();
+  tilepuzzles::Logger L;
+  tilepuzzles::GameUtil::init();
+
+  CATCH_SECTION("slider tiles follow slides and shuffles") {
+    tilepuzzles::SliderMesh mesh;
+    mesh.init(R"({"type":"slider","dimension":{"count":24}})");
+    CATCH_REQUIRE(indexMatchesScan(mesh, 5, 5));
+    mesh.shuffle();
+    CATCH_REQUIRE(indexMatchesScan(mesh, 5, 5));
+    for (int i = 0; i < 50; ++i) {
+      const tilepuzzles::Tile* blank = mesh.blankTile();
+      const int row = tilepuzzles::GameUtil::trand(0, 5);
+      tilepuzzles::Tile* tile = mesh.tileAt(row, blank->gridCoord.y);
+      const std::vector<tilepuzzles::Tile*> sliding = mesh.tilesToSlide(*tile);
+      CATCH_REQUIRE(std::find(sliding.begin(), sliding.end(), nullptr) == sliding.end());
+      mesh.slideTiles(*tile);
+      CATCH_REQUIRE(indexMatchesScan(mesh, 5, 5));
+    }
+    randomMoves(mesh, 50);
+    CATCH_REQUIRE(indexMatchesScan(mesh, 5, 5));
+  }
+
+  CATCH_SECTION("roller tiles follow rolls") {
+    tilepuzzles::RollerMesh mesh;
+    mesh.init(R"({"type":"roller","dimension":{"count":625}})");
+    mesh.shuffle();
+    CATCH_REQUIRE(indexMatchesScan(mesh, 25, 25));
+    for (int i = 0; i < 50; ++i) {
+      const int row = tilepuzzles::GameUtil::trand(0, 25);
+      tilepuzzles::Tile* tile = mesh.tileAt(row, tilepuzzles::GameUtil::trand(0, 25));
+      const tilepuzzles::Direction dir = tilepuzzles::Direction(tilepuzzles::GameUtil::trand(0, 4));
+      const std::vector<tilepuzzles::Tile*> rolled = mesh.rollTiles(*tile, dir);
+      CATCH_REQUIRE(rolled.size() == 25);
+      CATCH_REQUIRE(std::find(rolled.begin(), rolled.end(), nullptr) == rolled.end());
+    }
+    CATCH_REQUIRE(indexMatchesScan(mesh, 25, 25));
+  }
+
+  CATCH_SECTION("hex tiles and tile groups follow rotations and group rolls") {
+    tilepuzzles::HexSpinMesh mesh;
+    mesh.init(R"({"type":"HexSpinner","dimension":{"rows":3,"columns":3}})");
+    mesh.shuffle();
+    randomMoves(mesh, 20);
+    CATCH_REQUIRE(indexMatchesScan(mesh, 6, 9));
+    for (int r = -1; r <= 3; ++r) {
+      for (int c = -1; c <= 3; ++c) {
+        auto iter = std::find_if(mesh.tileGroupAnchors.begin(), mesh.tileGroupAnchors.end(),
+                                 [r, c](const auto& t) { return r == t.gridCoord.x && c == t.gridCoord.y; });
+        auto* scanned = iter != mesh.tileGroupAnchors.end() && r >= 0 && c >= 0 ? &*iter : nullptr;
+        CATCH_REQUIRE(mesh.tileGroupAt(r, c) == scanned);
+      }
+    }
+  }
+}
+
+// what hitTest answered before the spatial grid: the first tile in tiles order
+template <typename M>
+static auto scanHitTest(M& mesh, const math::float3& point) {
+  mesh.syncTiles();
+  auto iter = std::find_if(mesh.tiles.begin(), mesh.tiles.end(),
+                           [&point](const auto& t) { return t.onClick({point.x, point.y}); });
+  return iter != mesh.tiles.end() ? &*iter : nullptr;
+}
+
+// uniform points plus points jittered around tile vertices, where neighbours tie
+template <typename M>
+static bool hitTestMatchesScan(M& mesh, int samples) {
+  using tilepuzzles::GameUtil;
+  for (int i = 0; i < samples; ++i) {
+    math::float3 point = {GameUtil::frand(-1.1F, 1.1F), GameUtil::frand(-1.1F, 1.1F), 0.F};
+    if (i % 2) {
+      const auto vert = mesh.tiles[GameUtil::trand(0, mesh.tiles.size())].getVert(GameUtil::trand(0, 3));
+      point = {vert.x + GameUtil::frand(-.01F, .01F), vert.y + GameUtil::frand(-.01F, .01F), 0.F};
+    }
+    if (mesh.hitTest(point) != scanHitTest(mesh, point)) {
+      return false;
+    }
+  }
+  return true;
+}
+
+CATCH_TEST_CASE("MeshHitGrid", "[mesh_hit_grid]") {
+  tilepuzzles::TestUtil::init_test();
+  tilepuzzles::Logger L;
+  tilepuzzles::GameUtil::init();
+
+  CATCH_SECTION("slider picks follow slides") {
+    tilepuzzles::SliderMesh mesh;
+    mesh.init(R"({"type":"slider","dimension":{"count":24}})");
+    CATCH_REQUIRE(hitTestMatchesScan(mesh, 2000));
+    mesh.shuffle();
+    CATCH_REQUIRE(hitTestMatchesScan(mesh, 2000));
+    randomMoves(mesh, 50);
+    CATCH_REQUIRE(hitTestMatchesScan(mesh, 2000));
+  }
+
+  CATCH_SECTION("roller picks follow rolls") {
+    tilepuzzles::RollerMesh mesh;
+    mesh.init(R"({"type":"roller","dimension":{"count":625}})");
+    mesh.shuffle();
+    CATCH_REQUIRE(hitTestMatchesScan(mesh, 5000));
+    for (int i = 0; i < 20; ++i) {
+      tilepuzzles::Tile* tile = mesh.hitTest({tilepuzzles::GameUtil::frand(-1.F, 1.F), 0.F, 0.F});
+      CATCH_REQUIRE(tile != nullptr);
+      mesh.rollTiles(*tile, tilepuzzles::Direction(tilepuzzles::GameUtil::trand(0, 4)));
+      CATCH_REQUIRE(hitTestMatchesScan(mesh, 200));
+    }
+  }
+
+  CATCH_SECTION("hex picks follow rotations, mid-drag geometry and anchors") {
+    tilepuzzles::HexSpinMesh mesh;
+    mesh.init(R"({"type":"HexSpinner","dimension":{"rows":3,"columns":3}})");
+    CATCH_REQUIRE(hitTestMatchesScan(mesh, 5000));
+    mesh.shuffle();
+    randomMoves(mesh, 20);
+    CATCH_REQUIRE(hitTestMatchesScan(mesh, 5000));
+
+    auto& group = *std::find_if(mesh.tileGroupAnchors.begin(), mesh.tileGroupAnchors.end(),
+                                [](const auto& t) { return t.dragable; });
+    mesh.rotateTileGroup(group, .3F);
+    CATCH_REQUIRE(hitTestMatchesScan(mesh, 5000));
+    mesh.rotateTileGroup(group, tilepuzzles::GeoUtil::PI_3 - .3F);
+    mesh.commitRotation(group, tilepuzzles::GeoUtil::PI_3);
+    mesh.processAnchorGroups();
+    CATCH_REQUIRE(hitTestMatchesScan(mesh, 5000));
+
+    // batched group building picks the six tiles one hitTest each used to
+    const float a = mesh.tiles[0].size.x;
+    const float h = mesh.tiles[0].size.y;
+    for (const auto& anchor : mesh.tileGroupAnchors) {
+      if (!anchor.dragable) {
+        continue;
+      }
+      const math::float2 pt = anchor.anchorPoint;
+      std::vector<int> scanned;
+      for (float y : {pt.y + h * .5F, pt.y - h * .5F}) {
+        for (float x : {pt.x - a * .5F, pt.x, pt.x + a * .5F}) {
+          auto* tile = scanHitTest(mesh, {x, y, 0.F});
+          if (tile) {
+            scanned.push_back(tile->tileNum);
+          }
+        }
+      }
+      std::vector<int> grouped;
+      for (const auto& tile : anchor.tileGroup) {
+        grouped.push_back(tile.tileNum);
+      }
+      CATCH_REQUIRE(grouped.size() == 6);
+      CATCH_REQUIRE(grouped == scanned);
+    }
+
+    for (int i = 0; i < 2000; ++i) {
+      const auto& anchor = mesh.tileGroupAnchors[tilepuzzles::GameUtil::trand(0, mesh.tileGroupAnchors.size())];
+      const math::float3 point = {anchor.anchorPoint.x + tilepuzzles::GameUtil::frand(-.06F, .06F),
+                                               anchor.anchorPoint.y + tilepuzzles::GameUtil::frand(-.06F, .06F),
+                                               0.F};
+      auto iter = std::find_if(mesh.tileGroupAnchors.begin(), mesh.tileGroupAnchors.end(), [&point](const auto& t) {
+        return std::abs(t.anchorPoint.x - point.x) <= tilepuzzles::GeoUtil::EPS_4 &&
+               std::abs(t.anchorPoint.y - point.y) <= tilepuzzles::GeoUtil::EPS_4;
+      });
+      CATCH_REQUIRE(mesh.hitTestAnchor(point) == (iter != mesh.tileGroupAnchors.end() ? &*iter : nullptr));
+    }
+  }
+}
@@ -0,0 +1,196 @@
+#define CATCH_CONFIG_PREFIX_ALL
+#include "BoardState.h"
+#include "ExternalBfs.h"
+#include "GLogger.h"
+#include "GameUtil.h"
+#include "MoveGenerator.h"
+#include "PermRank.h"
+#include "TestUtil.h"
+#include <catch2/catch_test_macros.hpp>
+
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <vector>
+
+using namespace tilepuzzles;
+
+// in memory BFS over lexicographic ranks, the reference for the disk version
+static std::vector<uint8_t> memoryBfs(const BoardState& shape) {
+  std::vector<uint8_t> distances(PermRank::factorial(shape.size()), DistanceTable::UNREACHED);
+  std::vector<uint64_t> layer = {PermRank::rank(shape)};
+  distances[layer[0]] = 0;
+  Move moves[64];
+  for (int d = 1; !layer.empty(); ++d) {
+    std::vector<uint64_t> next;
+    for (uint64_t rank : layer) {
+      BoardState state = PermRank::unrank(shape, rank);
+      const int count = MoveGenerator::generate(state, moves);
+      for (int i = 0; i < count; ++i) {
+        MoveGenerator::apply(state, moves[i]);
+        const uint64_t child = PermRank::rank(state);
+        if (distances[child] == DistanceTable::UNREACHED) {
+          distances[child] = d;
+          next.push_back(child);
+        }
+        MoveGenerator::unapply(state, moves[i]);
+      }
+    }
+    layer.swap(next);
+  }
+  return distances;
+}
+
+static std::vector<char> readFile(const std::string& path) {
+  std::ifstream input(path, std::ios::binary);
+  return std::vector<char>(std::istreambuf_iterator<char>(input), {});
+}
+
+CATCH_TEST_CASE("ExternalBfs", "[external_bfs]") {
+  tilepuzzles::TestUtil::init_test();
+  tilepuzzles::Logger L;
+  GameUtil::init();
+  const std::string root = (std::filesystem::temp_directory_path() / "tilepuzzles_external_bfs").string();
+  std::filesystem::remove_all(root);
+
+  CATCH_SECTION("matches in memory BFS with many runs") {
+    for (const BoardState& shape : {BoardState::slider(3, 3), BoardState::roller(2, 4)}) {
+      const std::string dir = root + "/full";
+      std::filesystem::remove_all(dir);
+      ExternalBfs bfs(shape, dir, 4096);
+      CATCH_REQUIRE(bfs.run());
+      CATCH_REQUIRE(bfs.done);
+
+      const std::vector<uint8_t> expected = memoryBfs(shape);
+      DistanceTable table;
+      CATCH_REQUIRE(table.open(bfs.distancesPath()));
+      CATCH_REQUIRE(table.covers(shape));
+      CATCH_REQUIRE(table.maxDistance() == bfs.counts.size() - 1);
+      std::vector<uint64_t> counts(bfs.counts.size());
+      int mismatches = 0;
+      for (uint64_t rank = 0; rank < expected.size(); ++rank) {
+        const BoardState state = PermRank::unrank(shape, rank);
+        mismatches += table.distance(state) != expected[rank];
+        if (expected[rank] != DistanceTable::UNREACHED) {
+          ++counts[expected[rank]];
+        }
+      }
+      CATCH_REQUIRE(mismatches == 0);
+      CATCH_REQUIRE(counts == bfs.counts);
+      for (int d = 0; d <= table.maxDistance(); ++d) {
+        CATCH_REQUIRE(table.count(d) == counts[d]);
+      }
+      L.info("God's number", table.maxDistance(), "positions", expected.size());
+    }
+  }
+
+  CATCH_SECTION("hints follow an optimal path") {
+    const BoardState shape = BoardState::slider(3, 3);
+    ExternalBfs bfs(shape, root + "/hints");
+    CATCH_REQUIRE(bfs.run());
+    DistanceTable table;
+    CATCH_REQUIRE(table.open(bfs.distancesPath()));
+    Move moves[64];
+    for (int i = 0; i < 20; ++i) {
+      BoardState state = shape;
+      for (int s = 0; s < 40; ++s) {
+        MoveGenerator::apply(state, moves[GameUtil::trand(0, MoveGenerator::generate(state, moves))]);
+      }
+      const int distance = table.distance(state);
+      Move move;
+      for (int step = 0; step < distance; ++step) {
+        CATCH_REQUIRE(table.hint(state, move));
+        MoveGenerator::apply(state, move);
+      }
+      CATCH_REQUIRE(state.isSolved());
+      CATCH_REQUIRE_FALSE(table.hint(state, move));
+    }
+  }
+
+  CATCH_SECTION("symmetric tables store one distance per class") {
+    for (const BoardState& shape : {BoardState::slider(3, 3), BoardState::roller(3, 3)}) {
+      ExternalBfs plain(shape, root + "/plain");
+      CATCH_REQUIRE(plain.run());
+      ExternalBfs reduced(shape, root + "/symmetric");
+      reduced.symmetric = true;
+      CATCH_REQUIRE(reduced.run());
+
+      DistanceTable full;
+      DistanceTable table;
+      CATCH_REQUIRE(full.open(plain.distancesPath()));
+      CATCH_REQUIRE(table.open(reduced.distancesPath()));
+      CATCH_REQUIRE(table.isSymmetric());
+      CATCH_REQUIRE(table.maxDistance() == full.maxDistance());
+      int mismatches = 0;
+      for (uint64_t rank = 0; rank < PermRank::factorial(shape.size()); ++rank) {
+        const BoardState state = PermRank::unrank(shape, rank);
+        mismatches += table.distance(state) != full.distance(state);
+      }
+      CATCH_REQUIRE(mismatches == 0);
+      L.info("type", int(shape.type), "table bytes", full.tableBytes(), "symmetric", table.tableBytes());
+      CATCH_REQUIRE(table.tableBytes() < full.tableBytes() * 2 / 3);
+
+      BoardState state = shape;
+      Move moves[64];
+      for (int s = 0; s < 40; ++s) {
+        MoveGenerator::apply(state, moves[GameUtil::trand(0, MoveGenerator::generate(state, moves))]);
+      }
+      Move move;
+      for (int distance = table.distance(state); distance > 0; --distance) {
+        CATCH_REQUIRE(table.hint(state, move));
+        MoveGenerator::apply(state, move);
+      }
+      CATCH_REQUIRE(state.isSolved());
+      std::filesystem::remove_all(root + "/plain");
+      std::filesystem::remove_all(root + "/symmetric");
+    }
+  }
+
+  CATCH_SECTION("resumes after interruption") {
+    const BoardState shape = BoardState::roller(3, 3);
+    ExternalBfs once(shape, root + "/once", 1 << 14);
+    CATCH_REQUIRE(once.run());
+
+    const std::string dir = root + "/resumed";
+    {
+      ExternalBfs first(shape, dir, 1 << 14);
+      CATCH_REQUIRE(first.run(3));
+      CATCH_REQUIRE_FALSE(first.done);
+      CATCH_REQUIRE(first.counts.size() == 4);
+    }
+    // a crash mid layer leaves stale runs and a partial layer behind
+    std::ofstream(dir + "/run-00000.bin") << "partial";
+    std::ofstream(dir + "/layer-004.bin.tmp") << "partial";
+    ExternalBfs second(shape, dir, 1 << 14);
+    CATCH_REQUIRE(second.run());
+    CATCH_REQUIRE(second.done);
+    CATCH_REQUIRE(second.counts == once.counts);
+    CATCH_REQUIRE(readFile(second.distancesPath()) == readFile(once.distancesPath()));
+
+    // finished runs are not redone
+    ExternalBfs third(shape, dir);
+    CATCH_REQUIRE(third.run());
+    CATCH_REQUIRE(third.counts == once.counts);
+
+    ExternalBfs other(BoardState::slider(3, 3), dir);
+    CATCH_REQUIRE_FALSE(other.run());
+
+    // damaged checkpoints fail run() instead of throwing
+    const std::string damaged = root + "/damaged";
+    for (const char* text : {R"({"type":1,"rows":3,"columns":3})", R"({"type":1,"rows":3,"columns":3,"counts":7})",
+                             R"({"type":1,"rows":3,"columns":3,"counts":["x"]})", R"({"type":"roller"})", "[1,2]"}) {
+      std::filesystem::create_directories(damaged);
+      std::ofstream(damaged + "/checkpoint.json") << text;
+      ExternalBfs broken(shape, damaged);
+      CATCH_REQUIRE_FALSE(broken.run());
+    }
+  }
+
+  CATCH_SECTION("boards past MAX_SLOTS fail before touching the disk") {
+    ExternalBfs large(BoardState::slider(4, 4), root + "/large");
+    CATCH_REQUIRE_FALSE(large.run());
+    CATCH_REQUIRE_FALSE(std::filesystem::exists(root + "/large"));
+  }
+
+  std::filesystem::remove_all(root);
+}
@@ -0,0 +1,92 @@
+#define CATCH_CONFIG_PREFIX_ALL
+#include "BoardState.h"
+#include "GLogger.h"
+#include "GameUtil.h"
+#include "HexSolver.h"
+#include "MoveGenerator.h"
+#include "TestUtil.h"
+#include <catch2/catch_test_macros.hpp>
+
+#include <chrono>
+
+using namespace tilepuzzles;
+
+CATCH_TEST_CASE("HexSolver", "[hex_solver]") {
+  tilepuzzles::TestUtil::init_test();
+  tilepuzzles::Logger L;
+  GameUtil::init();
+
+  CATCH_SECTION("macro table") {
+    const HexMacroTable& table = HexMacroTable::get(3, 3);
+    CATCH_REQUIRE(&table == &HexMacroTable::get(3, 3));
+    CATCH_REQUIRE(table.entries.size() > table.moveCount);
+    BoardState solved = BoardState::hexSpinner(3, 3);
+    for (int e = table.moveCount; e < table.entries.size(); ++e) {
+      const HexMacroTable::Entry& entry = table.entries[e];
+      CATCH_REQUIRE(entry.from.size() <= HexMacroTable::MAX_SUPPORT);
+      BoardState state = solved;
+      for (Move move : entry.moves) {
+        MoveGenerator::apply(state, move);
+      }
+      for (int i = 0; i < entry.from.size(); ++i) {
+        CATCH_REQUIRE(state.slots[entry.to[i]] == entry.from[i]);
+      }
+    }
+    for (int i = 0; i < 200; ++i) {
+      const int a = GameUtil::trand(0, 54);
+      const int b = (a + GameUtil::trand(1, 53)) % 54;
+      int c = GameUtil::trand(0, 54);
+      while (c == a || c == b) {
+        c = GameUtil::trand(0, 54);
+      }
+      CATCH_REQUIRE(table.cycleLength(a, b, c) > 0);
+      BoardState state = solved;
+      for (Move move : table.cycle(a, b, c)) {
+        MoveGenerator::apply(state, move);
+      }
+      int moved = 0;
+      for (int s = 0; s < state.size(); ++s) {
+        moved += state.slots[s] != s;
+      }
+      CATCH_REQUIRE(moved == 3);
+      CATCH_REQUIRE(state.slots[b] == a);
+      CATCH_REQUIRE(state.slots[c] == b);
+      CATCH_REQUIRE(state.slots[a] == c);
+    }
+    L.info("hex macros", table.entries.size() - table.moveCount);
+  }
+
+  CATCH_SECTION("solves scrambled 3x3 boards") {
+    HexSolver solver(3, 3);
+    double slowest = 0.;
+    size_t longest = 0;
+    for (int i = 0; i < 200; ++i) {
+      const BoardState state = scramble(BoardState::hexSpinner(3, 3), 400);
+      SolveResult result = solver.solve(state);
+      CATCH_REQUIRE(result.solved);
+      CATCH_REQUIRE(replaysToSolved(state, result.moves));
+      slowest = std::max(slowest, result.seconds);
+      longest = std::max(longest, result.moves.size());
+    }
+    CATCH_REQUIRE(slowest < .1);
+    L.info("hex 3x3 slowest secs", slowest, "longest", longest);
+  }
+
+  CATCH_SECTION("other sizes and hints") {
+    for (auto dims : {std::pair{2, 2}, std::pair{2, 3}, std::pair{4, 4}}) {
+      HexSolver solver(dims.first, dims.second);
+      for (int i = 0; i < 20; ++i) {
+        const BoardState state = scramble(BoardState::hexSpinner(dims.first, dims.second), 400);
+        SolveResult result = solver.solve(state);
+        CATCH_REQUIRE(result.solved);
+        CATCH_REQUIRE(replaysToSolved(state, result.moves));
+      }
+    }
+    HexSolver solver(3, 3);
+    Move move;
+    CATCH_REQUIRE_FALSE(solver.hint(BoardState::hexSpinner(3, 3), move));
+    const BoardState state = scramble(BoardState::hexSpinner(3, 3), 50);
+    CATCH_REQUIRE(solver.hint(state, move));
+    CATCH_REQUIRE(move == solver.solve(state).moves[0]);
+  }
+}
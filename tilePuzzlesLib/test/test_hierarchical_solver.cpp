@@ -0,0 +1,91 @@
+#define CATCH_CONFIG_PREFIX_ALL
+#include "BoardState.h"
+#include "GLogger.h"
+#include "GameUtil.h"
+#include "HierarchicalSolver.h"
+#include "MoveGenerator.h"
+#include "Solvability.h"
+#include "TestUtil.h"
+#include <catch2/catch_test_macros.hpp>
+
+#include <algorithm>
+
+using namespace tilepuzzles;
+
+static BoardState shuffled(int rows, int columns) {
+  BoardState state = BoardState::slider(rows, columns);
+  GameUtil::shuffleSlots(state);
+  Solvability::makeSolvable(state);
+  return state;
+}
+
+CATCH_TEST_CASE("HierarchicalSolver", "[hierarchical_solver]") {
+  tilepuzzles::TestUtil::init_test();
+  tilepuzzles::Logger L;
+  GameUtil::init();
+
+  CATCH_SECTION("endgame tables hold the known diameters") {
+    const EndgameTable& square = EndgameTable::get(3, 3);
+    const EndgameTable& wide = EndgameTable::get(2, 3);
+    auto diameter = [](const EndgameTable& table) {
+      int longest = 0;
+      for (uint8_t d : table.distances) {
+        longest = d == EndgameTable::UNREACHABLE ? longest : std::max<int>(longest, d);
+      }
+      return longest;
+    };
+    CATCH_REQUIRE(diameter(square) == 31);
+    CATCH_REQUIRE(diameter(wide) == 21);
+    CATCH_REQUIRE(std::count(square.distances.begin(), square.distances.end(), EndgameTable::UNREACHABLE) ==
+                  181440);
+  }
+
+  CATCH_SECTION("shuffled boards of every shape replay to solved") {
+    for (auto [rows, columns] : {std::pair{2, 2}, {2, 3}, {3, 2}, {3, 3}, {4, 4}, {2, 9}, {9, 2}, {3, 8},
+                                 {7, 3}, {5, 7}, {10, 10}, {20, 20}, {31, 17}}) {
+      HierarchicalSolver solver(rows, columns);
+      for (int i = 0; i < 20; ++i) {
+        const BoardState start = shuffled(rows, columns);
+        const SolveResult result = solver.solve(start);
+        CATCH_REQUIRE(result.solved);
+        CATCH_REQUIRE(replaysToSolved(start, result.moves));
+      }
+    }
+  }
+
+  CATCH_SECTION("a 100x100 board solves within a second") {
+    HierarchicalSolver solver(100, 100);
+    const BoardState start = shuffled(100, 100);
+    const SolveResult result = solver.solve(start);
+    L.info("100x100 moves", result.moves.size(), "secs", result.seconds);
+    CATCH_REQUIRE(result.solved);
+    CATCH_REQUIRE(result.seconds < 1.);
+    CATCH_REQUIRE(replaysToSolved(start, result.moves));
+  }
+
+  CATCH_SECTION("moves stream out and the sink can stop the solve") {
+    HierarchicalSolver solver(30, 30);
+    const BoardState start = shuffled(30, 30);
+    BoardState state = start;
+    int received = 0;
+    CATCH_REQUIRE_FALSE(solver.solve(start, [&](Move move) {
+      MoveGenerator::apply(state, move);
+      return ++received < 1000;
+    }));
+    CATCH_REQUIRE(received == 1000);
+    CATCH_REQUIRE(solver.moveCount == 1000);
+
+    // the stopped position solves on its own
+    const SolveResult rest = solver.solve(state);
+    CATCH_REQUIRE(rest.solved);
+    CATCH_REQUIRE(replaysToSolved(state, rest.moves));
+  }
+
+  CATCH_SECTION("unsolvable boards fail") {
+    BoardState state = BoardState::slider(8, 8);
+    std::swap(state.slots[0], state.slots[1]);
+    state.rehash();
+    HierarchicalSolver solver(8, 8);
+    CATCH_REQUIRE_FALSE(solver.solve(state).solved);
+  }
+}
@@ -0,0 +1,112 @@
+#define CATCH_CONFIG_PREFIX_ALL
+#include "BoardState.h"
+#include "GLogger.h"
+#include "GameUtil.h"
+#include "HintService.h"
+#include "MoveGenerator.h"
+#include "Solvability.h"
+#include "TestUtil.h"
+#include <catch2/catch_test_macros.hpp>
+
+#include <chrono>
+#include <thread>
+
+using namespace tilepuzzles;
+
+// posts and polls like a game loop would, one frame at a time
+static bool waitForHint(HintService& hints, const BoardState& state, Move& move, double seconds) {
+  const auto end = std::chrono::steady_clock::now() + std::chrono::duration<double>(seconds);
+  while (std::chrono::steady_clock::now() < end) {
+    hints.post(state);
+    if (hints.poll(state, move)) {
+      return true;
+    }
+    std::this_thread::sleep_for(std::chrono::milliseconds(16));
+  }
+  return false;
+}
+
+// follows cached hints to the solved board, each poll must answer at once
+static bool followHints(HintService& hints, BoardState state, int maxMoves) {
+  for (int i = 0; i < maxMoves && !state.isSolved(); ++i) {
+    Move move;
+    if (!hints.poll(state, move)) {
+      return false;
+    }
+    MoveGenerator::apply(state, move);
+    hints.post(state);
+  }
+  return state.isSolved();
+}
+
+CATCH_TEST_CASE("HintService", "[hint_service]") {
+  tilepuzzles::TestUtil::init_test();
+  tilepuzzles::Logger L;
+  GameUtil::init();
+
+  CATCH_SECTION("slider, roller and hex hints lead to the solved board") {
+    for (BoardState shape : {BoardState::slider(3, 3), BoardState::slider(6, 6), BoardState::roller(4, 4),
+                             BoardState::hexSpinner(3, 3)}) {
+      HintService hints;
+      hints.budgetSeconds = 0.3;
+      BoardState state = scramble(shape, 300);
+      Move move;
+      CATCH_REQUIRE_FALSE(hints.poll(state, move));
+      hints.post(state);
+      CATCH_REQUIRE(waitForHint(hints, state, move, 5.));
+      CATCH_REQUIRE(followHints(hints, state, 10000));
+    }
+  }
+
+  CATCH_SECTION("huge sliders get hints from the hierarchical solver") {
+    HintService hints;
+    BoardState state = BoardState::slider(30, 30);
+    GameUtil::shuffleSlots(state);
+    Solvability::makeSolvable(state);
+    hints.post(state);
+    Move move;
+    CATCH_REQUIRE(waitForHint(hints, state, move, 2.));
+    CATCH_REQUIRE(followHints(hints, state, 200000));
+  }
+
+  CATCH_SECTION("post and poll stay within a frame while the worker searches") {
+    HintService hints;
+    hints.budgetSeconds = 1.;
+    BoardState state = scramble(BoardState::roller(10, 10), 2000);
+    hints.post(state);
+    Move move;
+    double worst = 0.;
+    for (int i = 0; i < 50; ++i) {
+      const auto start = std::chrono::steady_clock::now();
+      hints.post(state);
+      hints.poll(state, move);
+      worst = std::max(worst, std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count());
+      std::this_thread::sleep_for(std::chrono::milliseconds(5));
+    }
+    L.info("worst post and poll secs", worst);
+    CATCH_REQUIRE(worst < 0.016);
+  }
+
+  CATCH_SECTION("a new position cancels the running search") {
+    HintService hints;
+    hints.budgetSeconds = 30.;
+    BoardState first = scramble(BoardState::slider(10, 10), 2000);
+    hints.post(first);
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    CATCH_REQUIRE(hints.busy());
+
+    BoardState second = scramble(BoardState::slider(10, 10), 2000);
+    const auto start = std::chrono::steady_clock::now();
+    hints.post(second);
+    Move move;
+    CATCH_REQUIRE(waitForHint(hints, second, move, 5.));
+    CATCH_REQUIRE(std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count() < 5.);
+
+    hints.cancel();
+    const auto stopping = std::chrono::steady_clock::now();
+    while (hints.busy() && std::chrono::steady_clock::now() - stopping < std::chrono::seconds(1)) {
+      std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    CATCH_REQUIRE_FALSE(hints.busy());
+  }
+}
@@ -0,0 +1,110 @@
+#define CATCH_CONFIG_PREFIX_ALL
+#include "GameUtil.h"
+#include "HitKernels.h"
+#include "TestUtil.h"
+#include <catch2/catch_test_macros.hpp>
+
+#include <math/vec3.h>
+#include <math/vec4.h>
+
+using namespace filament;
+using namespace tilepuzzles;
+
+// HexTile::isInside as it was, one triangle at a time with four areas
+static float area(const math::float3& v1, const math::float3& v2, const math::float3& v3) {
+  return abs((v1[0] * (v2[1] - v3[1]) + v2[0] * (v3[1] - v1[1]) + v3[0] * (v1[1] - v2[1])) / 2.0);
+}
+
+static float areaExcess(const math::float3& v1, const math::float3& v2, const math::float3& v3,
+                        const math::float3& p) {
+  return abs(area(v1, v2, v3) - (area(p, v2, v3) + area(v1, p, v3) + area(v1, v2, p)));
+}
+
+static math::float3 randomPoint() {
+  return {GameUtil::frand(-1.F, 1.F), GameUtil::frand(-1.F, 1.F), 0.F};
+}
+
+CATCH_TEST_CASE("HitKernels", "[hit_kernels]") {
+  TestUtil::init_test();
+  GameUtil::init();
+  const float EPS = 0.001F;
+
+  CATCH_SECTION("edge functions agree with the area sum test") {
+    int inside = 0;
+    for (int i = 0; i < 20000; ++i) {
+      const math::float3 v[] = {randomPoint(), randomPoint(), randomPoint()};
+      const math::float3 p = i % 2 ? randomPoint() : (v[0] + v[1] + v[2]) / 3.F + randomPoint() * .05F;
+      const float excess = areaExcess(v[0], v[1], v[2], p);
+      if (std::abs(excess - EPS) < 1e-5F) {
+        continue; // on the tolerance boundary the two roundings may differ
+      }
+      const bool contains = TriangleEdges::of(v[0], v[1], v[2]).contains(p.x, p.y, EPS);
+      CATCH_REQUIRE(contains == (excess <= EPS));
+      inside += contains;
+    }
+    CATCH_REQUIRE(inside > 5000);
+  }
+
+  CATCH_SECTION("triangle batches return the first containing triangle") {
+    for (int size = 0; size <= 20; ++size) {
+      std::vector<TriangleEdges> edges;
+      TriangleBatch batch;
+      batch.resize(size);
+      for (int i = 0; i < size; ++i) {
+        edges.push_back(TriangleEdges::of(randomPoint(), randomPoint(), randomPoint()));
+        batch.set(i, edges.back());
+      }
+      for (int k = 0; k < 500; ++k) {
+        const math::float3 p = randomPoint();
+        int scan = -1;
+        for (int i = 0; i < size && scan < 0; ++i) {
+          scan = edges[i].contains(p.x, p.y, EPS) ? i : -1;
+        }
+        CATCH_REQUIRE(batch.firstHit(p.x, p.y, EPS) == scan);
+      }
+    }
+  }
+
+  CATCH_SECTION("quad batches return the first containing quad, edges included") {
+    for (int size = 0; size <= 20; ++size) {
+      std::vector<math::float4> quads;
+      QuadBatch batch;
+      batch.resize(size);
+      for (int i = 0; i < size; ++i) {
+        const math::float3 p = randomPoint();
+        const math::float3 q = randomPoint();
+        quads.push_back({std::min(p.x, q.x), std::min(p.y, q.y), std::max(p.x, q.x), std::max(p.y, q.y)});
+        batch.set(i, quads[i].x, quads[i].y, quads[i].z, quads[i].w);
+      }
+      for (int k = 0; k < 500; ++k) {
+        math::float3 p = randomPoint();
+        if (size && k % 4 == 0) {
+          // a corner of some quad
+          const math::float4& quad = quads[GameUtil::trand(0, size)];
+          p = {k % 8 ? quad.x : quad.z, k % 3 ? quad.y : quad.w, 0.F};
+        }
+        int scan = -1;
+        for (int i = 0; i < size && scan < 0; ++i) {
+          const math::float4& quad = quads[i];
+          scan = quad.x <= p.x && p.x <= quad.z && quad.y <= p.y && p.y <= quad.w ? i : -1;
+        }
+        CATCH_REQUIRE(batch.firstHit(p.x, p.y) == scan);
+      }
+    }
+  }
+
+  CATCH_SECTION("gathered batches keep the order of the items") {
+    QuadBatch all;
+    all.resize(10);
+    for (int i = 0; i < 10; ++i) {
+      all.set(i, -1.F, -1.F, 1.F, 1.F);
+    }
+    all.set(3, 2.F, 2.F, 3.F, 3.F);
+    QuadBatch some;
+    some.gather(all, {3, 7, 1});
+    CATCH_REQUIRE(some.size() == 3);
+    CATCH_REQUIRE(some.firstHit(0.F, 0.F) == 1);
+    CATCH_REQUIRE(some.firstHit(2.5F, 2.5F) == 0);
+    CATCH_REQUIRE(some.firstHit(5.F, 5.F) == -1);
+  }
+}
@@ -0,0 +1,60 @@
+#define CATCH_CONFIG_PREFIX_ALL
+#include "BoardState.h"
+#include "GameUtil.h"
+#include "MoveGenerator.h"
+#include "TestUtil.h"
+#include <catch2/catch_test_macros.hpp>
+
+using namespace tilepuzzles;
+
+static void randomWalk(BoardState state, int steps) {
+  const BoardState start = state;
+  std::vector<Move> moves(MoveGenerator::maxMoves(state));
+  std::vector<Move> path;
+  for (int i = 0; i < steps; ++i) {
+    int count = MoveGenerator::generate(state, moves.data());
+    CATCH_REQUIRE(count > 0);
+    CATCH_REQUIRE(size_t(count) <= moves.size());
+    Move move = moves[GameUtil::trand(0, count)];
+    MoveGenerator::apply(state, move);
+    path.push_back(move);
+  }
+  for (auto iter = path.rbegin(); iter != path.rend(); ++iter) {
+    MoveGenerator::unapply(state, *iter);
+  }
+  CATCH_REQUIRE(state == start);
+}
+
+CATCH_TEST_CASE("MoveGenerator", "[move_generator]") {
+  tilepuzzles::TestUtil::init_test();
+  GameUtil::init();
+
+  CATCH_SECTION("move encoding") {
+    Move move = MoveGenerator::slide(14, 15);
+    CATCH_REQUIRE(MoveGenerator::kind(move) == MoveKind::SlideMove);
+    CATCH_REQUIRE(MoveGenerator::index(move) == 14);
+    CATCH_REQUIRE(MoveGenerator::inverse(move) == MoveGenerator::slide(15, 14));
+
+    move = MoveGenerator::roll(3, Direction::up);
+    CATCH_REQUIRE(MoveGenerator::direction(move) == Direction::up);
+    CATCH_REQUIRE(MoveGenerator::inverse(move) == MoveGenerator::roll(3, Direction::down));
+
+    move = MoveGenerator::rotate(16, -1);
+    CATCH_REQUIRE(MoveGenerator::steps(move) == -1);
+    CATCH_REQUIRE(MoveGenerator::inverse(move) == MoveGenerator::rotate(16, 1));
+  }
+
+  CATCH_SECTION("move counts") {
+    Move moves[128];
+    CATCH_REQUIRE(MoveGenerator::generate(BoardState::slider(4, 4), moves) == 6);
+    CATCH_REQUIRE(MoveGenerator::generate(BoardState::roller(5, 5), moves) == 20);
+    CATCH_REQUIRE(MoveGenerator::generate(BoardState::roller(2, 4), moves) == 8);
+    CATCH_REQUIRE(MoveGenerator::generate(BoardState::hexSpinner(3, 3), moves) == 34 + 12);
+  }
+
+  CATCH_SECTION("apply unapply") {
+    randomWalk(BoardState::slider(4, 4), 200);
+    randomWalk(BoardState::roller(5, 5), 200);
+    randomWalk(BoardState::hexSpinner(3, 3), 200);
+  }
+}
@@ -0,0 +1,63 @@
+#define CATCH_CONFIG_PREFIX_ALL
+#include "BoardState.h"
+#include "GLogger.h"
+#include "GameUtil.h"
+#include "MoveGenerator.h"
+#include "ParallelIda.h"
+#include "SliderSolver.h"
+#include "Solvability.h"
+#include "TestUtil.h"
+#include <catch2/catch_test_macros.hpp>
+
+using namespace tilepuzzles;
+
+CATCH_TEST_CASE("ParallelIda", "[parallel_ida]") {
+  tilepuzzles::TestUtil::init_test();
+  tilepuzzles::Logger L;
+  GameUtil::init();
+
+  CATCH_SECTION("slider matches sequential IDA*") {
+    SliderSolver sequential(4, 4);
+    ParallelIdaSolver<SliderDomain<>> parallel(SliderDomain<>(4, 4, SliderHeuristic(4, 4)), 4);
+    for (int i = 0; i < 10; ++i) {
+      BoardState state = scramble(BoardState::slider(4, 4), 30);
+      SolveResult expected = sequential.solve(state);
+      SolveResult result = parallel.solve(state);
+      CATCH_REQUIRE(result.solved);
+      CATCH_REQUIRE(result.moves.size() == expected.moves.size());
+      CATCH_REQUIRE(replaysToSolved(state, result.moves));
+    }
+    CATCH_REQUIRE(parallel.threadNodes.size() == 4);
+  }
+
+  CATCH_SECTION("roller") {
+    ParallelIdaSolver<RollerDomain> parallel(RollerDomain(4, 4), 4);
+    ParallelIdaSolver<RollerDomain> single(RollerDomain(4, 4), 1);
+    for (int i = 0; i < 5; ++i) {
+      BoardState state = scramble(BoardState::roller(4, 4), 6);
+      SolveResult result = parallel.solve(state);
+      CATCH_REQUIRE(result.solved);
+      CATCH_REQUIRE(result.moves.size() <= 6);
+      CATCH_REQUIRE(replaysToSolved(state, result.moves));
+      CATCH_REQUIRE(single.solve(state).moves.size() == result.moves.size());
+      L.info("roller moves", result.moves.size(), "nodes", result.nodes, "nodes/sec", result.nodesPerSecond());
+      for (int t = 0; t < parallel.threads; ++t) {
+        L.info("  thread", t, "nodes", parallel.threadNodes[t]);
+      }
+    }
+  }
+
+  CATCH_SECTION("solved and limited") {
+    ParallelIdaSolver<RollerDomain> parallel(RollerDomain(3, 3), 2);
+    SolveResult solved = parallel.solve(BoardState::roller(3, 3));
+    CATCH_REQUIRE(solved.solved);
+    CATCH_REQUIRE(solved.moves.empty());
+
+    ParallelIdaSolver<SliderDomain<>> slider(SliderDomain<>(5, 5, SliderHeuristic(5, 5)), 2);
+    BoardState state = BoardState::slider(5, 5);
+    GameUtil::shuffleSlots(state);
+    Solvability::makeSolvable(state);
+    SolveResult limited = slider.solve(state, 200000);
+    CATCH_REQUIRE_FALSE(limited.solved);
+  }
+}
@@ -0,0 +1,199 @@
+#define CATCH_CONFIG_PREFIX_ALL
+#include "BoardState.h"
+#include "GLogger.h"
+#include "GameUtil.h"
+#include "MoveGenerator.h"
+#include "PatternDb.h"
+#include "SliderSolver.h"
+#include "Solvability.h"
+#include "TestUtil.h"
+#include <catch2/catch_test_macros.hpp>
+
+#include <chrono>
+#include <cstddef>
+#include <cstdio>
+
+using namespace tilepuzzles;
+
+static BoardState randomSlider(int rows, int columns) {
+  BoardState state = BoardState::slider(rows, columns);
+  GameUtil::shuffleSlots(state);
+  Solvability::makeSolvable(state);
+  return state;
+}
+
+CATCH_TEST_CASE("PatternDb", "[pattern_db]") {
+  tilepuzzles::TestUtil::init_test();
+  tilepuzzles::Logger L;
+  GameUtil::init();
+
+  PatternDb db;
+  db.build(3, 3, {{0, 1, 2, 3}, {4, 5, 6, 7}});
+
+  CATCH_SECTION("tables cover every placement") {
+    for (int p = 0; p < db.patterns.size(); ++p) {
+      CATCH_REQUIRE(db.tableSize(p) == 3024);
+      for (uint64_t i = 0; i < db.tableSize(p); ++i) {
+        CATCH_REQUIRE(db.lookup(p, i) != PatternDbBuilder::UNSEEN);
+      }
+    }
+    PatternDbHeuristic<> heuristic(db);
+    CATCH_REQUIRE(heuristic.evaluate(SliderNode(BoardState::slider(3, 3))).h() == 0);
+  }
+
+  CATCH_SECTION("additive heuristic is admissible and dominates manhattan") {
+    PatternDbSolver<> solver(db);
+    SliderSolver reference(3, 3);
+    for (int i = 0; i < 50; ++i) {
+      BoardState state = randomSlider(3, 3);
+      SolveResult result = solver.solve(state);
+      CATCH_REQUIRE(result.solved);
+      CATCH_REQUIRE(replaysToSolved(state, result.moves));
+      CATCH_REQUIRE(result.moves.size() == reference.solve(state).moves.size());
+      const SliderNode node(state);
+      CATCH_REQUIRE(solver.heuristic.evaluate(node).h() >= reference.heuristic.evaluate(node).distance);
+    }
+  }
+
+  CATCH_SECTION("parallel build is byte identical") {
+    std::vector<PatternDbProgress> layers;
+    const std::vector<uint8_t> tiles = {0, 1, 2, 3, 4};
+    const std::vector<uint8_t> serial = PatternDbBuilder::buildTable(3, 3, tiles);
+    const std::vector<uint8_t> parallel = PatternDbBuilder::buildTable(
+        3, 3, tiles, 4, [&](const PatternDbProgress& progress) { layers.push_back(progress); });
+    CATCH_REQUIRE(serial == parallel);
+    CATCH_REQUIRE(layers.size() > 1);
+    for (int d = 0; d < layers.size(); ++d) {
+      CATCH_REQUIRE(layers[d].distance == d);
+    }
+    // with at least two tiles outside the pattern every placement is reachable
+    CATCH_REQUIRE(layers.back().visitedStates == layers.back().stateSpace);
+    L.info("pattern states", layers.back().visitedStates, "states/sec", layers.back().statesPerSecond());
+  }
+
+  CATCH_SECTION("save and map") {
+    const std::string path = "test_pattern_db.bin";
+    CATCH_REQUIRE(db.save(path));
+    PatternDb mapped;
+    CATCH_REQUIRE(mapped.open(path));
+    CATCH_REQUIRE(mapped.rows == 3);
+    CATCH_REQUIRE(mapped.patterns == db.patterns);
+    for (int p = 0; p < db.patterns.size(); ++p) {
+      for (uint64_t i = 0; i < db.tableSize(p); ++i) {
+        CATCH_REQUIRE(mapped.lookup(p, i) == db.lookup(p, i));
+      }
+    }
+    mapped.close();
+
+    FILE* file = std::fopen(path.c_str(), "r+b");
+    std::fputc('X', file);
+    std::fclose(file);
+    CATCH_REQUIRE_FALSE(mapped.open(path));
+    CATCH_REQUIRE_FALSE(mapped.open("missing_pattern_db.bin"));
+    std::remove(path.c_str());
+  }
+
+  CATCH_SECTION("reject foreign headers") {
+    const std::string path = "test_pattern_db_foreign.bin";
+    // overwrites one field of a good file, then expects open() to refuse it
+    auto patch = [&](long offset, uint32_t value) {
+      CATCH_REQUIRE(db.save(path));
+      FILE* file = std::fopen(path.c_str(), "r+b");
+      std::fseek(file, offset, SEEK_SET);
+      std::fwrite(&value, sizeof(value), 1, file);
+      std::fclose(file);
+      PatternDb mapped;
+      return mapped.open(path);
+    };
+    const long entry = sizeof(PatternDbHeader);
+    CATCH_REQUIRE(patch(offsetof(PatternDbHeader, rows), 3));
+    CATCH_REQUIRE_FALSE(patch(offsetof(PatternDbHeader, rows), 30));
+    CATCH_REQUIRE_FALSE(patch(offsetof(PatternDbHeader, columns), 0));
+    CATCH_REQUIRE_FALSE(patch(entry + offsetof(PatternDbEntry, tileCount), 9));
+    CATCH_REQUIRE_FALSE(patch(entry + offsetof(PatternDbEntry, tileCount), 200));
+    CATCH_REQUIRE_FALSE(patch(entry + offsetof(PatternDbEntry, tiles), 0x00000900));
+    CATCH_REQUIRE_FALSE(patch(offsetof(PatternDbHeader, patternCount), PatternDb::MAX_PATTERNS + 1));
+    // the second pattern takes tile 0 from the first
+    CATCH_REQUIRE_FALSE(patch(entry + sizeof(PatternDbEntry) + offsetof(PatternDbEntry, tiles), 0x07060500));
+    CATCH_REQUIRE(patch(entry + sizeof(PatternDbEntry) + offsetof(PatternDbEntry, tiles), 0x07060504));
+    std::remove(path.c_str());
+  }
+
+  CATCH_SECTION("compressed storage") {
+    PatternDb nibble;
+    nibble.build(3, 3, {{0, 1, 2, 3}, {4, 5, 6, 7}});
+    nibble.encode<NibbleStorage>();
+    CATCH_REQUIRE(nibble.tableBytes(0) == 1512);
+    PatternDb mod3;
+    mod3.build(3, 3, {{0, 1, 2, 3}, {4, 5, 6, 7}});
+    mod3.encode<Mod3Storage>();
+    CATCH_REQUIRE(mod3.tableBytes(0) == 756);
+
+    const std::string path = "test_pattern_db_mod3.bin";
+    CATCH_REQUIRE(mod3.save(path));
+    PatternDb mapped;
+    CATCH_REQUIRE(mapped.open(path));
+    CATCH_REQUIRE(mapped.encoding == PatternDb::MOD3_ENCODING);
+
+    PatternDbSolver<> bytes(db);
+    PatternDbSolver<NibbleStorage> nibbles(nibble);
+    PatternDbSolver<Mod3Storage> mod3s(mapped);
+    for (int i = 0; i < 50; ++i) {
+      BoardState state = randomSlider(3, 3);
+      const SliderNode node(state);
+      const int h = bytes.heuristic.evaluate(node).h();
+      CATCH_REQUIRE(nibbles.heuristic.evaluate(node).h() == h);
+      CATCH_REQUIRE(mod3s.heuristic.evaluate(node).h() <= h);
+
+      const size_t optimal = bytes.solve(state).moves.size();
+      SolveResult result = mod3s.solve(state);
+      CATCH_REQUIRE(result.moves.size() == optimal);
+      CATCH_REQUIRE(replaysToSolved(state, result.moves));
+      CATCH_REQUIRE(nibbles.solve(state).moves.size() == optimal);
+    }
+
+    // packed tables are never read with another storage's layout
+    PatternDbSolver<> bytesOfMod3(mapped);
+    PatternDbSolver<NibbleStorage> nibblesOfBytes(db);
+    CATCH_REQUIRE_FALSE(bytesOfMod3.heuristic.matches());
+    CATCH_REQUIRE_FALSE(nibblesOfBytes.heuristic.matches());
+    const BoardState state = randomSlider(3, 3);
+    CATCH_REQUIRE(bytesOfMod3.heuristic.evaluate(SliderNode(state)).h() == 0);
+    CATCH_REQUIRE_FALSE(bytesOfMod3.solve(state).solved);
+    CATCH_REQUIRE_FALSE(nibblesOfBytes.solve(state).solved);
+    mapped.close();
+    std::remove(path.c_str());
+  }
+
+  CATCH_SECTION("probe cost") {
+    PatternDb nibble;
+    nibble.build(3, 3, {{0, 1, 2, 3, 4}, {5, 6, 7}});
+    nibble.encode<NibbleStorage>();
+    PatternDb mod3;
+    mod3.build(3, 3, {{0, 1, 2, 3, 4}, {5, 6, 7}});
+    mod3.encode<Mod3Storage>();
+    PatternDb bytes;
+    bytes.build(3, 3, {{0, 1, 2, 3, 4}, {5, 6, 7}});
+
+    std::vector<std::array<uint8_t, 16>> placements(1 << 16);
+    std::vector<uint64_t> indexes(placements.size());
+    for (int i = 0; i < placements.size(); ++i) {
+      indexes[i] = GameUtil::trand(0, bytes.tableSize(0));
+      PermRank::partialUnrank(indexes[i], 5, 9, placements[i].data());
+    }
+    auto probe = [&](const char* name, auto storage, const PatternDb& table) {
+      auto start = std::chrono::steady_clock::now();
+      int64_t sum = 0;
+      for (int round = 0; round < 20; ++round) {
+        for (int i = 0; i < placements.size(); ++i) {
+          sum += decltype(storage)::value(table, 0, placements[i].data(), indexes[i], 4);
+        }
+      }
+      const double secs = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+      L.info(name, "ns/probe", secs * 1e9 / (20 * placements.size()), "bytes", table.tableBytes(0), "checksum", sum);
+    };
+    probe("byte", ByteStorage(), bytes);
+    probe("nibble", NibbleStorage(), nibble);
+    probe("mod3", Mod3Storage(), mod3);
+  }
+}
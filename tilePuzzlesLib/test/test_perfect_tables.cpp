@@ -0,0 +1,110 @@
+#define CATCH_CONFIG_PREFIX_ALL
+#include "BoardState.h"
+#include "BoardSymmetry.h"
+#include "GLogger.h"
+#include "GameUtil.h"
+#include "HintService.h"
+#include "MoveGenerator.h"
+#include "PerfectTables.h"
+#include "RollerBfsSolver.h"
+#include "TestUtil.h"
+#include <catch2/catch_test_macros.hpp>
+
+#include <chrono>
+#include <filesystem>
+#include <thread>
+
+using namespace tilepuzzles;
+
+CATCH_TEST_CASE("PerfectTables", "[perfect_tables]") {
+  tilepuzzles::TestUtil::init_test();
+  tilepuzzles::Logger L;
+  GameUtil::init();
+
+  const std::string dir = (std::filesystem::temp_directory_path() / "test_perfect_tables").string();
+  std::filesystem::remove_all(dir);
+
+  CATCH_SECTION("only small sliders and rollers are covered") {
+    PerfectTables tables(dir);
+    CATCH_REQUIRE(PerfectTables::covers(BoardState::slider(3, 3)));
+    CATCH_REQUIRE(PerfectTables::covers(BoardState::roller(3, 3)));
+    CATCH_REQUIRE(PerfectTables::covers(BoardState::slider(2, 4)));
+    CATCH_REQUIRE_FALSE(PerfectTables::covers(BoardState::slider(4, 4)));
+    CATCH_REQUIRE_FALSE(PerfectTables::covers(BoardState::roller(4, 4)));
+    CATCH_REQUIRE_FALSE(PerfectTables::covers(BoardState::hexSpinner(2, 2)));
+    CATCH_REQUIRE(tables.find(BoardState::slider(4, 4)) == nullptr);
+    CATCH_REQUIRE(tables.find(BoardState::slider(3, 3), false) == nullptr);
+  }
+
+  CATCH_SECTION("table solutions are optimal and replay to solved") {
+    PerfectTables tables(dir);
+    for (BoardState shape : {BoardState::slider(3, 3), BoardState::roller(3, 3)}) {
+      const auto start = std::chrono::steady_clock::now();
+      CATCH_REQUIRE(tables.generate(shape));
+      L.info("table secs", std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count());
+      const DistanceTable* table = tables.find(shape, false);
+      CATCH_REQUIRE(table);
+      // both 3x3 boards have symmetries, so the table keeps one distance per class
+      CATCH_REQUIRE(table->isSymmetric());
+      // a second instance maps the file instead of generating it
+      PerfectTables mapped(dir);
+      CATCH_REQUIRE(mapped.find(shape, false));
+
+      RollerBfsSolver bfs(3, 3);
+      for (int i = 0; i < 20; ++i) {
+        const BoardState board = scramble(shape, 100);
+        std::vector<Move> moves;
+        CATCH_REQUIRE(PerfectTables::solve(*table, board, moves));
+        CATCH_REQUIRE(moves.size() == table->distance(board));
+        BoardState state = board;
+        for (Move move : moves) {
+          MoveGenerator::apply(state, move);
+        }
+        CATCH_REQUIRE(state.isSolved());
+        if (shape.type == PuzzleType::RollerPuzzle) {
+          CATCH_REQUIRE(bfs.solve(board).moves.size() == moves.size());
+        }
+      }
+    }
+  }
+
+  CATCH_SECTION("boards without symmetries get plain tables") {
+    PerfectTables tables(dir);
+    const BoardState shape = BoardState::slider(2, 3);
+    CATCH_REQUIRE(BoardSymmetry::get(shape).size() == 1);
+    const DistanceTable* table = tables.find(shape);
+    CATCH_REQUIRE(table);
+    CATCH_REQUIRE_FALSE(table->isSymmetric());
+    std::vector<Move> moves;
+    CATCH_REQUIRE(PerfectTables::solve(*table, scramble(shape, 100), moves));
+  }
+
+  CATCH_SECTION("hints for covered boards come from the table at once") {
+    PerfectTables tables(dir);
+    HintService hints;
+    hints.tables = &tables;
+    BoardState state = scramble(BoardState::roller(3, 3), 100);
+    hints.post(state);
+    Move move;
+    const auto end = std::chrono::steady_clock::now() + std::chrono::seconds(30);
+    while (!hints.poll(state, move) && std::chrono::steady_clock::now() < end) {
+      std::this_thread::sleep_for(std::chrono::milliseconds(16));
+    }
+    const DistanceTable* table = tables.find(state, false);
+    CATCH_REQUIRE(table);
+
+    // fresh positions are answered on the first poll, each hint one move closer
+    for (int i = 0; i < 20; ++i) {
+      state = scramble(BoardState::roller(3, 3), 100);
+      hints.post(state);
+      while (!state.isSolved()) {
+        const int distance = table->distance(state);
+        CATCH_REQUIRE(hints.poll(state, move));
+        MoveGenerator::apply(state, move);
+        CATCH_REQUIRE(table->distance(state) == distance - 1);
+      }
+    }
+  }
+
+  std::filesystem::remove_all(dir);
+}
@@ -0,0 +1,94 @@
+#define CATCH_CONFIG_PREFIX_ALL
+#include "BoardState.h"
+#include "GLogger.h"
+#include "GameUtil.h"
+#include "MoveGenerator.h"
+#include "PermRank.h"
+#include "TestUtil.h"
+#include <catch2/catch_test_macros.hpp>
+
+#include <chrono>
+#include <set>
+
+using namespace tilepuzzles;
+
+CATCH_TEST_CASE("PermRank", "[perm_rank]") {
+  tilepuzzles::TestUtil::init_test();
+  tilepuzzles::Logger L;
+  GameUtil::init();
+
+  CATCH_SECTION("lexicographic order") {
+    uint8_t perm[4];
+    for (uint64_t r = 0; r < PermRank::factorial(4); ++r) {
+      PermRank::lexUnrank(r, 4, perm);
+      CATCH_REQUIRE(PermRank::lexRank(perm, 4) == r);
+    }
+    const uint8_t last[] = {3, 2, 1, 0};
+    CATCH_REQUIRE(PermRank::lexRank(last, 4) == 23);
+  }
+
+  CATCH_SECTION("myrvold ruskey bijection") {
+    std::set<uint64_t> ranks;
+    uint8_t perm[6];
+    for (uint64_t r = 0; r < PermRank::factorial(6); ++r) {
+      PermRank::mrUnrank(r, 6, perm);
+      CATCH_REQUIRE(PermRank::mrRank(perm, 6) == r);
+      ranks.insert(PermRank::lexRank(perm, 6));
+    }
+    CATCH_REQUIRE(ranks.size() == 720);
+  }
+
+  CATCH_SECTION("partial permutations") {
+    std::set<uint64_t> ranks;
+    uint8_t positions[3];
+    for (uint64_t r = 0; r < PermRank::partialCount(6, 3); ++r) {
+      PermRank::partialUnrank(r, 3, 6, positions);
+      CATCH_REQUIRE(PermRank::partialRank(positions, 3, 6) == r);
+      ranks.insert(positions[0] * 36 + positions[1] * 6 + positions[2]);
+    }
+    CATCH_REQUIRE(ranks.size() == 120);
+  }
+
+  CATCH_SECTION("board sizes") {
+    BoardState slider = scramble(BoardState::slider(4, 4), 100);
+    CATCH_REQUIRE(PermRank::unrank(slider, PermRank::rank(slider)) == slider);
+
+    BoardState roller = scramble(BoardState::roller(5, 5), 100);
+    Rank128 rollerRank = PermRank::rank<Rank128>(roller);
+    CATCH_REQUIRE(PermRank::unrank(roller, rollerRank) == roller);
+    CATCH_REQUIRE(PermRank::mrRank<Rank128>(roller.slots.data(), 25) != 0);
+
+    BoardState hex = scramble(BoardState::hexSpinner(3, 3), 100);
+    WideRank hexRank = PermRank::rank<WideRank>(hex);
+    CATCH_REQUIRE(PermRank::unrank(hex, hexRank) == hex);
+    BoardState::TileId perm[54];
+    PermRank::mrUnrank(PermRank::mrRank<WideRank>(hex.slots.data(), 54), 54, perm);
+    CATCH_REQUIRE(std::equal(perm, perm + 54, hex.slots.begin()));
+  }
+
+  CATCH_SECTION("batch ranking") {
+    std::vector<BoardState> sliders;
+    std::vector<BoardState> hexes;
+    for (int i = 0; i < 4096; ++i) {
+      sliders.push_back(scramble(BoardState::slider(4, 4), 60));
+    }
+    for (int i = 0; i < 64; ++i) {
+      hexes.push_back(scramble(BoardState::hexSpinner(3, 3), 60));
+    }
+
+    std::vector<uint64_t> ranks(sliders.size());
+    auto start = std::chrono::steady_clock::now();
+    PermRank::rankBatch(sliders.data(), sliders.size(), ranks.data());
+    auto elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    for (int i = 0; i < sliders.size(); ++i) {
+      CATCH_REQUIRE(ranks[i] == PermRank::rank(sliders[i]));
+    }
+    L.info("rankBatch 4x4 states/sec", sliders.size() / elapsed);
+
+    std::vector<WideRank> hexRanks(hexes.size());
+    PermRank::rankBatch(hexes.data(), hexes.size(), hexRanks.data());
+    for (int i = 0; i < hexes.size(); ++i) {
+      CATCH_REQUIRE(hexRanks[i] == PermRank::rank<WideRank>(hexes[i]));
+    }
+  }
+}
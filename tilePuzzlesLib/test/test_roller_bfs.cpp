@@ -0,0 +1,78 @@
+#define CATCH_CONFIG_PREFIX_ALL
+#include "BoardState.h"
+#include "GLogger.h"
+#include "GameUtil.h"
+#include "MoveGenerator.h"
+#include "ParallelIda.h"
+#include "RollerBfsSolver.h"
+#include "TestUtil.h"
+#include <catch2/catch_test_macros.hpp>
+
+using namespace tilepuzzles;
+
+CATCH_TEST_CASE("RollerBfsSolver", "[roller_bfs]") {
+  tilepuzzles::TestUtil::init_test();
+  tilepuzzles::Logger L;
+  GameUtil::init();
+
+  CATCH_SECTION("optimal on small boards") {
+    for (auto dims : {std::pair{3, 3}, std::pair{2, 4}, std::pair{4, 4}}) {
+      RollerBfsSolver bfs(dims.first, dims.second);
+      ParallelIdaSolver<RollerDomain> ida(RollerDomain(dims.first, dims.second), 1);
+      for (int i = 0; i < 5; ++i) {
+        BoardState state = scramble(BoardState::roller(dims.first, dims.second), 7);
+        SolveResult result = bfs.solve(state);
+        CATCH_REQUIRE(result.solved);
+        CATCH_REQUIRE_FALSE(bfs.usedFallback);
+        CATCH_REQUIRE(replaysToSolved(state, result.moves));
+        CATCH_REQUIRE(result.moves.size() == ida.solve(state).moves.size());
+      }
+    }
+  }
+
+  CATCH_SECTION("5x5 scramble") {
+    RollerBfsSolver bfs(5, 5);
+    BoardState state = scramble(BoardState::roller(5, 5), 8);
+    SolveResult result = bfs.solve(state);
+    CATCH_REQUIRE(result.solved);
+    CATCH_REQUIRE(result.moves.size() <= 8);
+    CATCH_REQUIRE(replaysToSolved(state, result.moves));
+    L.info("5x5 moves", result.moves.size(), "expanded", result.nodes, "stored", bfs.storedStates, "secs",
+           result.seconds);
+  }
+
+  CATCH_SECTION("solved board and memory cap fallback") {
+    RollerBfsSolver bfs(4, 4);
+    SolveResult solved = bfs.solve(BoardState::roller(4, 4));
+    CATCH_REQUIRE(solved.solved);
+    CATCH_REQUIRE(solved.moves.empty());
+
+    RollerBfsSolver capped(4, 4, 200);
+    capped.fallbackThreads = 1;
+    BoardState state = scramble(BoardState::roller(4, 4), 12);
+    SolveResult result = capped.solve(state);
+    CATCH_REQUIRE(capped.usedFallback);
+    CATCH_REQUIRE(result.solved);
+    CATCH_REQUIRE(replaysToSolved(state, result.moves));
+
+    // caps hit in the layer that meets the other search still give optimal solutions
+    ParallelIdaSolver<RollerDomain> ida(RollerDomain(3, 3), 1);
+    for (size_t cap = 20; cap <= 2000; cap += 20) {
+      RollerBfsSolver tight(3, 3, cap);
+      tight.fallbackThreads = 1;
+      state = scramble(BoardState::roller(3, 3), 8);
+      result = tight.solve(state);
+      CATCH_REQUIRE(result.solved);
+      CATCH_REQUIRE(result.moves.size() == ida.solve(state).moves.size());
+    }
+
+    // 49 slots overflow the packed keys, so the search goes straight to IDA*
+    RollerBfsSolver large(7, 7);
+    state = scramble(BoardState::roller(7, 7), 4);
+    result = large.solve(state);
+    CATCH_REQUIRE(large.usedFallback);
+    CATCH_REQUIRE(result.solved);
+    CATCH_REQUIRE(result.moves.size() <= 4);
+    CATCH_REQUIRE(replaysToSolved(state, result.moves));
+  }
+}
@@ -0,0 +1,66 @@
+#define CATCH_CONFIG_PREFIX_ALL
+#include "BoardState.h"
+#include "DifficultyEstimator.h"
+#include "GLogger.h"
+#include "GameUtil.h"
+#include "ShuffleService.h"
+#include "Solvability.h"
+#include "TestUtil.h"
+#include <catch2/catch_test_macros.hpp>
+
+#include <chrono>
+#include <thread>
+
+using namespace tilepuzzles;
+
+// polls like a game loop would, one frame at a time, each poll timed
+static bool waitForBoard(ShuffleService& shuffler, BoardState& shuffled, double seconds, double& worst) {
+  const auto end = std::chrono::steady_clock::now() + std::chrono::duration<double>(seconds);
+  while (std::chrono::steady_clock::now() < end) {
+    const auto start = std::chrono::steady_clock::now();
+    const bool ready = shuffler.poll(shuffled);
+    worst = std::max(worst, std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count());
+    if (ready) {
+      return true;
+    }
+    std::this_thread::sleep_for(std::chrono::milliseconds(16));
+  }
+  return false;
+}
+
+CATCH_TEST_CASE("ShuffleService", "[shuffle_service]") {
+  tilepuzzles::TestUtil::init_test();
+  tilepuzzles::Logger L;
+  GameUtil::init();
+
+  CATCH_SECTION("boards reach the difficulty off the polling thread") {
+    for (BoardState shape : {BoardState::slider(4, 4), BoardState::roller(4, 4), BoardState::hexSpinner(3, 3)}) {
+      ShuffleService shuffler;
+      BoardState shuffled;
+      CATCH_REQUIRE_FALSE(shuffler.poll(shuffled));
+      shuffler.post(shape, .5, 400);
+      double worst = 0.;
+      CATCH_REQUIRE(waitForBoard(shuffler, shuffled, 30., worst));
+      CATCH_REQUIRE(worst < 0.016);
+      CATCH_REQUIRE(shuffled.type == shape.type);
+      CATCH_REQUIRE(Solvability::isSolvable(shuffled));
+      CATCH_REQUIRE_FALSE(shuffled.isSolved());
+      DifficultyEstimator estimator(shape.type, shape.rows, shape.columns);
+      L.info("shuffled score", estimator.estimate(shuffled).score, "worst poll secs", worst);
+      // handed over once
+      CATCH_REQUIRE_FALSE(shuffler.poll(shuffled));
+    }
+  }
+
+  CATCH_SECTION("only the last post is delivered") {
+    ShuffleService shuffler;
+    shuffler.post(BoardState::slider(3, 3), 1., 400);
+    shuffler.post(BoardState::slider(4, 4), .3, 400);
+    BoardState shuffled;
+    double worst = 0.;
+    CATCH_REQUIRE(waitForBoard(shuffler, shuffled, 30., worst));
+    CATCH_REQUIRE(shuffled.rows == 4);
+    std::this_thread::sleep_for(std::chrono::milliseconds(100));
+    CATCH_REQUIRE_FALSE(shuffler.poll(shuffled));
+  }
+}
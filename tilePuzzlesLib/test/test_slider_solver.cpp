@@ -0,0 +1,132 @@
+#define CATCH_CONFIG_PREFIX_ALL
+#include "BoardState.h"
+#include "GLogger.h"
+#include "GameUtil.h"
+#include "MoveGenerator.h"
+#include "SliderSolver.h"
+#include "Solvability.h"
+#include "TestUtil.h"
+#include <catch2/catch_test_macros.hpp>
+
+#include <algorithm>
+#include <deque>
+#include <limits>
+#include <unordered_map>
+#include <vector>
+
+using namespace tilepuzzles;
+
+static BoardState randomSlider(int rows, int columns) {
+  BoardState state = BoardState::slider(rows, columns);
+  GameUtil::shuffleSlots(state);
+  Solvability::makeSolvable(state);
+  return state;
+}
+
+// single tile move distances to the solved board, keyed by Zobrist hash
+static std::unordered_map<uint64_t, int> bfsDistances(int rows, int columns) {
+  std::unordered_map<uint64_t, int> distance;
+  std::deque<BoardState> queue;
+  BoardState solved = BoardState::slider(rows, columns);
+  distance[solved.hash] = 0;
+  queue.push_back(solved);
+  while (!queue.empty()) {
+    BoardState state = queue.front();
+    queue.pop_front();
+    const int d = distance[state.hash];
+    const int blank = state.blank;
+    for (int slot : {blank - columns, blank + columns, blank - 1, blank + 1}) {
+      if (slot < 0 || slot >= state.size() ||
+          (slot / columns != blank / columns && slot % columns != blank % columns)) {
+        continue;
+      }
+      BoardState next = state;
+      next.slide(slot);
+      if (distance.emplace(next.hash, d + 1).second) {
+        queue.push_back(next);
+      }
+    }
+  }
+  return distance;
+}
+
+CATCH_TEST_CASE("SliderSolver", "[slider_solver]") {
+  tilepuzzles::TestUtil::init_test();
+  tilepuzzles::Logger L;
+  GameUtil::init();
+
+  CATCH_SECTION("heuristic update matches full evaluation") {
+    SliderHeuristic heuristic(4, 4);
+    SliderNode node(randomSlider(4, 4));
+    SliderHeuristic::Value value = heuristic.evaluate(node);
+    for (int i = 0; i < 1000; ++i) {
+      const int blank = node.blank;
+      int slot = blank;
+      while (slot == blank) {
+        const int r = blank / 4 + GameUtil::trand(0, 3) - 1;
+        const int c = blank % 4 + GameUtil::trand(0, 3) - 1;
+        if (r >= 0 && r < 4 && c >= 0 && c < 4 && (r == blank / 4 || c == blank % 4)) {
+          slot = r * 4 + c;
+        }
+      }
+      const int tile = node.tiles[slot];
+      node.slide(slot);
+      value = heuristic.update(node, value, tile, slot, blank);
+      CATCH_REQUIRE(value.h() == heuristic.evaluate(node).h());
+    }
+  }
+
+  CATCH_SECTION("3x3 solutions are optimal") {
+    const std::unordered_map<uint64_t, int> distance = bfsDistances(3, 3);
+    CATCH_REQUIRE(distance.size() == 181440);
+    SliderSolver solver(3, 3);
+    for (int i = 0; i < 50; ++i) {
+      BoardState state = randomSlider(3, 3);
+      SolveResult result = solver.solve(state);
+      CATCH_REQUIRE(result.solved);
+      CATCH_REQUIRE(replaysToSolved(state, result.moves));
+      CATCH_REQUIRE(result.moves.size() == distance.at(state.hash));
+      CATCH_REQUIRE(solver.heuristic.evaluate(SliderNode(state)).h() <= result.moves.size());
+    }
+  }
+
+  CATCH_SECTION("scrambled 4x4") {
+    SliderSolver solver(4, 4);
+    for (int i = 0; i < 5; ++i) {
+      BoardState state = scramble(BoardState::slider(4, 4), 40);
+      SolveResult result = solver.solve(state);
+      CATCH_REQUIRE(result.solved);
+      CATCH_REQUIRE(replaysToSolved(state, result.moves));
+      L.info("4x4 moves", result.moves.size(), "nodes", result.nodes, "secs", result.seconds, "nodes/sec",
+             result.nodesPerSecond());
+    }
+  }
+
+  CATCH_SECTION("fully shuffled 4x4 within a second at the median") {
+    // the tail is far longer, so boards past the node limit just count as slow
+    SliderSolver solver(4, 4);
+    std::vector<uint64_t> nodes;
+    std::vector<double> seconds;
+    for (int i = 0; i < 21; ++i) {
+      BoardState state = randomSlider(4, 4);
+      SolveResult result = solver.solve(state, 10000000);
+      CATCH_REQUIRE((!result.solved || replaysToSolved(state, result.moves)));
+      nodes.push_back(result.solved ? result.nodes : std::numeric_limits<uint64_t>::max());
+      seconds.push_back(result.solved ? result.seconds : std::numeric_limits<double>::max());
+    }
+    std::nth_element(nodes.begin(), nodes.begin() + nodes.size() / 2, nodes.end());
+    std::nth_element(seconds.begin(), seconds.begin() + seconds.size() / 2, seconds.end());
+    L.info("random 4x4 median nodes", nodes[nodes.size() / 2], "secs", seconds[seconds.size() / 2]);
+    CATCH_REQUIRE(nodes[nodes.size() / 2] <= 10000000);
+#ifdef __OPTIMIZE__
+    CATCH_REQUIRE(seconds[seconds.size() / 2] < 1.);
+#endif
+  }
+
+  CATCH_SECTION("node limit stops the search") {
+    SliderSolver solver(5, 5);
+    SolveResult result = solver.solve(randomSlider(5, 5), 100000);
+    CATCH_REQUIRE_FALSE(result.solved);
+    CATCH_REQUIRE(result.nodes <= 100000 + 0x1000);
+  }
+}
@@ -0,0 +1,127 @@
+#define CATCH_CONFIG_PREFIX_ALL
+#include "BoardState.h"
+#include "GLogger.h"
+#include "GameUtil.h"
+#include "MoveGenerator.h"
+#include "SolutionOptimizer.h"
+#include "TestUtil.h"
+#include <catch2/catch_test_macros.hpp>
+
+#include <chrono>
+
+using namespace tilepuzzles;
+
+static std::vector<Move> randomMoves(BoardState state, int steps) {
+  std::vector<Move> result;
+  Move moves[256];
+  for (int i = 0; i < steps; ++i) {
+    int count = MoveGenerator::generate(state, moves);
+    result.push_back(moves[GameUtil::trand(0, count)]);
+    MoveGenerator::apply(state, result.back());
+  }
+  return result;
+}
+
+static BoardState replay(BoardState state, const std::vector<Move>& moves) {
+  for (Move move : moves) {
+    MoveGenerator::apply(state, move);
+  }
+  return state;
+}
+
+// the scramble undone, padded with moves a player takes back
+static std::vector<Move> noisySolution(const BoardState& start, const std::vector<Move>& scramble) {
+  std::vector<Move> solution;
+  BoardState state = start;
+  for (auto move = scramble.rbegin(); move != scramble.rend(); ++move) {
+    if (GameUtil::trand(0, 3) == 0) {
+      const std::vector<Move> detour = randomMoves(state, GameUtil::trand(1, 3));
+      solution.insert(solution.end(), detour.begin(), detour.end());
+      for (auto back = detour.rbegin(); back != detour.rend(); ++back) {
+        solution.push_back(MoveGenerator::inverse(*back));
+      }
+    }
+    solution.push_back(MoveGenerator::inverse(*move));
+    MoveGenerator::apply(state, solution.back());
+  }
+  return solution;
+}
+
+CATCH_TEST_CASE("SolutionOptimizer", "[solution_optimizer]") {
+  tilepuzzles::TestUtil::init_test();
+  tilepuzzles::Logger L;
+  GameUtil::init();
+
+  CATCH_SECTION("rolls cancel across commuting moves and wrap around") {
+    SolutionOptimizer optimizer(PuzzleType::RollerPuzzle, 4, 6);
+    const BoardState start = BoardState::roller(4, 6);
+    std::vector<Move> moves = {MoveGenerator::roll(0, Direction::right), MoveGenerator::roll(2, Direction::right),
+                               MoveGenerator::roll(0, Direction::left), MoveGenerator::roll(2, Direction::left)};
+    CATCH_REQUIRE(optimizer.optimize(start, moves) == 4);
+    CATCH_REQUIRE(moves.empty());
+
+    moves.assign(4, MoveGenerator::roll(1, Direction::right));
+    moves.push_back(MoveGenerator::roll(3, Direction::down));
+    const BoardState end = replay(start, moves);
+    optimizer.optimize(start, moves);
+    CATCH_REQUIRE(moves.size() == 3);
+    CATCH_REQUIRE(replay(start, moves) == end);
+  }
+
+  CATCH_SECTION("six turns of an anchor vanish") {
+    SolutionOptimizer optimizer(PuzzleType::HexSpinPuzzle, 3, 3);
+    // turns of a solved anchor keep its colors, start from a mixed board
+    const BoardState start = replay(BoardState::hexSpinner(3, 3), randomMoves(BoardState::hexSpinner(3, 3), 50));
+    std::vector<Move> moves(6, MoveGenerator::rotate(2, 1));
+    CATCH_REQUIRE(optimizer.optimize(start, moves) == 6);
+    moves.assign(5, MoveGenerator::rotate(0, -1));
+    optimizer.optimize(start, moves);
+    CATCH_REQUIRE(moves == std::vector<Move>{MoveGenerator::rotate(0, 1)});
+  }
+
+  CATCH_SECTION("slides along a line merge") {
+    SolutionOptimizer optimizer(PuzzleType::SliderPuzzle, 4, 4);
+    const BoardState start = BoardState::slider(4, 4);
+    // blank at 15: slide 14, then 12 into the new blank, then back to 15
+    std::vector<Move> moves = {MoveGenerator::slide(14, 15), MoveGenerator::slide(12, 14),
+                               MoveGenerator::slide(15, 12)};
+    CATCH_REQUIRE(optimizer.optimize(start, moves) == 3);
+    CATCH_REQUIRE(moves.empty());
+  }
+
+  CATCH_SECTION("noisy solutions shrink to at most the scramble length") {
+    for (BoardState start : {BoardState::slider(4, 4), BoardState::roller(5, 5), BoardState::hexSpinner(3, 3)}) {
+      SolutionOptimizer optimizer(start.type, start.rows, start.columns);
+      for (int i = 0; i < 50; ++i) {
+        const std::vector<Move> scramble = randomMoves(start, 40);
+        const BoardState scrambled = replay(start, scramble);
+        std::vector<Move> solution = noisySolution(scrambled, scramble);
+        const BoardState end = replay(scrambled, solution);
+        optimizer.optimize(scrambled, solution);
+        CATCH_REQUIRE(replay(scrambled, solution).hash == end.hash);
+        CATCH_REQUIRE(solution.size() <= scramble.size());
+      }
+    }
+  }
+
+  CATCH_SECTION("thousands of solutions per second") {
+    for (BoardState start : {BoardState::slider(4, 4), BoardState::roller(4, 4), BoardState::hexSpinner(3, 3)}) {
+      SolutionOptimizer optimizer(start.type, start.rows, start.columns);
+      std::vector<std::pair<BoardState, std::vector<Move>>> solutions;
+      for (int i = 0; i < 1000; ++i) {
+        const std::vector<Move> scramble = randomMoves(start, 30);
+        const BoardState scrambled = replay(start, scramble);
+        solutions.push_back({scrambled, noisySolution(scrambled, scramble)});
+      }
+      size_t removed = 0;
+      const auto begin = std::chrono::steady_clock::now();
+      for (auto& [scrambled, solution] : solutions) {
+        removed += optimizer.optimize(scrambled, solution);
+      }
+      const double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - begin).count();
+      L.info("type", int(start.type), "radius", optimizer.windowRadius(), "removed", removed, "per sec",
+             solutions.size() / seconds);
+      CATCH_REQUIRE(solutions.size() / seconds > 1000.);
+    }
+  }
+}
@@ -0,0 +1,77 @@
+#define CATCH_CONFIG_PREFIX_ALL
+#include "BoardState.h"
+#include "GLogger.h"
+#include "GameUtil.h"
+#include "MoveGenerator.h"
+#include "Solvability.h"
+#include "TestUtil.h"
+#include <catch2/catch_test_macros.hpp>
+
+#include <chrono>
+
+using namespace tilepuzzles;
+
+static BoardState swapFirstTiles(BoardState state) {
+  int first = state.blank == 0 ? 1 : 0;
+  int second = state.blank == first + 1 ? first + 2 : first + 1;
+  state.swapSlots(first, second);
+  return state;
+}
+
+CATCH_TEST_CASE("Solvability", "[solvability]") {
+  tilepuzzles::TestUtil::init_test();
+  tilepuzzles::Logger L;
+  GameUtil::init();
+
+  CATCH_SECTION("reachable boards are solvable") {
+    for (int i = 0; i < 50; ++i) {
+      CATCH_REQUIRE(Solvability::isSolvable(scramble(BoardState::slider(4, 4), 80)));
+      CATCH_REQUIRE(Solvability::isSolvable(scramble(BoardState::slider(3, 4), 80)));
+      CATCH_REQUIRE(Solvability::isSolvable(scramble(BoardState::roller(5, 5), 80)));
+      CATCH_REQUIRE(Solvability::isSolvable(scramble(BoardState::hexSpinner(3, 3), 80)));
+    }
+  }
+
+  CATCH_SECTION("tile swap parity") {
+    CATCH_REQUIRE_FALSE(Solvability::isSolvable(swapFirstTiles(scramble(BoardState::slider(4, 4), 51))));
+    CATCH_REQUIRE_FALSE(Solvability::isSolvable(swapFirstTiles(scramble(BoardState::slider(2, 3), 51))));
+    CATCH_REQUIRE_FALSE(Solvability::isSolvable(swapFirstTiles(BoardState::roller(3, 3))));
+    CATCH_REQUIRE(Solvability::isSolvable(swapFirstTiles(BoardState::roller(2, 4))));
+    CATCH_REQUIRE(Solvability::isSolvable(swapFirstTiles(BoardState::hexSpinner(3, 3))));
+  }
+
+  CATCH_SECTION("single line boards") {
+    BoardState roller = BoardState::roller(1, 5);
+    roller.rollRow(0, 1);
+    CATCH_REQUIRE(Solvability::isSolvable(roller));
+    CATCH_REQUIRE_FALSE(Solvability::isSolvable(swapFirstTiles(roller)));
+  }
+
+  CATCH_SECTION("make solvable") {
+    for (int i = 0; i < 50; ++i) {
+      BoardState state = BoardState::slider(4, 4);
+      GameUtil::shuffleSlots(state);
+      CATCH_REQUIRE(Solvability::makeSolvable(state));
+      CATCH_REQUIRE(Solvability::isSolvable(state));
+    }
+  }
+
+  CATCH_SECTION("throughput") {
+    std::vector<BoardState> boards;
+    for (int i = 0; i < 1000; ++i) {
+      BoardState state = BoardState::slider(4, 4);
+      GameUtil::shuffleSlots(state);
+      boards.push_back(state);
+    }
+    int solvable = 0;
+    auto start = std::chrono::steady_clock::now();
+    for (int pass = 0; pass < 100; ++pass) {
+      for (const auto& board : boards) {
+        solvable += Solvability::isSolvable(board);
+      }
+    }
+    auto elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    L.info("isSolvable 4x4 boards/sec", 100. * boards.size() / elapsed, "solvable", solvable);
+    CATCH_REQUIRE(solvable > 0);
+  }
+}
@@ -0,0 +1,175 @@
+#define CATCH_CONFIG_PREFIX_ALL
+#include "BoardState.h"
+#include "GLogger.h"
+#include "GameUtil.h"
+#include "MoveGenerator.h"
+#include "ParallelIda.h"
+#include "Solvability.h"
+#include "TestUtil.h"
+#include "TranspositionTable.h"
+#include "Zobrist.h"
+#include <catch2/catch_test_macros.hpp>
+
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include <vector>
+
+using namespace tilepuzzles;
+
+// entry contents derived from the key, so readers can tell a torn slot from a good one
+static TTEntry entryFor(uint64_t key) {
+  TTEntry entry;
+  entry.bound = key & 0xffff;
+  entry.depth = (key >> 16) & 0xff;
+  return entry;
+}
+
+CATCH_TEST_CASE("TranspositionTable", "[transposition_table]") {
+  tilepuzzles::TestUtil::init_test();
+  tilepuzzles::Logger L;
+  GameUtil::init();
+
+  CATCH_SECTION("store and probe") {
+    TranspositionTable table(1);
+    CATCH_REQUIRE(table.capacity() == (1 << 20) / 64 * TranspositionTable::BUCKET_SLOTS);
+    TTEntry entry;
+    CATCH_REQUIRE_FALSE(table.probe(42, entry));
+    table.store(42, entryFor(Zobrist::mix(1, 2)));
+    CATCH_REQUIRE(table.probe(42, entry));
+    CATCH_REQUIRE(entry.bound == entryFor(Zobrist::mix(1, 2)).bound);
+    CATCH_REQUIRE(entry.depth == entryFor(Zobrist::mix(1, 2)).depth);
+    CATCH_REQUIRE_FALSE(table.probe(43, entry));
+    table.clear();
+    CATCH_REQUIRE_FALSE(table.probe(42, entry));
+  }
+
+  CATCH_SECTION("replacement keeps deep current entries") {
+    TranspositionTable table(1);
+    const uint64_t stride = table.capacity() / TranspositionTable::BUCKET_SLOTS;
+    TTEntry entry;
+    for (int i = 0; i < TranspositionTable::BUCKET_SLOTS; ++i) {
+      entry.depth = 10 + i;
+      table.store(7 + i * stride, entry);
+    }
+    entry.depth = 1;
+    table.store(7 + 10 * stride, entry);
+    CATCH_REQUIRE_FALSE(table.probe(7, entry));
+    CATCH_REQUIRE(table.probe(7 + stride, entry));
+
+    table.newSearch();
+    entry.depth = 1;
+    table.store(7 + 11 * stride, entry);
+    CATCH_REQUIRE(table.probe(7 + 11 * stride, entry));
+    CATCH_REQUIRE_FALSE(table.probe(7 + 10 * stride, entry));
+    CATCH_REQUIRE(table.probe(7 + 3 * stride, entry));
+
+    // the current shallow entry outlives deeper entries from the last search
+    entry.depth = 2;
+    table.store(7 + 12 * stride, entry);
+    CATCH_REQUIRE(table.probe(7 + 11 * stride, entry));
+    CATCH_REQUIRE_FALSE(table.probe(7 + stride, entry));
+  }
+
+  CATCH_SECTION("concurrent writers never produce torn hits") {
+    TranspositionTable table(1);
+    std::atomic<uint64_t> bad = 0;
+    std::vector<std::thread> threads;
+    for (int t = 0; t < 4; ++t) {
+      threads.emplace_back([&, t]() {
+        TTEntry entry;
+        for (int i = 0; i < 200000; ++i) {
+          // few keys over few buckets to force collisions
+          const uint64_t key = Zobrist::mix(i % 512, t);
+          table.store(key, entryFor(key));
+          const uint64_t other = Zobrist::mix((i * 7) % 512, (t + 1) % 4);
+          if (table.probe(other, entry)) {
+            const TTEntry expected = entryFor(other);
+            if (entry.bound != expected.bound || entry.depth != expected.depth) {
+              ++bad;
+            }
+          }
+        }
+      });
+    }
+    for (auto& t : threads) {
+      t.join();
+    }
+    CATCH_REQUIRE(bad == 0);
+  }
+
+  CATCH_SECTION("contention benchmark") {
+    TranspositionTable table(16);
+    for (int threadCount : {1, 2, 4, 8}) {
+      std::vector<std::thread> threads;
+      auto start = std::chrono::steady_clock::now();
+      const int ops = 1 << 20;
+      for (int t = 0; t < threadCount; ++t) {
+        threads.emplace_back([&, t]() {
+          TTEntry entry;
+          for (int i = 0; i < ops; ++i) {
+            const uint64_t key = Zobrist::mix(i & 0xffff, t & 1);
+            if (!table.probe(key, entry)) {
+              table.store(key, entryFor(key));
+            }
+          }
+        });
+      }
+      for (auto& t : threads) {
+        t.join();
+      }
+      const double secs = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+      L.info("threads", threadCount, "probe/store ops/sec", threadCount * ops / secs);
+    }
+  }
+
+  CATCH_SECTION("parallel IDA* with a shared table") {
+    TranspositionTable& table = TranspositionTable::shared();
+    ParallelIdaSolver<RollerDomain> plain(RollerDomain(4, 4), 4);
+    ParallelIdaSolver<RollerDomain> cached(RollerDomain(4, 4), 4);
+    cached.table = &table;
+    for (int i = 0; i < 5; ++i) {
+      BoardState state = scramble(BoardState::roller(4, 4), 10);
+      SolveResult expected = plain.solve(state);
+      SolveResult result = cached.solve(state);
+      CATCH_REQUIRE(result.solved);
+      CATCH_REQUIRE(result.moves.size() == expected.moves.size());
+      CATCH_REQUIRE(replaysToSolved(state, result.moves));
+      L.info("roller moves", result.moves.size(), "nodes", expected.nodes, "with table", result.nodes);
+    }
+
+    ParallelIdaSolver<SliderDomain<>> slider(SliderDomain<>(4, 4, SliderHeuristic(4, 4)), 4);
+    slider.table = &table;
+    SliderSolver sequential(4, 4);
+    for (int i = 0; i < 5; ++i) {
+      BoardState state = scramble(BoardState::slider(4, 4), 30);
+      SolveResult result = slider.solve(state);
+      CATCH_REQUIRE(result.moves.size() == sequential.solve(state).moves.size());
+      CATCH_REQUIRE(replaysToSolved(state, result.moves));
+    }
+  }
+
+  CATCH_SECTION("board shapes sharing one table stay optimal") {
+    TranspositionTable& table = TranspositionTable::shared();
+    std::vector<std::pair<int, int>> shapes = {{2, 4}, {4, 2}, {3, 4}, {4, 3}};
+    for (int i = 0; i < 60; ++i) {
+      const auto [rows, columns] = shapes[i % shapes.size()];
+      ParallelIdaSolver<SliderDomain<>> slider(SliderDomain<>(rows, columns, SliderHeuristic(rows, columns)), 4);
+      slider.table = &table;
+      BoardState state = BoardState::slider(rows, columns);
+      GameUtil::shuffleSlots(state);
+      Solvability::makeSolvable(state);
+      SolveResult result = slider.solve(state);
+      CATCH_REQUIRE(result.moves.size() == SliderSolver(rows, columns).solve(state).moves.size());
+      CATCH_REQUIRE(replaysToSolved(state, result.moves));
+
+      ParallelIdaSolver<RollerDomain> plain(RollerDomain(3, 3), 4);
+      ParallelIdaSolver<RollerDomain> roller(RollerDomain(3, 3), 4);
+      roller.table = &table;
+      state = scramble(BoardState::roller(3, 3), 8);
+      result = roller.solve(state);
+      CATCH_REQUIRE(result.moves.size() == plain.solve(state).moves.size());
+      CATCH_REQUIRE(replaysToSolved(state, result.moves));
+    }
+  }
+}